@@ -11,7 +11,12 @@ document.addEventListener('DOMContentLoaded', () => {
         maxReconnectAttempts: 5,
         authenticated: false,
         logPaused: false,
-        autoScroll: true
+        autoScroll: true,
+        clientId: null,
+        pendingFaultJobs: {},
+        earlyFaultResults: {},
+        onFaultResult: null,
+        onFaultEvent: null
     };
 
     // --- WebSocket Yönetimi ---
@@ -53,6 +58,7 @@ document.addEventListener('DOMContentLoaded', () => {
             switch (data.type) {
                 case 'auth_success':
                     state.authenticated = true;
+                    state.clientId = data.clientId;
                     console.log('WebSocket kimlik doğrulama başarılı');
                     // Gerekli verileri iste
                     if (document.getElementById('logContainer')) {
@@ -68,6 +74,16 @@ document.addEventListener('DOMContentLoaded', () => {
                 case 'log':
                     if (!state.logPaused) addLogEntry(data);
                     break;
+                case 'fault':
+                    if (data.event) {
+                        if (state.onFaultEvent) state.onFaultEvent(data);
+                        break;
+                    }
+                    if (state.onFaultResult) state.onFaultResult(data);
+                    break;
+                case 'fault_range':
+                    if (state.onFaultResult) state.onFaultResult(data);
+                    break;
                 case 'error':
                      showMessage(data.message, 'error');
                      break;
@@ -254,6 +270,7 @@ document.addEventListener('DOMContentLoaded', () => {
 
         fetch('/api/baudrate').then(r => r.json()).then(br => {
              updateElement('currentBaudRate', br.baudRate + ' bps');
+             if (br.linkRate) updateElement('linkRate', br.linkRate + ' bps');
              const radio = document.querySelector(`input[name="baud"][value="${br.baudRate}"]`);
              if (radio) radio.checked = true;
         });
@@ -281,27 +298,189 @@ document.addEventListener('DOMContentLoaded', () => {
 
         if (!firstFaultBtn) return;
         
-        const fetchFault = (endpoint) => {
-            fetch(endpoint, { method: 'POST' })
-            .then(r => r.text())
-            .then(text => {
-                const emptyState = faultContent.querySelector('.empty-state');
-                if(emptyState) emptyState.remove();
-                
-                const recordDiv = document.createElement('div');
-                recordDiv.className = 'fault-record';
-                recordDiv.textContent = text;
-                faultContent.prepend(recordDiv);
-                updateElement('faultCommStatus', 'Başarılı');
-                document.getElementById('faultCommStatus').className = 'value status-badge active';
+        const setCommStatus = (ok) => {
+            updateElement('faultCommStatus', ok ? 'Başarılı' : 'Başarısız');
+            document.getElementById('faultCommStatus').className = 'value status-badge ' + (ok ? 'active' : 'error');
+        };
+
+        const addRecord = (text) => {
+            const emptyState = faultContent.querySelector('.empty-state');
+            if(emptyState) emptyState.remove();
+            
+            const recordDiv = document.createElement('div');
+            recordDiv.className = 'fault-record';
+            recordDiv.textContent = text;
+            faultContent.prepend(recordDiv);
+        };
+
+        // Sonuç WebSocket'ten ya da yedek sorgudan gelir - hangisi önce gelirse
+        const resolveFaultJob = (result) => {
+            const job = state.pendingFaultJobs[result.jobId];
+            if (!job) {
+                // 202 yanıtı henüz işlenmemiş olabilir - kısa süre sakla
+                state.earlyFaultResults[result.jobId] = result;
+                setTimeout(() => delete state.earlyFaultResults[result.jobId], 5000);
+                return;
+            }
+            clearTimeout(job.timer);
+            delete state.pendingFaultJobs[result.jobId];
+            job.onDone(result);
+        };
+        state.onFaultResult = resolveFaultJob;
+
+        // dsPIC yeni arızayı kendiliğinden bildirdi - sorgu beklemeden ekrana
+        // İkili kayıt olaylarında 'data' yok - çözülmüş kayıttan dsPIC satır biçimi kurulur
+        const formatRecord = (record) =>
+            [record.seq, record.iso, record.channel, record.type].concat(record.values).join(',');
+
+        state.onFaultEvent = (event) => {
+            addRecord(event.data !== undefined ? event.data : formatRecord(event.record));
+            updateElement('lastEventLatency', event.latency + ' ms');
+            setCommStatus(true);
+            showMessage('Yeni arıza kaydı: #' + event.eventId, 'warning');
+        };
+
+        // WebSocket yoksa veya mesaj kaçtıysa iş durumunu sorgula
+        const pollFaultJob = (jobId, attempt) => {
+            const job = state.pendingFaultJobs[jobId];
+            if (!job) return;
+            if (attempt > job.maxPolls) {
+                delete state.pendingFaultJobs[jobId];
+                setCommStatus(false);
+                return;
+            }
+            fetch('/api/faults/job?id=' + jobId)
+            .then(r => r.json())
+            .then(result => {
+                if (result.status === 'pending') {
+                    job.timer = setTimeout(() => pollFaultJob(jobId, attempt + 1), 1000);
+                } else {
+                    resolveFaultJob(result);
+                }
             }).catch(() => {
-                 updateElement('faultCommStatus', 'Başarısız');
-                 document.getElementById('faultCommStatus').className = 'value status-badge error';
+                job.timer = setTimeout(() => pollFaultJob(jobId, attempt + 1), 1000);
+            });
+        };
+
+        const startFaultJob = (endpoint, params, maxPolls, onDone) => {
+            const body = new URLSearchParams(params);
+            if (state.authenticated && state.clientId !== null) body.append('clientId', state.clientId);
+
+            fetch(endpoint, { method: 'POST', body: body })
+            .then(r => {
+                if (r.status !== 202) throw new Error('HTTP ' + r.status);
+                return r.json();
+            })
+            .then(job => {
+                const pollDelay = state.authenticated ? 2000 : 500;
+                state.pendingFaultJobs[job.jobId] = {
+                    maxPolls: maxPolls,
+                    onDone: onDone,
+                    timer: setTimeout(() => pollFaultJob(job.jobId, 0), pollDelay)
+                };
+                const early = state.earlyFaultResults[job.jobId];
+                if (early) {
+                    delete state.earlyFaultResults[job.jobId];
+                    resolveFaultJob(early);
+                }
+            }).catch((error) => {
+                 setCommStatus(false);
+                 if (error.message === 'HTTP 501') {
+                     showMessage('dsPIC firmware toplu aktarımı desteklemiyor.', 'error');
+                 }
             });
         };
 
+        const fetchFault = (endpoint) => {
+            startFaultJob(endpoint, {}, 10, (result) => {
+                if (result.status !== 'ok' || !result.data) {
+                    setCommStatus(false);
+                    return;
+                }
+                addRecord(result.data);
+                setCommStatus(true);
+            });
+        };
+
+        // Toplu aktarım - blok blok, dsPIC'in bildirdiği toplam kayda ulaşana kadar
+        const fetchFaultRange = (start, loaded) => {
+            startFaultJob('/api/faults/range', { start: start, count: 16 }, 60, (result) => {
+                if (!result.records) {
+                    setCommStatus(false);
+                    return;
+                }
+                result.records.forEach(record => addRecord(record.data));
+                loaded += result.records.length;
+                updateElement('totalFaults', loaded);
+                setCommStatus(result.status === 'ok');
+
+                const more = result.status === 'ok' && result.count > 0 &&
+                             (result.total === undefined || result.next < result.total);
+                if (more) {
+                    fetchFaultRange(result.next, loaded);
+                } else {
+                    showMessage(loaded + ' arıza kaydı aktarıldı.', 'success');
+                }
+            });
+        };
+
+        // Cihazdaki yerel depo - dsPIC'e gitmez, en yeni sayfa
+        const loadStoredFaults = () => {
+            fetch('/api/faults?count=50')
+            .then(r => {
+                if (!r.ok) throw new Error('HTTP ' + r.status);
+                return r.json();
+            })
+            .then(page => {
+                faultContent.innerHTML = '';
+                page.records.forEach(entry => {
+                    const r = entry.record;
+                    addRecord('#' + entry.id + ' | ' + r.iso.replace('T', ' ') + ' | Kanal ' + r.channel +
+                              ' | Tip ' + r.type + (r.values.length ? ' | ' + r.values.join(', ') : ''));
+                });
+                updateElement('totalFaults', page.next - page.first);
+            }).catch(() => showMessage('Arıza deposu okunamadı.', 'error'));
+        };
+
         firstFaultBtn.addEventListener('click', () => fetchFault('/api/faults/first'));
         nextFaultBtn.addEventListener('click', () => fetchFault('/api/faults/next'));
+
+        const rangeFaultBtn = document.getElementById('rangeFaultBtn');
+        if (rangeFaultBtn) {
+            rangeFaultBtn.addEventListener('click', () => fetchFaultRange(0, 0));
+        }
+
+        const refreshFaultBtn = document.getElementById('refreshFaultBtn');
+        if (refreshFaultBtn) {
+            refreshFaultBtn.addEventListener('click', loadStoredFaults);
+        }
+
+        // Yerel deponun tamamı CSV olarak - tarayıcı doğrudan indirir
+        const exportFaultBtn = document.getElementById('exportFaultBtn');
+        if (exportFaultBtn) {
+            exportFaultBtn.addEventListener('click', () => {
+                window.location.href = '/api/faults/export?format=csv';
+            });
+        }
+
+        // COMTRADE .cfg + .dat - ikisi aynı depo anına ('before') sabitlenir
+        const comtradeFaultBtn = document.getElementById('comtradeFaultBtn');
+        if (comtradeFaultBtn) {
+            comtradeFaultBtn.addEventListener('click', () => {
+                fetch('/api/faults/store')
+                .then(r => r.json())
+                .then(store => {
+                    ['cfg', 'dat'].forEach(part => {
+                        const link = document.createElement('a');
+                        link.href = '/api/faults/comtrade?format=binary&part=' + part + '&before=' + store.next;
+                        link.download = 'faults.' + part;
+                        document.body.appendChild(link);
+                        link.click();
+                        link.remove();
+                    });
+                }).catch(() => showMessage('COMTRADE dışa aktarımı başlatılamadı.', 'error'));
+            });
+        }
     }
 
     // Log Sayfası (log.html)
@@ -321,6 +500,14 @@ document.addEventListener('DOMContentLoaded', () => {
              document.getElementById('logContainer').innerHTML = '';
         });
 
+        // Kalıcı log (tüm açılışlar) NDJSON olarak iner
+        const exportLogsBtn = document.getElementById('exportLogsBtn');
+        if (exportLogsBtn) {
+            exportLogsBtn.addEventListener('click', () => {
+                window.location.href = '/api/logs/persistent';
+            });
+        }
+
         autoScrollBtn.addEventListener('click', () => {
             state.autoScroll = !state.autoScroll;
             autoScrollBtn.dataset.active = state.autoScroll;
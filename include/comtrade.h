@@ -0,0 +1,42 @@
+#ifndef COMTRADE_H
+#define COMTRADE_H
+
+// IEEE C37.111-1999 COMTRADE üretici - arıza kayıtları örnek noktası olarak yazılır.
+// Her kayıt bir örnek: zaman damgası ilk kayda göre, analog kanallar A1..A8 = values[].
+// Kayıtlar düzensiz aralıklı olduğundan nrates=0 ve örnek zamanları .dat'tan okunur.
+// Arduino bağımlılığı yok - fault_record gibi host derlemesinde de çalışır.
+//
+// Sabit bellek, iki geçiş: comtradeAddSample ile ölçek/sayı/zaman aralığı toplanır
+// (.cfg ve ikili 16-bit ölçek bunlara bağlı), sonra kayıtlar tek tek comtradeSample'a verilir.
+#include <stdint.h>
+#include <stddef.h>
+#include "fault_record.h"
+
+#define COMTRADE_ANALOG_CHANNELS    FAULT_RECORD_MAX_VALUES
+#define COMTRADE_LINE_FREQUENCY     50
+#define COMTRADE_CFG_MAX            1024
+#define COMTRADE_SAMPLE_MAX         96      // ASCII: n,t + 8 x 6 hane
+
+struct ComtradeLayout {
+    uint32_t samples;
+    uint32_t firstTime;                     // En eski örnek (id sırası zaman sırası olmayabilir)
+    uint16_t firstMillis;
+    uint32_t lastTime;                      // En yeni örnek
+    uint16_t lastMillis;
+    uint32_t timeMultiplier;                // .dat zaman birimi (µs); 32 bite sığacak şekilde seçilir
+    uint32_t maxMagnitude[COMTRADE_ANALOG_CHANNELS];   // x100 değer
+};
+
+void comtradeBegin(ComtradeLayout& layout);
+void comtradeAddSample(ComtradeLayout& layout, const FaultRecord& record);
+void comtradeFinish(ComtradeLayout& layout);    // Ön geçişten sonra bir kez
+
+// .cfg metni; station/device içindeki virgüller atılır. Yazılan byte, sığmazsa 0.
+size_t comtradeConfig(const ComtradeLayout& layout, const char* station, const char* device,
+                      bool binary, char* out, size_t capacity);
+
+// .dat satırı/kaydı - index 1'den başlar. Yazılan byte, sığmazsa 0.
+size_t comtradeSample(const ComtradeLayout& layout, uint32_t index, const FaultRecord& record,
+                      bool binary, uint8_t* out, size_t capacity);
+
+#endif // COMTRADE_H
@@ -0,0 +1,34 @@
+#ifndef FAULT_EVENTS_H
+#define FAULT_EVENTS_H
+
+#include <Arduino.h>
+#include "uart_frame.h"
+
+// dsPIC'in kendiliğinden gönderdiği arıza olayları (CMD_FAULT_EVENT).
+// Owner task frame'i kuyruğa koyar, web task WebSocket'e yayınlar.
+#define FAULT_EVENT_QUEUE_SIZE          8       // 2'nin kuvveti olmalı
+#define FAULT_EVENT_MAX_TEXT            200     // broadcastFault zaten 200 karakterde keser
+#define FAULT_EVENT_LATENCY_BUDGET_MS   250     // Arızadan ekrana hedef süre
+
+// Arızadan WebSocket gönderimine kadar geçen süre (dsPIC'teki bekleme dahil)
+struct FaultEventStats {
+    unsigned long received;
+    unsigned long delivered;
+    unsigned long dropped;              // Kuyruk dolu / bozuk frame
+    unsigned long overBudget;           // Bütçeyi aşan teslim
+    unsigned long lastLatencyMs;
+    unsigned long maxLatencyMs;
+    unsigned long totalLatencyMs;       // Ortalama için
+};
+
+extern FaultEventStats faultEventStats;
+
+// Owner task bağlamında - frame çözüldüğü anda çağrılır
+void handleFaultEventFrame(const UARTFrame& frame);
+
+// Web task'ından çağrılır - bekleyen olayları yayınlar
+void processFaultEvents();
+
+String getFaultEventStatsJSON();
+
+#endif // FAULT_EVENTS_H
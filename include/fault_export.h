@@ -0,0 +1,24 @@
+#ifndef FAULT_EXPORT_H
+#define FAULT_EXPORT_H
+
+#include <Arduino.h>
+#include "fault_store.h"
+
+// Arıza deposunun dışa aktarımı - kayıtlar küçük parçalar halinde depodan okunup sabit
+// tampondan chunked gönderilir; String birleştirme yok, yığın kayıt sayısıyla büyümez.
+//
+// GET /api/faults/export?format=csv|ndjson[&start=&end=&type=&channel=]
+// ETag aktarılan id aralığını taşır. "Range: bytes=N-" + "If-Range: <etag>" ile kesilen
+// indirme aynı kayıtlar yeniden üretilip ilk N byte atlanarak devam ettirilir. If-Range
+// olmayan ya da artık geçerli olmayan Range isteğine tam içerik (200) gönderilir.
+#define FAULT_EXPORT_BUFFER_SIZE    1024
+
+// start/end/type/channel sorgu parametrelerini oku (export ve /api/faults/query ortak)
+bool readFaultQueryArgs(FaultQuery& query);
+
+void handleFaultExportAPI();
+
+// GET /api/faults/comtrade?part=cfg|dat&format=ascii|binary[&before=<id>] - IEEE C37.111-1999
+void handleFaultComtradeAPI();
+
+#endif // FAULT_EXPORT_H
@@ -0,0 +1,29 @@
+#ifndef FAULT_JOBS_H
+#define FAULT_JOBS_H
+
+#include <Arduino.h>
+
+// Asenkron arıza sorgu işleri. HTTP isteği işi oluşturup hemen 202 döner,
+// UART owner task sorguyu yapar, sonuç web task'ında WebSocket ile iletilir.
+#define MAX_FAULT_JOBS          4
+#define FAULT_JOB_RETENTION_MS  60000   // Tamamlanan sonuç bu süre boyunca sorgulanabilir
+#define FAULT_RANGE_JOB_RECORDS 16      // Tek işte (tek WebSocket mesajında) en fazla kayıt
+#define FAULT_RANGE_BUFFER_SIZE 2048    // Toplu aktarım kayıt tamponu (statik, heap kullanılmaz)
+
+// 0: iş oluşturulamadı (tablo dolu / UART kuyruğu reddetti)
+uint32_t createFaultJob(bool isFirst, int clientId);
+
+// Toplu aktarım (CMD_GET_FAULT_RANGE) - aynı anda tek iş. dsPIC desteklemiyorsa false.
+// İş başına en fazla FAULT_RANGE_JOB_RECORDS kayıt; sonuçtaki 'next' ile sonraki parça
+// istenir ('next' = alınan son kaydın dsPIC indeksi + 1). Tampon dolarsa ilk sığmayan
+// kayıt ve sonrakiler bu parçaya girmez, 'next' onlardan başlar.
+bool faultRangeSupported();
+uint32_t createFaultRangeJob(uint16_t start, uint16_t count, int clientId);
+
+// Tamamlanan işleri WebSocket'e iletir - sadece web task'ından çağrılır
+void processFaultJobs();
+
+// İş durumu JSON'u; bilinmeyen id için boş String
+String getFaultJobJSON(uint32_t jobId);
+
+#endif // FAULT_JOBS_H
@@ -0,0 +1,56 @@
+#ifndef FAULT_RECORD_H
+#define FAULT_RECORD_H
+
+// Sabit boyutlu arıza kaydı ve ayrıştırıcı. String/heap kullanılmaz.
+// Arduino bağımlılığı yok - uart_frame gibi host derlemesinde de çalışır.
+//
+// dsPIC metin satırı (eski protokol ve frame verisi):
+//   <sıra>,<DDMMYYHHMMSS[.mmm]>,<kanal>,<tip>[,<değer>...]
+//   Ayraç ',' ya da ';'; alan başı/sonu boşlukları yok sayılır. Değerler ondalıklı olabilir.
+//
+// İkili kayıt (frame verisi, ilk byte FAULT_RECORD_BINARY_TAG, big-endian):
+//   tag(1) sıra(2) unix saniye(4) ms(2) kanal(1) tip(1) adet(1) adet x değer(4, x100)
+#include <stdint.h>
+#include <stddef.h>
+
+#define FAULT_RECORD_MAX_VALUES     8
+#define FAULT_RECORD_VALUE_SCALE    100     // values[] = gerçek değer x 100
+#define FAULT_RECORD_BINARY_TAG     0xFB    // Yazdırılabilir metin bu byte ile başlamaz
+#define FAULT_RECORD_BINARY_HEADER  12
+
+// En kötü durum çıktı boyutları (tüm değerler dolu, en uzun sayılar)
+#define FAULT_RECORD_JSON_MAX       256
+#define FAULT_RECORD_CBOR_MAX       112
+
+enum FaultRecordFlags {
+    FAULT_RECORD_HAS_MILLIS = 0x01,         // Zaman damgası ms hassasiyetinde
+    FAULT_RECORD_TRUNCATED = 0x02,          // FAULT_RECORD_MAX_VALUES'tan fazla değer atıldı
+    FAULT_RECORD_FROM_BINARY = 0x04
+};
+
+struct FaultRecord {
+    uint32_t timestamp;                     // Unix zamanı (s) - dsPIC yerel saati
+    uint16_t millis;
+    uint16_t sequence;                      // dsPIC kayıt numarası
+    uint8_t channel;
+    uint8_t typeCode;
+    uint8_t valueCount;
+    uint8_t flags;
+    int32_t values[FAULT_RECORD_MAX_VALUES];
+};
+
+// Metin ya da ikili kayıt - ilk byte'a göre seçilir. Hatalı girişte false, record belirsiz.
+bool parseFaultRecord(const uint8_t* data, size_t length, FaultRecord& record);
+bool parseFaultRecordText(const char* text, size_t length, FaultRecord& record);
+bool parseFaultRecordBinary(const uint8_t* data, size_t length, FaultRecord& record);
+
+// Yazılan byte sayısı; kapasite yetmezse 0. JSON null ile sonlanır (sayıya dahil değil).
+size_t faultRecordToJSON(const FaultRecord& record, char* out, size_t capacity);
+size_t faultRecordToCBOR(const FaultRecord& record, uint8_t* out, size_t capacity);
+size_t faultRecordToBinary(const FaultRecord& record, uint8_t* out, size_t capacity);
+
+// DDMMYYHHMMSS <-> Unix zamanı (2000-2099)
+bool faultTimestampFromDigits(const char* digits, uint32_t& timestamp);
+void faultTimestampToDigits(uint32_t timestamp, char* out);  // out: en az 13 byte
+
+#endif // FAULT_RECORD_H
@@ -0,0 +1,80 @@
+#ifndef FAULT_STORE_H
+#define FAULT_STORE_H
+
+#include <Arduino.h>
+#include "fault_record.h"
+
+// dsPIC arıza kayıtlarının LittleFS'teki kalıcı kopyası. Arayüz sayfalaması UART'a
+// gitmez; dsPIC kendi kaydını silse ya da başa sarsa bile geçmiş burada kalır.
+//
+// Kayıtlar sadece sona eklenir, sabit boyutludur ve segment dosyalarına bölünür:
+//   /faults/00000012.seg  (segment no = id / FAULT_STORE_SEGMENT_RECORDS)
+// Yerel kayıt numarası (id) 0'dan artar, segment ve dosya konumu id'den hesaplanır -
+// "N. kayda git" tek seek + read. Saklama sınırı aşılınca en eski segment silinir.
+#define FAULT_STORE_DIR                 "/faults"
+#define FAULT_STORE_SEGMENT_RECORDS     256
+#define FAULT_STORE_MAX_SEGMENTS        16      // 4096 kayıt, ~210KB
+#define FAULT_STORE_CAPACITY            (FAULT_STORE_SEGMENT_RECORDS * FAULT_STORE_MAX_SEGMENTS)
+#define FAULT_STORE_SYNC_INTERVAL       60000   // Olay gelmese de dsPIC'ten artımlı çekme aralığı
+#define FAULT_STORE_SYNC_BATCH          50      // Tek CMD_GET_FAULT_RANGE isteği
+#define FAULT_STORE_SYNC_MAX_BATCHES    8       // Tek turda en fazla (uartTask'ı uzun tutmamak için)
+#define FAULT_STORE_PAGE_MAX            50      // /api/faults tek sayfa üst sınırı
+#define FAULT_STORE_QUERY_MAX           500     // /api/faults/query tek yanıt üst sınırı
+#define FAULT_STORE_NVS_NAMESPACE       "fault-store"
+
+// Diskteki kayıt - CRC-8 'crc' alanı sıfırken tüm yapı üzerinden hesaplanır
+struct StoredFault {
+    uint32_t id;
+    uint16_t dspicIndex;                // dsPIC kaydındaki sıra (senkronizasyon anında)
+    uint8_t reserved;
+    uint8_t crc;
+    FaultRecord record;
+};
+
+struct FaultStoreStats {
+    unsigned long syncs;
+    unsigned long appended;
+    unsigned long duplicates;           // Zaten kayıtlı (başa sarma sonrası tekrar)
+    unsigned long parseErrors;          // Tanınmayan kayıt metni - saklanmadı
+    unsigned long writeErrors;
+    unsigned long rescans;              // dsPIC kaydı değişti, baştan tarandı
+    unsigned long lastSyncAt;
+    uint16_t dspicCursor;               // dsPIC'te sıradaki okunacak indeks
+    uint16_t dspicTotal;                // Son aktarımda bildirilen toplam
+};
+
+extern FaultStoreStats faultStoreStats;
+
+// Kurulum - LittleFS.begin'den sonra; segmentleri tarar, bozuk kuyruğu onarır
+bool initFaultStore();
+
+// Herhangi bir task'tan - bir sonraki turda senkronize et (yeni arıza olayı vb.)
+void requestFaultStoreSync();
+// uartTask'tan çağrılır - aralık dolduysa ya da istek varsa dsPIC'ten yeni kayıtları çeker
+void processFaultStoreSync();
+
+// Okuma: [from, from + count) - kayıt dışı id'ler atlanmaz, okunan sayı döner
+size_t readStoredFaults(uint32_t from, StoredFault* out, size_t count);
+uint32_t getFaultStoreFirstId();        // Saklanan en eski kayıt
+uint32_t getFaultStoreNextId();         // Eklenecek sonraki kayıt (son + 1)
+
+// Zaman aralığı sorgusu - dsPIC saati geri gidebildiğinden kayıtlar id sırasıyla döner, zaman
+// sırası garanti değildir. beginFaultQuery RAM'deki zaman indeksinden eşleşen ilk/son id'yi
+// bulur; continueFaultQuery sadece zaman ve tip/kanal bitmap'i uyan segmentleri okur ve
+// eşleşenleri parça parça döndürür (her çağrı kilidi kısa tutar, araya ekleme girebilir).
+struct FaultQuery {
+    uint32_t startTime;                 // Dahil (Unix, dsPIC yerel saati)
+    uint32_t endTime;                   // Dahil
+    int16_t typeCode;                   // -1: tümü
+    int16_t channel;                    // -1: tümü
+    uint32_t cursor;                    // Sıradaki bakılacak id
+    uint32_t end;                       // Aralığın sonu (hariç)
+    uint32_t scanned;                   // Diskten okunan kayıt
+};
+
+void beginFaultQuery(FaultQuery& query);
+size_t continueFaultQuery(FaultQuery& query, StoredFault* out, size_t capacity);
+
+String getFaultStoreStatsJSON();
+
+#endif // FAULT_STORE_H
@@ -0,0 +1,80 @@
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Kalıcı log - halkadaki girdiler metne çevrilip LittleFS'e yazılır, ESP.restart() ve
+// güç kesintisinden sonra okunabilir. Her girdi ayrı yazılmaz: RAM tamponunda biriktirilip
+// dolunca ya da süre dolunca tek seferde eklenir (group commit) - flash aşınması azalır.
+//
+// Segmentler sıra numaralıdır, her açılış yeni segmentle başlar:
+//   /logs/00000042.log
+// Segment boyutu aşılınca sonrakine geçilir; toplam sınır aşılınca en eski silinir.
+// Yarım yazılmış kayıt (CRC tutmaz) o segmentin sonu sayılır, okuma sonraki segmentle sürer.
+#define LOG_STORE_DIR               "/logs"
+#define LOG_STORE_SEGMENT_SIZE      16384
+#define LOG_STORE_MAX_BYTES         131072  // Tüm segmentler
+#define LOG_STORE_BATCH_SIZE        2048    // Group commit tamponu
+#define LOG_STORE_FLUSH_BYTES       1536    // Bu doluluğa gelince yaz
+#define LOG_STORE_FLUSH_INTERVAL    5000    // ms, tampon en fazla bu kadar bekler
+#define LOG_STORE_FS_BLOCK          4096    // Yazma büyütmesi tahmini için LittleFS blok boyu
+#define LOG_STORE_MARKER            0xA7
+#define LOG_STORE_NVS_NAMESPACE     "log-store"
+
+// DEBUG kalıcı yazılmaz (seri konsol/web halkasında kalır)
+#ifndef LOG_STORE_LEVEL_MASK
+#define LOG_STORE_LEVEL_MASK        ((1 << ERROR) | (1 << WARN) | (1 << INFO) | (1 << SUCCESS))
+#endif
+
+// Diskteki kayıt başlığı; ardından kaynak adı ve mesaj metni gelir (sonlandırıcı yok).
+// CRC-8 'crc' alanı sıfırken başlık + metin üzerinden hesaplanır.
+struct StoredLogHeader {
+    uint8_t marker;
+    uint8_t crc;
+    uint8_t level;
+    uint8_t flags;                      // LogEntryFlags
+    uint32_t boot;                      // Açılış sayacı (NVS)
+    uint32_t sequence;                  // Halka sırası - açılış içinde artar
+    uint32_t timestamp;                 // saniye - LOG_FLAG_WALLCLOCK ise Unix zamanı
+    uint8_t sourceLength;
+    uint8_t messageLength;
+    uint16_t millis;                    // Saniye içindeki ms
+};
+
+struct LogStoreStats {
+    unsigned long records;
+    unsigned long skipped;              // Yazılamadan halkada üzerine yazılan girdiler
+    unsigned long logicalBytes;         // Kaynak + mesaj metni
+    unsigned long fileBytes;            // Dosyaya eklenen (başlıklar dahil)
+    unsigned long flashBytes;           // Tahmini flash programlama (kısmi blok kopyası dahil)
+    unsigned long flushes;
+    unsigned long sizeFlushes;
+    unsigned long timeFlushes;
+    unsigned long forcedFlushes;        // Yeniden başlatma / dışa aktarma öncesi
+    unsigned long writeErrors;
+    unsigned long lastFlushUs;
+    unsigned long maxFlushUs;
+    unsigned long totalFlushUs;
+    uint32_t boot;
+};
+
+extern LogStoreStats logStoreStats;
+
+// Kurulum - LittleFS.begin'den sonra; açılış sayacını artırır, segmentleri tarar
+bool initLogStore();
+
+// Log konsol task'ından - yeni halka girdilerini tampona al, tetiklenmişse yaz
+void processLogStore();
+
+// Herhangi bir task'tan - bekleyen girdileri hemen yaz (ESP.restart() öncesi)
+void flushLogStore();
+
+void fillLogStoreJSON(JsonObject stats);
+
+// GET /api/logs/persistent[?boot=<n>] - tüm açılışlar, eskiden yeniye NDJSON akışı
+void handlePersistentLogAPI();
+// GET /api/logs/persistent/stats
+void handlePersistentLogStatsAPI();
+
+#endif // LOG_STORE_H
@@ -11,23 +11,238 @@ enum LogLevel {
     SUCCESS = 4
 };
 
+// Kilitsiz çok üreticili log halkası - tüm task'lar ve loop() aynı anda yazabilir.
+// Girdiler sabit boyutlu POD; heap kullanılmaz.
+//
+// Üretici head'i atomik artırarak bir sıra numarası alır, slotu meşgul işaretler,
+// yazar ve slotun 'commit' alanına sıra+1 yazarak yayınlar. Okuyucu sıra numarası
+// ile ister; commit kopyadan önce ve sonra aynıysa kopya tutarlıdır (seqlock).
+// Yazılırken üzerine tur bindirilen slot atlanır (dropped), okuyucu asla yarım girdi görmez.
+//
+// Girdi metin tutmaz: biçim dizgisinin adresi (flash'taki literal) ve etiketli, paketlenmiş
+// argümanlar yazılır. Metin sadece okunurken (web, WebSocket, konsol) formatLogMessage ile
+// üretilir. Kısa %s içeriği argüman alanına kopyalanır; uzunu paylaşılan metin halkasına
+// yazılır ve girdide sadece konumu tutulur. Halkada üzerine yazılmış metin "[...]" olarak,
+// LOG_STRING_MAX'ta kesilen ya da argüman alanına sığmayan girdi sonda "..." ile gösterilir.
+#define LOG_RING_SIZE           256     // 2'nin kuvveti
+#define LOG_ARG_BYTES           32      // Etiket + değer; int 5, double 9, metin 2 + uzunluk ya da 6
+#define LOG_STRING_INLINE_MAX   12      // Bu uzunluğa kadar %s argüman alanında
+#define LOG_STRING_MAX          120     // Tek %s argümanının en uzun hali
+#define LOG_STRING_ARENA        4096    // Uzun %s içerikleri için bayt halkası (2'nin kuvveti)
+#define LOG_MESSAGE_MAX         128     // Biçimlenmiş metin (okuyucu tamponu)
+#define LOG_SOURCE_NAME_MAX     12
+#define LOG_MAX_SOURCES         32      // Farklı kaynak adı ("UART", "WEB", ...)
+#define LOG_SOURCE_UNKNOWN      0xFF
+
+// Seri konsol - addLog yazmaz; düşük öncelikli task halkayı okuyup toplu yazar
+// (aynı task kalıcı log deposunu da besler, bkz. log_store.h).
+// Konsol geride kalıp girdinin üzerine yazılırsa satır düşer ve sayılır.
+#define LOG_CONSOLE_TASK_STACK      6144    // LittleFS yazımı dahil
+#define LOG_CONSOLE_TASK_PRIORITY   1
+#define LOG_CONSOLE_TASK_CORE       0
+#define LOG_CONSOLE_INTERVAL        50      // ms, boşaltma aralığı
+#define LOG_CONSOLE_BATCH           512     // Tek Serial.write
+
+// Derleme zamanı seviye tabanı - bunun üstündeki LOG_* çağrıları hiç derlenmez
+// (argümanları da değerlendirilmez). 0 ERROR, 1 WARN, 2 INFO/SUCCESS, 3 DEBUG.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL       2
+#endif
+
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+#error "LOG_RING_SIZE 2'nin kuvveti olmalı"
+#endif
+#if (LOG_STRING_ARENA & (LOG_STRING_ARENA - 1)) != 0
+#error "LOG_STRING_ARENA 2'nin kuvveti olmalı"
+#endif
+
+enum LogEntryFlags {
+    LOG_FLAG_WALLCLOCK = 0x01,          // timestamp Unix zamanı (aksi halde açılıştan beri)
+    LOG_FLAG_TRUNCATED = 0x02           // Argüman alanına sığmayan değer kesildi/atlandı
+};
+
+enum LogArgTag {
+    LOG_ARG_INT32 = 1,                  // char/short/int/long (32 bit) - işaret biçimden gelir
+    LOG_ARG_INT64,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,                     // uzunluk byte'ı + içerik (sonlandırıcı yok)
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING_REF                  // uzunluk byte'ı + metin halkasındaki konum (4)
+};
+
 struct LogEntry {
-    String timestamp;
-    String message;
-    LogLevel level;
-    String source;
-    unsigned long millis_time;
+    uint32_t sequence;
+    uint32_t timestamp;                 // saniye
+    uint16_t millis;                    // Saniye içindeki ms - aynı saniyedeki girdiler için
+    uint8_t level;                      // LogLevel
+    uint8_t sourceId;                   // logSourceName ile ada çevrilir
+    uint8_t flags;
+    uint8_t argLength;
+    const char* format;                 // Statik ömürlü literal - kopyalanmaz
+    uint8_t args[LOG_ARG_BYTES];
 };
 
-extern LogEntry logs[50];
-extern int logIndex;
-extern int totalLogs;
+// Uzun metni paylaşılan halkaya kopyalar, konumunu döndürür (kilitsiz, her task'tan)
+uint32_t logStoreString(const char* text, size_t length);
+
+// Argüman paketleme - tür derleme zamanında seçilir, biçim dizgisi yazarken okunmaz
+struct LogArgPacker {
+    uint8_t* data;
+    uint8_t used;
+    bool truncated;
+
+    void put(uint8_t tag, const void* value, uint8_t size) {
+        if (used + 1 + size > LOG_ARG_BYTES) {
+            truncated = true;
+            used = LOG_ARG_BYTES;       // Sonraki argümanlar da sıra kaymasın diye atlanır
+            return;
+        }
+        data[used] = tag;
+        memcpy(data + used + 1, value, size);
+        used += 1 + size;
+    }
+
+    void putInteger(uint64_t value, size_t size) {
+        if (size <= 4) {
+            uint32_t narrow = (uint32_t)value;
+            put(LOG_ARG_INT32, &narrow, 4);
+        } else {
+            put(LOG_ARG_INT64, &value, 8);
+        }
+    }
+
+    void putString(const char* text) {
+        if (text == NULL) text = "(null)";
+        size_t length = strnlen(text, LOG_STRING_MAX + 1);
+        if (length > LOG_STRING_MAX) {
+            length = LOG_STRING_MAX;
+            truncated = true;
+        }
+
+        if (length <= LOG_STRING_INLINE_MAX && used + 2 + length <= LOG_ARG_BYTES) {
+            data[used] = LOG_ARG_STRING;
+            data[used + 1] = (uint8_t)length;
+            memcpy(data + used + 2, text, length);
+            used += 2 + length;
+            return;
+        }
+        if (used + 6 > LOG_ARG_BYTES) {
+            truncated = true;
+            used = LOG_ARG_BYTES;
+            return;
+        }
+        uint32_t position = logStoreString(text, length);
+        data[used] = LOG_ARG_STRING_REF;
+        data[used + 1] = (uint8_t)length;
+        memcpy(data + used + 2, &position, 4);
+        used += 6;
+    }
+};
+
+inline void logPackArg(LogArgPacker& packer, int value) { packer.putInteger((uint64_t)(int64_t)value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, unsigned int value) { packer.putInteger(value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, long value) { packer.putInteger((uint64_t)(int64_t)value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, unsigned long value) { packer.putInteger(value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, long long value) { packer.putInteger((uint64_t)value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, unsigned long long value) { packer.putInteger(value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, double value) { packer.put(LOG_ARG_DOUBLE, &value, sizeof(value)); }
+inline void logPackArg(LogArgPacker& packer, const char* value) { packer.putString(value); }
+inline void logPackArg(LogArgPacker& packer, const void* value) {
+    uint64_t address = (uintptr_t)value;
+    packer.put(LOG_ARG_POINTER, &address, sizeof(address));
+}
+
+inline void logPackArgs(LogArgPacker& packer) {}
+
+template <typename T, typename... Rest>
+inline void logPackArgs(LogArgPacker& packer, T value, Rest... rest) {
+    logPackArg(packer, value);
+    logPackArgs(packer, rest...);
+}
+
+void logCommit(LogLevel level, uint8_t sourceId, const char* format, const uint8_t* args,
+               uint8_t argLength, uint8_t flags);
+
+template <typename... Args>
+void logWrite(LogLevel level, uint8_t sourceId, const char* format, Args... args) {
+    uint8_t data[LOG_ARG_BYTES];
+    LogArgPacker packer = { data, 0, false };
+    logPackArgs(packer, args...);
+    logCommit(level, sourceId, format, data, packer.used, packer.truncated ? LOG_FLAG_TRUNCATED : 0);
+}
+
+// Hiç çağrılmaz - sadece derleyicinin biçim/argüman uyumunu denetlemesi için
+inline void logFormatCheck(const char* format, ...) __attribute__((format(printf, 1, 2)));
+inline void logFormatCheck(const char* format, ...) {}
+
+// Çalışma zamanı kaynak maskesi - bit (1 << LogLevel) açıksa o seviye yazılır.
+// Maske biçimlendirmeden önce kontrol edilir; kapalı seviye için hiçbir şey üretilmez.
+#define LOG_MASK_ALL            0x1F
+#define LOG_SOURCE_PENDING      0xFE    // Çağrı noktası kaynak kimliğini henüz almadı
+
+extern volatile uint8_t logSourceMasks[LOG_MAX_SOURCES];
+extern volatile uint8_t logDefaultMask;             // Kimlik alamayan kaynaklar için
+
+inline bool isLogEnabled(uint8_t sourceId, LogLevel level) {
+    uint8_t mask = sourceId < LOG_MAX_SOURCES ? logSourceMasks[sourceId] : logDefaultMask;
+    return (mask & (1 << level)) != 0;
+}
+
+#define LOG_LEVEL_RANK(level)   ((level) == SUCCESS ? INFO : (level))
+
+// Kullanım: LOG_WARN("UART", "Timeout (%lu ms)", timeout);
+// Kaynak kimliği çağrı noktasında bir kez alınıp saklanır; sonraki çağrılar ad aramaz.
+// Biçim literal olmalı ("" birleştirmesi başka bir şeyi derlemez) - adresi saklanır.
+#define LOG_AT(level, source, format, ...) do { \
+        if (LOG_LEVEL_RANK(level) <= LOG_COMPILE_LEVEL) { \
+            static uint8_t logSourceId_ = LOG_SOURCE_PENDING; \
+            if (logSourceId_ == LOG_SOURCE_PENDING) logSourceId_ = internLogSource(source); \
+            if (isLogEnabled(logSourceId_, level)) { \
+                if (false) logFormatCheck(format, ##__VA_ARGS__); \
+                logWrite(level, logSourceId_, "" format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define LOG_ERROR(source, ...)      LOG_AT(ERROR, source, __VA_ARGS__)
+#define LOG_WARN(source, ...)       LOG_AT(WARN, source, __VA_ARGS__)
+#define LOG_INFO(source, ...)       LOG_AT(INFO, source, __VA_ARGS__)
+#define LOG_SUCCESS(source, ...)    LOG_AT(SUCCESS, source, __VA_ARGS__)
+#define LOG_DEBUG(source, ...)      LOG_AT(DEBUG, source, __VA_ARGS__)
 
 void initLogSystem();
+// Hazır metin - "%s" ile saklanır, LOG_STRING_MAX byte'tan uzunu kesilir. Yeni kod LOG_* kullanmalı.
 void addLog(const String& msg, LogLevel level, const String& source);
+void addLog(const char* msg, LogLevel level, const char* source);
+
+// Okuma - [getLogTail(), getLogHead()) aralığındaki sıralar istenebilir.
+// false: girdi üzerine yazılmış, henüz yayınlanmamış ya da temizlenmiş.
+uint32_t getLogHead();
+uint32_t getLogTail();
+uint32_t getLogCount();
+uint32_t getDroppedLogCount();
+bool readLogEntry(uint32_t sequence, LogEntry& entry);
+
+// Konsol çıktısı çalışırken kapatılabilir (halka ve web logları etkilenmez)
+void setLogConsoleEnabled(bool enabled);
+bool isLogConsoleEnabled();
+uint32_t getConsoleDroppedCount();
+
+// Kaynak maskesi - ada göre (kaynak yoksa oluşturulur)
+bool setLogSourceMask(const char* source, uint8_t mask);
+uint8_t getLogSourceMask(uint8_t sourceId);
+uint8_t getLogSourceCount();
+
+uint8_t internLogSource(const char* name);
+const char* logSourceName(uint8_t sourceId);
+const char* logLevelName(uint8_t level);
+size_t formatLogTimestamp(const LogEntry& entry, char* out, size_t capacity);
+size_t formatLogTime(uint32_t timestamp, uint16_t millis, uint8_t flags, char* out, size_t capacity);
+size_t formatLogMessage(const LogEntry& entry, char* out, size_t capacity);
+
 String logLevelToString(LogLevel level);
 void clearLogs();
 String getFormattedTimestamp();
 String getFormattedTimestampFallback();
 
-#endif
\ No newline at end of file
+#endif
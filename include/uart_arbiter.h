@@ -0,0 +1,143 @@
+#ifndef UART_ARBITER_H
+#define UART_ARBITER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "uart_frame.h"
+
+// UART sahibi task - dsPIC ile tüm G/Ç sadece bu task üzerinden yapılır.
+// Diğer task'lar istek (transaction) kuyruğa koyar ve kendi tamamlama nesnesini bekler.
+#define UART_OWNER_TASK_STACK       4096
+#define UART_OWNER_TASK_PRIORITY    3       // uartTask (2) üzerinde, RX task (5) altında
+#define UART_OWNER_TASK_CORE        1
+#define UART_QUEUE_DEPTH            8       // Öncelik başına bekleyen istek
+#define UART_TX_MAX_REQUEST         128     // Metin komutu / frame verisi üst sınırı
+#define UART_OWNER_IDLE_INTERVAL    1000    // Boşta bakım (el sıkışma, yeniden başlatma) aralığı
+#define UART_CALLER_POOL_SIZE       3       // Aynı anda senkron bekleyen çağıran (web, UART, sistem task'ı)
+#define UART_CALLER_POOL_WAIT_MS    1000    // Havuz doluysa boş yuva için en fazla bekleme
+
+// Boru hattı - sıralı protokolde aynı anda hatta bekleyen FRAME isteği (derleme bayrağı ile ayarlanır).
+// Gerçek pencere el sıkışmada dsPIC'in bildirdiği değerle küçültülür.
+#ifndef UART_PIPELINE_WINDOW
+#define UART_PIPELINE_WINDOW        4
+#endif
+#if UART_PIPELINE_WINDOW < 1 || UART_PIPELINE_WINDOW > 16
+#error "UART_PIPELINE_WINDOW 1..16 olmalı"
+#endif
+#define UART_MAX_RETRANSMITS        2       // Checksum hatası / timeout sonrası yeniden gönderim
+#define UART_MIN_ATTEMPT_TIMEOUT    250     // Tek denemenin en kısa bekleme süresi (ms)
+
+// Öncelik sırası - küçük değer önce işlenir
+enum UARTPriority {
+    UART_PRIORITY_INTERACTIVE = 0,  // Web arayüzünden gelen istekler
+    UART_PRIORITY_NORMAL = 1,       // Ayar gönderme vb.
+    UART_PRIORITY_BACKGROUND = 2,   // Periyodik zaman sorgusu, sağlık testi
+    UART_PRIORITY_COUNT = 3
+};
+
+enum UARTTransactionKind {
+    UART_TRANSACTION_TEXT,          // Eski metin komutu -> tek satır yanıt
+    UART_TRANSACTION_FRAME,         // STX/ETX frame komutu -> tek frame yanıt
+    UART_TRANSACTION_STREAM         // Frame komutu -> bitiş frame'ine kadar çok sayıda frame
+};
+
+enum UARTTransactionStatus {
+    UART_STATUS_PENDING,
+    UART_STATUS_OK,
+    UART_STATUS_TIMEOUT,            // Yanıt gelmedi
+    UART_STATUS_NACK,               // dsPIC NACK frame'i döndü
+    UART_STATUS_EXPIRED,            // Son başlama zamanı geçti, hatta hiç gönderilmedi
+    UART_STATUS_REJECTED,           // Kuyruk dolu / geçersiz istek
+    UART_STATUS_ERROR,              // Gönderim hatası
+    UART_STATUS_CIRCUIT_OPEN        // Devre kesici açık - hatta gönderilmedi (uart_breaker.h)
+};
+
+struct UARTTransaction;
+typedef void (*UARTCompletionCallback)(UARTTransaction* transaction, void* context);
+// STREAM: bitiş frame'i hariç her frame için owner task bağlamında çağrılır
+typedef void (*UARTFrameSink)(const UARTFrame& frame, void* context);
+
+// Tek bir istek/yanıt alışverişi. Belleği çağırana aittir ve tamamlanana kadar
+// geçerli kalmalıdır; executeUARTTransaction bunu garanti eder.
+struct UARTTransaction {
+    // İstek
+    UARTTransactionKind kind;
+    UARTPriority priority;
+    uint8_t command;                        // FRAME / STREAM
+    uint16_t requestLength;
+    uint8_t request[UART_TX_MAX_REQUEST];
+    unsigned long timeoutMs;                // Yanıt bekleme süresi (STREAM: frame'ler arası)
+    unsigned long deadline;                 // millis(); bu zamana kadar başlamazsa EXPIRED
+    bool compressReply;                     // FRAME / STREAM: dsPIC yanıtı LZSS ile sıkıştırabilir
+
+    // Sadece STREAM
+    uint8_t streamEndCommand;               // Bu komutla gelen frame akışı bitirir (response'a yazılır)
+    uint16_t streamFrames;                  // Sink'e verilen frame sayısı
+    UARTFrameSink frameSink;
+    void* sinkContext;
+
+    // Sonuç (owner task yazar)
+    volatile UARTTransactionStatus status;
+    uint8_t responseCommand;                // FRAME / STREAM
+    uint16_t responseLength;
+    uint8_t response[MAX_FRAME_SIZE + 1];   // Metin yanıtları null ile sonlanır
+    uint32_t streamBytes;                   // STREAM: sink'e verilen frame verisi
+    uint8_t retries;                        // Pencerede yeniden gönderim sayısı
+    unsigned long queuedAt;
+    unsigned long startedAt;                // Kuyruktan alınıp hatta gönderildiği an
+    unsigned long completedAt;
+
+    // Tamamlanma
+    SemaphoreHandle_t done;                 // Senkron bekleme (NULL ise sadece callback)
+    StaticSemaphore_t doneStorage;
+    UARTCompletionCallback callback;        // Owner task bağlamında çağrılır, kısa tutulmalı
+    void* context;
+};
+
+// Başlatma - initUART'tan sonra bir kez
+bool initUARTArbiter();
+bool isUARTOwnerTask();
+
+// İstek hazırlama
+bool prepareTextTransaction(UARTTransaction& transaction, const String& line,
+                            unsigned long timeoutMs, UARTPriority priority);
+bool prepareFrameTransaction(UARTTransaction& transaction, uint8_t command, const uint8_t* data,
+                             uint16_t dataLength, unsigned long timeoutMs, UARTPriority priority);
+bool prepareStreamTransaction(UARTTransaction& transaction, uint8_t command, const uint8_t* data,
+                              uint16_t dataLength, uint8_t endCommand, UARTFrameSink sink, void* sinkContext,
+                              unsigned long frameTimeoutMs, UARTPriority priority);
+
+// Kuyruğa koy ve dön (tamamlanınca callback çağrılır)
+bool submitUARTTransaction(UARTTransaction* transaction);
+// Kuyruğa koy ve tamamlanana kadar bekle. Owner task içinden çağrılırsa doğrudan çalıştırır.
+bool executeUARTTransaction(UARTTransaction& transaction);
+
+// Senkron çağıranlar için statik transaction havuzu - yapı (~800 byte) çağıranın stack'ine
+// konmaz. Havuz UART_CALLER_POOL_WAIT_MS içinde boşalmazsa NULL. İş bitince release edilir.
+UARTTransaction* acquireUARTTransaction();
+void releaseUARTTransaction(UARTTransaction* transaction);
+
+String transactionResponseString(const UARTTransaction& transaction);
+const char* transactionStatusToString(UARTTransactionStatus status);
+
+// Owner task'a bakım istekleri (bir sonraki boş anda uygulanır)
+void scheduleUARTReinit();
+
+// Kuyruk istatistikleri
+struct UARTArbiterStats {
+    unsigned long completed;
+    unsigned long expired;
+    unsigned long rejected;
+    unsigned long maxQueueWaitMs;
+    unsigned long retransmits;              // Pencerede yeniden gönderilen frame
+    unsigned long staleResponses;           // Bekleyen isteğe ait olmayan sıra numarası
+    uint8_t peakInflight;                   // Aynı anda hatta olan en fazla istek
+    unsigned long compressedBytes;          // Hattan gelen sıkıştırılmış veri
+    unsigned long inflatedBytes;            // Açılmış hali
+};
+
+extern UARTArbiterStats uartArbiterStats;
+uint8_t getUARTQueueDepth();
+
+#endif // UART_ARBITER_H
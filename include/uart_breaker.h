@@ -0,0 +1,47 @@
+#ifndef UART_BREAKER_H
+#define UART_BREAKER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "uart_arbiter.h"
+
+// dsPIC hattı için devre kesici. Ayrı ping yok - gerçek istek sonuçlarıyla çalışır:
+//   KAPALI    Normal. Art arda UART_BREAKER_FAILURE_THRESHOLD yanıtsız istek -> AÇIK
+//   AÇIK      İstekler kuyruğa girmeden UART_STATUS_CIRCUIT_OPEN ile hemen döner
+//   YARI AÇIK Bekleme dolunca sıradaki tek istek deneme olarak hatta gider; yanıt
+//             gelirse KAPALI, gelmezse daha uzun bekleme ile tekrar AÇIK
+// Bekleme her açılmada iki katına çıkar (± jitter). dsPIC yeniden başlarken ya da
+// kablo çıkmışken task'lar boşuna timeout beklemez.
+#define UART_BREAKER_FAILURE_THRESHOLD  5
+#define UART_BREAKER_BASE_BACKOFF       1000    // ms, ilk açılma
+#define UART_BREAKER_MAX_BACKOFF        60000
+#define UART_BREAKER_JITTER_PERCENT     20
+#define UART_BREAKER_REINIT_AFTER       3       // Art arda bu kadar açılmada UART yeniden başlatılır
+
+enum UARTBreakerState {
+    UART_BREAKER_CLOSED,
+    UART_BREAKER_OPEN,
+    UART_BREAKER_HALF_OPEN
+};
+
+struct UARTBreakerStats {
+    unsigned long opens;
+    unsigned long rejected;             // Hızlı hata ile dönen istek
+    unsigned long probes;
+    unsigned long reinits;
+};
+
+extern UARTBreakerStats uartBreakerStats;
+
+// Herhangi bir task'tan - açık ve bekleme sürüyor mu (istek kuyruğa konmadan)
+bool isUARTCircuitOpen();
+
+// Owner task - istek hatta gönderilmeden önce. false: UART_STATUS_CIRCUIT_OPEN ile bitir.
+bool uartBreakerAdmit();
+// Owner task - her tamamlanan istek için
+void uartBreakerRecord(UARTTransactionStatus status);
+
+UARTBreakerState getUARTBreakerState();
+void fillUARTBreakerJSON(JsonObject breaker);
+
+#endif // UART_BREAKER_H
@@ -0,0 +1,168 @@
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+// STX/ETX ve COBS frame tanımları ve kod çözücü.
+// Arduino bağımlılığı yok - UART task'ında ve host derlemesinde aynı şekilde çalışır.
+#include <stdint.h>
+#include <stddef.h>
+
+// UART Protocol definitions
+#define FRAME_START_CHAR    0x02  // STX
+#define FRAME_END_CHAR      0x03  // ETX
+#define FRAME_ESCAPE_CHAR   0x1B  // ESC
+#define COBS_DELIMITER      0x00
+#define MAX_FRAME_SIZE      512
+#define FRAME_TIMEOUT       2000
+
+// En kötü durum: STX + her byte escape'li (cmd + seq + len2 + data + checksum) + ETX
+#define MAX_ENCODED_FRAME_SIZE  (2 + 2 * (4 + MAX_FRAME_SIZE + 1))
+
+// COBS: ayraç + ilk kod byte'ı + içerik + her 254 byte için 1 kod byte'ı + ayraç (veriden bağımsız)
+#define COBS_MAX_ENCODED_SIZE(n)    ((n) + (n) / 254 + 3)
+
+// Sıra numarası yok (protokol v1/v2 frame biçimi)
+#define FRAME_NO_SEQUENCE   -1
+
+// Frame structure
+// Sıralı modda (CAP_SEQUENCE) komuttan sonra 1 byte sıra numarası gelir ve checksum'a dahildir:
+// STX cmd seq lenH lenL data... checksum ETX
+struct UARTFrame {
+    uint8_t command;
+    uint8_t sequence;               // Sadece sıralı modda anlamlı
+    uint16_t dataLength;
+    uint8_t data[MAX_FRAME_SIZE];
+    uint8_t checksum;
+};
+
+// Command codes
+enum UARTCommands {
+    CMD_GET_TIME = 0x10,
+    CMD_SET_NTP = 0x11,
+    CMD_GET_NTP = 0x12,
+    CMD_GET_FIRST_FAULT = 0x20,
+    CMD_GET_NEXT_FAULT = 0x21,
+    CMD_CLEAR_FAULTS = 0x22,
+    CMD_GET_FAULT_RANGE = 0x23,     // [başlangıç(2), adet(2)] -> N x CMD_FAULT_RECORD + CMD_FAULT_RANGE_END
+    CMD_FAULT_RECORD = 0x24,        // [indeks(2), kayıt metni...]
+    CMD_FAULT_RANGE_END = 0x25,     // [gönderilen(2), toplam kayıt(2)]
+    CMD_FAULT_EVENT = 0x26,         // dsPIC -> ESP32, istek olmadan: [olay no(2), yaş ms(2), kayıt metni...]
+    CMD_SET_BAUDRATE = 0x30,
+    CMD_SET_LINK_RATE = 0x31,       // [hız(4)] -> ACK, ardından iki taraf yeni hıza geçer
+    CMD_COMMIT_LINK_RATE = 0x32,    // Yeni hızda doğrulama sonrası -> ACK
+    CMD_PING = 0x40,
+    CMD_GET_VERSION = 0x41,
+    CMD_RESET = 0x50,
+    CMD_GET_STATUS = 0x60,
+    CMD_LZSS_BLOCK = 0x70,          // Sıkıştırılmış yanıt bloğu (uart_lzss.h)
+    CMD_ACK = 0xA0,
+    CMD_NACK = 0xA1
+};
+
+// Hat üzerindeki frame biçimi - bağlantı başına el sıkışma ile seçilir.
+// COBS: 0x00 COBS(cmd [seq] lenH lenL data... checksum) 0x00 - içerik STX/ETX ile aynı,
+// sadece kaçış yerine sabit ek yükle sıfır byte'lar kodlanır.
+enum FrameEncoding {
+    FRAMING_STX_ETX = 0,
+    FRAMING_COBS = 1
+};
+
+// Frame checksum modu - bağlantı başına sürüm el sıkışması ile seçilir
+enum FrameChecksumMode {
+    CHECKSUM_XOR = 0,   // Protokol v1 - eski dsPIC firmware
+    CHECKSUM_CRC8 = 1   // Protokol v2+ - CRC-8 (poly 0x07), byte takası ve çift bit hatalarını yakalar
+};
+
+// Derleme zamanında üretilen CRC-8 tablosu (flash'ta)
+extern const uint8_t crc8Table[256];
+
+static inline uint8_t crc8Update(uint8_t crc, uint8_t value) {
+    return crc8Table[crc ^ value];
+}
+
+// Checksum fonksiyonları
+uint8_t calculateCRC8(const uint8_t* data, size_t length);
+uint8_t calculateXORChecksum(const uint8_t* data, size_t length);
+uint8_t calculateFrameChecksum(uint8_t command, uint16_t dataLength, const uint8_t* data,
+                               FrameChecksumMode mode = CHECKSUM_XOR, int sequence = FRAME_NO_SEQUENCE);
+
+// Frame'i escape'li olarak tek bir bitişik tampona yazar (STX ... ETX).
+// sequence >= 0 ise sıralı biçim kullanılır.
+// Yazılan byte sayısını, kapasite yetmezse 0 döndürür.
+size_t encodeFrame(uint8_t command, const uint8_t* data, uint16_t dataLength, uint8_t* out, size_t capacity,
+                   FrameChecksumMode mode = CHECKSUM_XOR, int sequence = FRAME_NO_SEQUENCE);
+size_t encodeFrame(const UARTFrame& frame, uint8_t* out, size_t capacity,
+                   FrameChecksumMode mode = CHECKSUM_XOR, int sequence = FRAME_NO_SEQUENCE);
+size_t encodeCOBSFrame(uint8_t command, const uint8_t* data, uint16_t dataLength, uint8_t* out, size_t capacity,
+                       FrameChecksumMode mode = CHECKSUM_XOR, int sequence = FRAME_NO_SEQUENCE);
+
+// İlk 0x00 byte'ının konumu (yoksa length) - 32 bit kelime kelime tarama
+size_t findCOBSDelimiter(const uint8_t* data, size_t length);
+
+// Tamamlanan her frame için çağrılır. false dönerse push() bu frame'den sonra durur.
+typedef bool (*FrameHandler)(const UARTFrame& frame, void* context);
+
+// Akış tabanlı frame çözücü - byte'lar geldikçe push() ile beslenir.
+// Checksum artımlı hesaplanır, ikinci bir kopya tampon tutulmaz.
+class FrameDecoder {
+public:
+    explicit FrameDecoder(FrameHandler handler = nullptr, void* context = nullptr);
+
+    void setHandler(FrameHandler handler, void* context);
+    void setChecksumMode(FrameChecksumMode mode);
+    FrameChecksumMode getChecksumMode() const { return checksumMode; }
+    void setSequenced(bool enabled);
+    bool isSequenced() const { return sequenced; }
+    void setFraming(FrameEncoding encoding);
+    FrameEncoding getFraming() const { return framing; }
+
+    // İşlenen byte sayısını döndürür (handler durdurmadıysa length)
+    size_t push(const uint8_t* data, size_t length);
+    void reset();
+    bool idle() const { return state == WAIT_START; }
+
+    uint32_t framesDecoded() const { return decodedCount; }
+    uint32_t checksumErrors() const { return checksumErrorCount; }
+    uint32_t framingErrors() const { return framingErrorCount; }
+
+private:
+    enum State {
+        WAIT_START,
+        READ_COMMAND,
+        READ_SEQUENCE,
+        READ_LENGTH_HIGH,
+        READ_LENGTH_LOW,
+        READ_DATA,
+        READ_CHECKSUM,
+        WAIT_END
+    };
+
+    bool processByte(uint8_t value, bool escaped);
+    bool completeFrame();
+    void startFrame();
+    size_t pushCOBS(const uint8_t* data, size_t length);
+    void consumeCOBSRun(const uint8_t* data, size_t length);
+    void feedDecoded(const uint8_t* data, size_t length);
+
+    inline void accumulate(uint8_t value) {
+        runningChecksum = (checksumMode == CHECKSUM_CRC8) ? crc8Update(runningChecksum, value)
+                                                          : (uint8_t)(runningChecksum ^ value);
+    }
+
+    FrameHandler handler;
+    void* context;
+    FrameChecksumMode checksumMode;
+    bool sequenced;
+    FrameEncoding framing;
+    State state;
+    bool escapeNext;
+    uint8_t cobsRemaining;          // Mevcut COBS bloğunda kalan veri byte'ı
+    bool cobsZeroPending;           // Sonraki blok başında çözülmüş 0x00 eklenecek
+    uint16_t dataIndex;
+    uint8_t runningChecksum;
+    uint32_t decodedCount;
+    uint32_t checksumErrorCount;
+    uint32_t framingErrorCount;
+    UARTFrame frame;
+};
+
+#endif // UART_FRAME_H
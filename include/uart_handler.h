@@ -2,20 +2,27 @@
 #define UART_HANDLER_H
 
 #include <Arduino.h>
+#include "uart_arbiter.h"
+
+// Eski metin protokolü arıza komutları
+#define FAULT_COMMAND_FIRST     "12345v"
+#define FAULT_COMMAND_NEXT      "n"
+#define FAULT_RESPONSE_TIMEOUT  1000
 
 void initUART();
 bool changeBaudRate(long newBaudRate);
 bool sendBaudRateCommand(long baudRate); // dsPIC33EP için
-bool requestFirstFault();
-bool requestNextFault();
-String getLastFaultResponse();
+bool requestFirstFault(String& record);
+bool requestNextFault(String& record);
 
 // Yardımcı fonksiyonlar
 void checkUARTHealth();
+size_t readUARTLine(char* buffer, size_t capacity, unsigned long timeout); // Sadece owner task
 String safeReadUARTResponse(unsigned long timeout);
 void updateUARTStats(bool success);
 String getUARTStatus();
-bool sendCustomCommand(const String& command, String& response, unsigned long timeout = 0);
+bool sendCustomCommand(const String& command, String& response, unsigned long timeout = 0,
+                       UARTPriority priority = UART_PRIORITY_NORMAL);
 bool testUARTConnection();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef UART_LINK_H
+#define UART_LINK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// dsPIC bağlantısı - ESP-IDF UART driver üzerinde olay tabanlı alım
+#define UART_LINK_PORT          2       // UART_NUM_2 (eski Serial2)
+#define UART_RX_RING_SIZE       2048    // 2'nin kuvveti olmalı
+#define UART_DRIVER_RX_BUFFER   1024
+#define UART_DRIVER_TX_BUFFER   2048    // En büyük escape'li frame'i (1036 byte) bloklamadan alır
+#define UART_DRIVER_EVENT_QUEUE 20
+#define UART_RX_TASK_STACK      2048
+#define UART_RX_TASK_PRIORITY   5       // uartTask (2) ve systemTask (1) üzerinde
+#define UART_RX_TASK_CORE       1
+
+// Alım yolu sayaçları (sadece RX task yazar)
+struct UARTLinkStats {
+    unsigned long bytesReceived;
+    unsigned long bytesSent;
+    unsigned long ringOverflows;    // Halka dolu, byte atıldı
+    unsigned long fifoOverflows;    // Driver FIFO/buffer taşması
+    unsigned long lineErrors;       // Frame/parity hataları
+};
+
+extern UARTLinkStats uartLinkStats;
+
+// Başlatma - ilk çağrıda driver ve RX task kurulur, sonrakilerde yeniden yapılandırılır
+bool initUARTLink(long baudRate, int rxPin, int txPin);
+// Gönderim bitince hızı değiştirir ve alım tamponlarını temizler
+bool uartLinkSetBaudRate(long baudRate);
+bool uartLinkReady();
+
+// Alım (tek tüketici)
+size_t uartLinkAvailable();
+bool uartLinkWaitForData(unsigned long timeoutMs);
+int uartLinkReadByte(unsigned long timeoutMs);
+size_t uartLinkRead(uint8_t* buffer, size_t maxLength);
+size_t uartLinkPeek(const uint8_t** data);
+void uartLinkConsume(size_t length);
+void uartLinkFlushInput();
+// Veri geldiğinde ek olarak bu task'a bildirim (xTaskNotifyGive) gönderilir
+void uartLinkSetDataNotify(TaskHandle_t task);
+
+// Gönderim
+size_t uartLinkWrite(const uint8_t* data, size_t length);
+size_t uartLinkPrintln(const String& line);
+bool uartLinkWaitTxDone(unsigned long timeoutMs);
+bool uartLinkTxIdle();
+
+#endif // UART_LINK_H
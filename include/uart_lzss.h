@@ -0,0 +1,99 @@
+#ifndef UART_LZSS_H
+#define UART_LZSS_H
+
+// Sıkıştırılmış bulk yanıtlar için heatshrink uyumlu LZSS çözücü.
+// Arduino bağımlılığı yok - uart_frame gibi host derlemesinde de çalışır.
+//
+// Bit akışı (MSB önce): 1 + 8 bit literal | 0 + index(W bit) + adet(L bit)
+// index+1 byte geriden adet+1 byte kopyalanır. Pencere küçük tutuldu, dsPIC
+// tarafında kodlayıcı 256 byte pencere + arama tablosu ile çalışabilir.
+#include <stdint.h>
+#include <stddef.h>
+#include "uart_frame.h"
+
+#define LZSS_WINDOW_BITS        8
+#define LZSS_LOOKAHEAD_BITS     4
+#define LZSS_WINDOW_SIZE        (1 << LZSS_WINDOW_BITS)
+#define LZSS_OUTPUT_CHUNK       64      // Tüketiciye verilen en büyük parça
+
+// Sıkıştırılmış yanıt bloğu: CMD_LZSS_BLOCK [bayraklar(1), sıkıştırılmış byte'lar...]
+// Açılmış akış ardışık iç kayıtlardan oluşur: [cmd(1), lenH, lenL, data...]
+#define LZSS_BLOCK_LAST         0x01    // Akışın son bloğu
+
+// İstek komutunda bu bit: "yanıtı sıkıştırabilirsin" (komut başına seçilir)
+#define CMD_FLAG_COMPRESS       0x80
+
+typedef void (*LZSSOutput)(const uint8_t* data, size_t length, void* context);
+
+class LZSSDecoder {
+public:
+    LZSSDecoder();
+
+    void reset();
+    // Sıkıştırılmış byte'ları çözer, çıktı en fazla LZSS_OUTPUT_CHUNK'lık parçalarla verilir.
+    // Girdi herhangi bir noktada bölünebilir.
+    void push(const uint8_t* data, size_t length, LZSSOutput output, void* context);
+
+    uint32_t bytesIn() const { return inCount; }
+    uint32_t bytesOut() const { return outCount; }
+
+private:
+    enum State {
+        READ_TAG,
+        READ_LITERAL,
+        READ_INDEX,
+        READ_COUNT
+    };
+
+    bool takeBits(uint8_t count, uint16_t& value);
+    void emit(uint8_t value, LZSSOutput output, void* context);
+    void flush(LZSSOutput output, void* context);
+
+    uint8_t window[LZSS_WINDOW_SIZE];
+    uint16_t windowHead;
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+    State state;
+    uint16_t backrefIndex;
+    uint8_t staging[LZSS_OUTPUT_CHUNK];
+    uint8_t stagingLength;
+    uint32_t inCount;
+    uint32_t outCount;
+};
+
+// Açılmış akışı iç kayıtlara ayırıp her biri için FrameHandler çağırır.
+// Tüm yanıt bellekte tutulmaz; sadece o anki kayıt (en fazla MAX_FRAME_SIZE).
+class CompressedFrameReader {
+public:
+    explicit CompressedFrameReader(FrameHandler handler = nullptr, void* context = nullptr);
+
+    void begin(FrameHandler handler, void* context);
+    // CMD_LZSS_BLOCK verisi (bayrak byte'ı dahil). Akış bitince true.
+    bool pushBlock(const uint8_t* data, size_t length);
+    bool failed() const { return malformed; }
+
+    uint32_t bytesIn() const { return decoder.bytesIn(); }
+    uint32_t bytesOut() const { return decoder.bytesOut(); }
+
+private:
+    static void onOutput(const uint8_t* data, size_t length, void* context);
+    void consume(const uint8_t* data, size_t length);
+
+    enum State {
+        READ_COMMAND,
+        READ_LENGTH_HIGH,
+        READ_LENGTH_LOW,
+        READ_DATA
+    };
+
+    LZSSDecoder decoder;
+    FrameHandler handler;
+    void* context;
+    State state;
+    uint16_t dataIndex;
+    bool malformed;
+    bool stopped;                   // Handler false döndü - kalan kayıtlar atılır
+    UARTFrame frame;
+};
+
+#endif // UART_LZSS_H
@@ -2,36 +2,57 @@
 #define UART_PROTOCOL_H
 
 #include <Arduino.h>
+#include "uart_frame.h"
+#include "uart_arbiter.h"
 
-// UART Protocol definitions
-#define FRAME_START_CHAR    0x02  // STX
-#define FRAME_END_CHAR      0x03  // ETX
-#define FRAME_ESCAPE_CHAR   0x1B  // ESC
-#define MAX_FRAME_SIZE      512
-#define FRAME_TIMEOUT       2000
+// Protokol sürümü - dsPIC ile CMD_GET_VERSION el sıkışması ile anlaşılır.
+// Eski firmware yanıt vermez/NACK döner ve bağlantı v1 (XOR) olarak kalır.
+#define UART_PROTOCOL_VERSION   3
+#define VERSION_TIMEOUT         1000
 
-// Frame structure
-struct UARTFrame {
-    uint8_t command;
-    uint16_t dataLength;
-    uint8_t data[MAX_FRAME_SIZE];
-    uint8_t checksum;
+// Yetenek bitleri (el sıkışmada karşılıklı AND'lenir)
+enum UARTCapabilities {
+    CAP_CRC8 = 0x01,
+    CAP_FAULT_RANGE = 0x02,         // CMD_GET_FAULT_RANGE toplu aktarım
+    CAP_SEQUENCE = 0x04,            // Sıra numaralı frame + boru hattı (pipelining)
+    CAP_FAULT_EVENT = 0x08,         // dsPIC yeni arızayı CMD_FAULT_EVENT ile kendiliğinden bildirir
+    CAP_LINK_RATE = 0x10,           // CMD_SET_LINK_RATE ile 115200 üstü hız anlaşması
+    CAP_COBS = 0x20,                // STX/ETX kaçış yerine COBS frame biçimi
+    CAP_LZSS = 0x40                 // CMD_FLAG_COMPRESS istenen yanıtlar LZSS ile sıkıştırılabilir
 };
 
-// Command codes
-enum UARTCommands {
-    CMD_GET_TIME = 0x10,
-    CMD_SET_NTP = 0x11,
-    CMD_GET_NTP = 0x12,
-    CMD_GET_FIRST_FAULT = 0x20,
-    CMD_GET_NEXT_FAULT = 0x21,
-    CMD_CLEAR_FAULTS = 0x22,
-    CMD_SET_BAUDRATE = 0x30,
-    CMD_PING = 0x40,
-    CMD_RESET = 0x50,
-    CMD_GET_STATUS = 0x60,
-    CMD_ACK = 0xA0,
-    CMD_NACK = 0xA1
+// COBS frame biçimi teklif edilsin mi (derleme bayrağı). İkili veride kaçışlı STX/ETX
+// frame'i iki katına çıkabilir, COBS'un ek yükü her 254 byte için 1 byte'tır.
+#ifndef UART_PREFER_COBS
+#define UART_PREFER_COBS        1
+#endif
+
+#if UART_PREFER_COBS
+#define UART_FRAMING_CAPABILITIES   CAP_COBS
+#else
+#define UART_FRAMING_CAPABILITIES   0
+#endif
+
+#define UART_LOCAL_CAPABILITIES (CAP_CRC8 | CAP_FAULT_RANGE | CAP_SEQUENCE | CAP_FAULT_EVENT | CAP_LINK_RATE | \
+                                 UART_FRAMING_CAPABILITIES | CAP_LZSS)
+
+// Sıralı modda NACK verisi [neden]. CHECKSUM: istek bozuk geldi, aynı sıra ile yeniden gönder.
+// dsPIC aynı sıra numarasıyla tekrar gelen isteği yeniden çalıştırmaz, son yanıtı tekrarlar.
+#define NACK_REASON_CHECKSUM    0x01
+
+// Toplu arıza aktarımı - tek istekte en fazla kayıt ve frame'ler arası bekleme
+#define FAULT_RANGE_MAX_COUNT       100
+#define FAULT_RANGE_FRAME_TIMEOUT   2000
+
+// Bağlantı başına anlaşılan protokol durumu
+struct UARTLinkProtocol {
+    uint8_t peerVersion;            // 1 = el sıkışma desteklenmiyor
+    uint8_t capabilities;
+    FrameChecksumMode checksumMode;
+    FrameEncoding framing;          // CAP_COBS: COBS, aksi halde STX/ETX
+    bool negotiated;                // false ise owner task yeniden el sıkışır
+    bool sequenced;                 // CAP_SEQUENCE: frame'ler sıra numarası taşır
+    uint8_t window;                 // Aynı anda bekleyen en fazla istek (1 = dur-bekle)
 };
 
 // Statistics structure
@@ -46,22 +67,41 @@ struct UARTStatistics {
 
 // Global variables
 extern UARTStatistics uartStats;
-extern String lastResponse;
 extern bool uartHealthy;
+extern UARTLinkProtocol linkProtocol;
+
+// El sıkışmada karşılıklı anlaşılan yetenek
+static inline bool peerSupports(uint8_t capability) {
+    return linkProtocol.negotiated && (linkProtocol.capabilities & capability);
+}
 
 // Function declarations
-uint8_t calculateCRC8(const uint8_t* data, size_t length);
-uint8_t calculateXORChecksum(const uint8_t* data, size_t length);
+// sendFrame/sendCommandFrame/receiveFrame/negotiateProtocolVersion hattı doğrudan kullanır -
+// sadece UART owner task'ından çağrılır. Diğer task'lar *WithProtocol fonksiyonlarını kullanır.
 bool createFrame(UARTFrame& frame, uint8_t command, const uint8_t* data, uint16_t dataLength);
 bool sendFrame(const UARTFrame& frame);
+bool sendCommandFrame(uint8_t command, const uint8_t* data, uint16_t dataLength);
 bool receiveFrame(UARTFrame& frame, unsigned long timeout);
-bool sendCommandWithProtocol(uint8_t command, const String& data, String& response, unsigned long timeout);
-bool requestTimeWithProtocol();
+// Boru hattı: giriş temizlenmeden verilen sıra ile gönderir; halkadaki byte'ları bloklamadan çözer.
+// pumpReceivedFrames bu çağrıda oluşan checksum hatası sayısını döndürür.
+uint8_t nextFrameSequence();
+bool sendSequencedFrame(uint8_t command, uint8_t sequence, const uint8_t* data, uint16_t dataLength);
+// CMD_FAULT_EVENT frame'leri her iki yolda da yanıtlardan ayrılıp fault_events'e verilir.
+// handler NULL ise diğer frame'ler atılır (boşta bekleyen olayları toplamak için).
+uint32_t pumpReceivedFrames(FrameHandler handler, void* context);
+// Girişi temizle - halkada tamamlanmış olay frame'leri varsa önce teslim edilir
+void flushLinkInput();
+// compressReply: büyük yanıtlı komutlar için dsPIC'e sıkıştırma izni (CAP_LZSS varsa).
+// Tek kayıtlık yanıtlarda LZSS blok ek yüküyle hat üzerinde büyür; sadece toplu aktarımlar ister.
+bool sendCommandWithProtocol(uint8_t command, const String& data, String& response, unsigned long timeout,
+                             UARTPriority priority = UART_PRIORITY_NORMAL, bool compressReply = false);
+bool requestTimeWithProtocol(String& timeResponse);
 bool sendNTPConfigWithProtocol(const String& server1, const String& server2);
-bool requestFirstFaultWithProtocol();
-bool requestNextFaultWithProtocol();
+bool requestFirstFaultWithProtocol(String& record);
+bool requestNextFaultWithProtocol(String& record);
+bool negotiateProtocolVersion();
+void resetLinkProtocol();
 bool pingBackend();
-void checkUARTHealthWithProtocol();
 void updateUARTStatistics(bool success, bool checksumError = false, bool timeoutError = false);
 String getUARTStatisticsJSON();
 
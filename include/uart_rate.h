@@ -0,0 +1,48 @@
+#ifndef UART_RATE_H
+#define UART_RATE_H
+
+#include <Arduino.h>
+
+// dsPIC bağlantı hızı anlaşması (CAP_LINK_RATE). Açılışta settings.currentBaudRate
+// (temel hız) ile başlanır, owner task daha yüksek hızları dener.
+//
+// Geçiş sırası:
+//   1. ESP32 -> CMD_SET_LINK_RATE [hız(4)] eski hızda, dsPIC ACK verir (desteklemiyorsa NACK)
+//   2. ACK hattan çıktıktan sonra iki taraf da yeni hıza geçer
+//   3. ESP32 yeni hızda CMD_PING grubu gönderir, hepsi (en fazla 1 hata) yanıtlanmalı
+//   4. ESP32 -> CMD_COMMIT_LINK_RATE, dsPIC ACK verir ve yeni hızı kalıcı yapar
+// dsPIC, LINK_RATE_REVERT_MS içinde commit almazsa önceki hıza döner. Temel hızın
+// üstündeyken LINK_RATE_SILENCE_MS boyunca geçerli frame almazsa temel hıza döner.
+#define LINK_RATE_NVS_NAMESPACE     "uart-link"
+#define LINK_RATE_SETTLE_MS         20      // ACK'ten sonra hız değişimi için bekleme
+#define LINK_RATE_PING_BURST        16
+#define LINK_RATE_PING_TIMEOUT      100
+#define LINK_RATE_MAX_BURST_ERRORS  1
+#define LINK_RATE_REVERT_MS         1500    // dsPIC commit bekleme süresi
+#define LINK_RATE_SILENCE_MS        3000    // dsPIC sessizlikte temel hıza dönme süresi
+#define LINK_RATE_ERROR_WINDOW      64      // Çalışma sırasında hata oranı örnek sayısı
+#define LINK_RATE_MAX_ERROR_PERCENT 5       // Bu oranı aşınca bir alt hıza inilir
+#define LINK_RATE_CAP_NEGOTIATIONS  3       // Geri düşülen hız bu kadar anlaşma boyunca üst sınırdır
+#define LINK_RATE_REPROBE_MS        3600000UL   // Sınır varken çalışma sırasında yeniden anlaşma aralığı
+
+struct LinkRateState {
+    long baseRate;                  // settings.currentBaudRate (dsPIC açılış hızı)
+    long currentRate;
+    long storedRate;                // NVS'te kayıtlı son başarılı hız (0: yok)
+    bool negotiated;                // false ise owner task hız anlaşması yapar
+    unsigned long fallbacks;        // Hata oranı nedeniyle hız düşürme sayısı
+    long ceilingRate;               // Geri düşme sonrası üst sınır (0: yok) - NVS'te
+    uint8_t ceilingLeft;            // Sınırın geçerli kalacağı anlaşma sayısı - NVS'te
+    unsigned long negotiatedAt;     // Son anlaşma ya da geri düşme zamanı (millis)
+};
+
+extern LinkRateState linkRate;
+
+// initUART'tan çağrılır - hat temel hızda, anlaşma yeniden yapılacak
+void resetLinkRate(long baseRate);
+
+// Sadece owner task (hattı doğrudan kullanır)
+bool negotiateLinkRate();
+void checkLinkRateHealth();
+
+#endif // UART_RATE_H
@@ -0,0 +1,46 @@
+#ifndef UART_STATS_H
+#define UART_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "uart_arbiter.h"
+
+// Komut başına gecikme histogramları, byte sayaçları ve kayan pencere hata oranları.
+// Sadece owner task yazar (işlem tamamlanırken, O(1)); web task okur. Okumada
+// 32 bit sayaçlar tutarlı, histogram anlık görüntüsü bir iki örnek kayabilir.
+#define UART_STATS_MAX_COMMANDS     12      // Ayrı izlenen komut; son satır "diğer" için ayrılır
+#define UART_STATS_BUCKETS          16      // Log2 ms kovaları: 0, 1, 2-3, 4-7 ... >= 16384
+#define UART_STATS_SLOT_MS          10000   // Kayan pencere çözünürlüğü
+#define UART_STATS_SLOTS            360     // 60 dakika
+#define UART_STATS_BROADCAST_MS     5000    // WebSocket "uart_stats" konusu aralığı
+
+// Metin komutları ve tabloya sığmayanlar için komut kodu yerine kullanılır
+#define UART_STATS_TEXT_COMMAND     0x00
+#define UART_STATS_OTHER_COMMAND    0xFF
+
+struct UARTLatencyHistogram {
+    uint32_t buckets[UART_STATS_BUCKETS];
+    uint32_t count;
+    uint32_t totalMs;
+    uint32_t maxMs;
+};
+
+struct UARTCommandStats {
+    uint8_t command;
+    uint32_t ok;
+    uint32_t errors;                // TIMEOUT / NACK / ERROR
+    uint32_t timeouts;
+    uint32_t expired;               // Kuyrukta süresi doldu - hatta hiç gitmedi
+    uint32_t retries;               // Pencerede yeniden gönderim
+    uint32_t bytesOut;              // İstek verisi (yeniden gönderimler dahil)
+    uint32_t bytesIn;               // Yanıt verisi (akışta tüm frame'ler, açılmış hali)
+    UARTLatencyHistogram latency;   // Hatta geçen süre: gönderim -> tamamlanma
+};
+
+// Owner task - completeTransaction içinden
+void recordUARTTransaction(const UARTTransaction& transaction);
+
+// /api/uart/stats ve WebSocket konusu için getUARTStatisticsJSON'a eklenir
+void fillUARTStatsJSON(JsonDocument& doc);
+
+#endif // UART_STATS_H
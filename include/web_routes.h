@@ -14,12 +14,21 @@ void handleStatusAPI();
 void handleGetSettingsAPI();
 void handlePostSettingsAPI();
 void handleFaultRequest(bool isFirst);
+void handleFaultRangeRequest();
+void handleFaultJobAPI();
+void handleFaultEventStatsAPI();
+void handleStoredFaultsAPI();
+void handleFaultStoreStatsAPI();
+void handleFaultQueryAPI();
+void handleUARTStatsAPI();
 void handleGetNtpAPI();
 void handlePostNtpAPI();
 void handleGetBaudRateAPI();
 void handlePostBaudRateAPI();
 void handleGetLogsAPI();
 void handleClearLogsAPI();
+void handleLogConsoleAPI();
+void handleLogLevelsAPI();
 void handleSystemInfoAPI();
 void handleSessionRefresh();
 
@@ -25,7 +25,15 @@ void initWebSocket();
 void handleWebSocket();
 void broadcastLog(const String& message, const String& level, const String& source);
 void broadcastStatus();
-void broadcastFault(const String& faultData);
+// Abone client'lara periyodik UART istatistikleri - web task döngüsünden çağrılır
+void broadcastUARTStats();
+// eventId >= 0: dsPIC'in kendiliğinden bildirdiği arıza olayı (gecikme ile)
+// recordJson: ayrıştırılmış kayıt (faultRecordToJSON), metin ayrıştırılamadıysa NULL
+void broadcastFault(const String& faultData, int eventId = -1, unsigned long latencyMs = 0,
+                    const char* recordJson = NULL);
+void sendFaultResult(int clientNum, uint32_t jobId, const char* status, const String& faultData,
+                     const char* recordJson = NULL);
+void sendJobResult(int clientNum, String& message);
 void sendToClient(uint8_t clientNum, const String& message);
 void sendToAllClients(const String& message);
 bool isWebSocketConnected();
@@ -17,7 +17,7 @@ bool checkSession() {
     if (!settings.isLoggedIn) return false;
     if (millis() - settings.sessionStartTime > settings.SESSION_TIMEOUT) {
         settings.isLoggedIn = false;
-        addLog("Oturum zaman aşımı", INFO, "AUTH");
+        LOG_INFO("AUTH", "Oturum zaman aşımı");
         return false;
     }
     return true;
@@ -27,7 +27,7 @@ void handleUserLogin() {
     // Rate limiting kontrolü
     if (lockoutTime > 0 && millis() < lockoutTime) {
         unsigned long remainingTime = (lockoutTime - millis()) / 1000;
-        addLog("Çok fazla başarısız giriş denemesi. Kalan süre: " + String(remainingTime) + "s", WARN, "AUTH");
+        LOG_WARN("AUTH", "Çok fazla başarısız giriş denemesi. Kalan süre: %lus", remainingTime);
         server.send(429, "application/json", 
             "{\"error\":\"Çok fazla başarısız deneme. " + String(remainingTime) + " saniye sonra tekrar deneyin.\"}");
         return;
@@ -44,7 +44,7 @@ void handleUserLogin() {
 
     // Kullanıcı adı ve şifre uzunluk kontrolü
     if (u.length() > 50 || p.length() > 100) {
-        addLog("Aşırı uzun giriş denemesi", WARN, "AUTH");
+        LOG_WARN("AUTH", "Aşırı uzun giriş denemesi");
         server.send(400, "application/json", "{\"error\":\"Geçersiz giriş bilgileri.\"}");
         return;
     }
@@ -57,7 +57,7 @@ void handleUserLogin() {
             loginAttempts = 0;
             lockoutTime = 0;
             
-            addLog("✅ Başarılı giriş: " + u, SUCCESS, "AUTH");
+            LOG_SUCCESS("AUTH", "✅ Başarılı giriş: %s", u.c_str());
             server.sendHeader("Location", "/", true);
             server.send(302, "text/plain", "Redirecting to dashboard..."); // İçerik eklendi
             return;
@@ -66,12 +66,12 @@ void handleUserLogin() {
 
     // Başarısız giriş işlemi
     loginAttempts++;
-    addLog("❌ Başarısız giriş denemesi (#" + String(loginAttempts) + "): " + u, ERROR, "AUTH");
+    LOG_ERROR("AUTH", "❌ Başarısız giriş denemesi (#%d): %s", loginAttempts, u.c_str());
 
     // Maksimum deneme sayısına ulaşıldı mı?
     if (loginAttempts >= MAX_LOGIN_ATTEMPTS) {
         lockoutTime = millis() + LOCKOUT_DURATION;
-        addLog("🔒 IP adresi " + String(LOCKOUT_DURATION/1000) + " saniye kilitlendi", WARN, "AUTH");
+        LOG_WARN("AUTH", "🔒 IP adresi %lu saniye kilitlendi", LOCKOUT_DURATION/1000);
         server.send(429, "application/json", 
             "{\"error\":\"Çok fazla başarısız deneme. " + String(LOCKOUT_DURATION/1000) + " saniye sonra tekrar deneyin.\"}");
         return;
@@ -83,7 +83,7 @@ void handleUserLogin() {
 void handleUserLogout() {
     if (settings.isLoggedIn) {
         settings.isLoggedIn = false;
-        addLog("🚪 Çıkış yapıldı", INFO, "AUTH");
+        LOG_INFO("AUTH", "🚪 Çıkış yapıldı");
     }
     server.sendHeader("Location", "/login", true);
     server.send(302, "text/plain", "Redirecting to login..."); // İçerik eklendi
@@ -4,6 +4,7 @@
 #include <Preferences.h>
 #include "settings.h"
 #include "log_system.h"
+#include "log_store.h"
 #include "ntp_handler.h"
 #include "crypto_utils.h"
 #include "auth_system.h"
@@ -47,8 +48,8 @@ String exportSettingsToJSON() {  // "tring" -> "String" düzeltildi
     
     // Log ayarları - YENİ JSON API
     JsonObject logging = doc["logging"].to<JsonObject>();
-    logging["maxLogs"] = 50;
-    logging["currentLogs"] = totalLogs;
+    logging["maxLogs"] = LOG_RING_SIZE;
+    logging["currentLogs"] = getLogCount();
     
     // Sistem bilgileri - YENİ JSON API
     JsonObject system = doc["system"].to<JsonObject>();
@@ -61,7 +62,7 @@ String exportSettingsToJSON() {  // "tring" -> "String" düzeltildi
     String output;
     serializeJsonPretty(doc, output);
     
-    addLog("✅ Ayarlar JSON formatında export edildi", SUCCESS, "BACKUP");
+    LOG_SUCCESS("BACKUP", "✅ Ayarlar JSON formatında export edildi");
     return output;
 }
 
@@ -71,19 +72,19 @@ bool importSettingsFromJSON(const String& jsonData) {
     DeserializationError error = deserializeJson(doc, jsonData);
     
     if (error) {
-        addLog("❌ JSON parse hatası: " + String(error.c_str()), ERROR, "RESTORE");
+        LOG_ERROR("RESTORE", "❌ JSON parse hatası: %s", error.c_str());
         return false;
     }
     
     // Versiyon kontrolü
     String version = doc["version"] | "unknown";
     if (version != "1.0") {
-        addLog("⚠️ Uyumsuz backup versiyonu: " + version, WARN, "RESTORE");
+        LOG_WARN("RESTORE", "⚠️ Uyumsuz backup versiyonu: %s", version.c_str());
     }
     
     Preferences prefs;
     if (!prefs.begin("app-settings", false)) {
-        addLog("❌ Preferences açılamadı", ERROR, "RESTORE");
+        LOG_ERROR("RESTORE", "❌ Preferences açılamadı");
         return false;
     }
     
@@ -172,8 +173,8 @@ bool importSettingsFromJSON(const String& jsonData) {
         
         prefs.end();
     
-        addLog("✅ Ayarlar başarıyla import edildi", SUCCESS, "RESTORE");
-        addLog("⚠️ Yeniden başlatma gerekli", WARN, "RESTORE");
+        LOG_SUCCESS("RESTORE", "✅ Ayarlar başarıyla import edildi");
+        LOG_WARN("RESTORE", "⚠️ Yeniden başlatma gerekli");
     
         return true;
 }
@@ -184,14 +185,14 @@ bool saveBackupToFile(const String& filename) {
     
     File file = LittleFS.open("/" + filename, "w");
     if (!file) {
-        addLog("❌ Backup dosyası oluşturulamadı: " + filename, ERROR, "BACKUP");
+        LOG_ERROR("BACKUP", "❌ Backup dosyası oluşturulamadı: %s", filename.c_str());
         return false;
     }
     
     file.print(jsonBackup);
     file.close();
     
-    addLog("✅ Backup dosyası kaydedildi: " + filename, SUCCESS, "BACKUP");
+    LOG_SUCCESS("BACKUP", "✅ Backup dosyası kaydedildi: %s", filename.c_str());
     return true;
 }
 
@@ -199,7 +200,7 @@ bool saveBackupToFile(const String& filename) {
 bool loadBackupFromFile(const String& filename) {
     File file = LittleFS.open("/" + filename, "r");
     if (!file) {
-        addLog("❌ Backup dosyası bulunamadı: " + filename, ERROR, "RESTORE");
+        LOG_ERROR("RESTORE", "❌ Backup dosyası bulunamadı: %s", filename.c_str());
         return false;
     }
     
@@ -225,7 +226,7 @@ void handleBackupDownload() {
     
     server.send(200, "application/json", jsonBackup);
     
-    addLog("📥 Backup indirildi", INFO, "BACKUP");
+    LOG_INFO("BACKUP", "📥 Backup indirildi");
 }
 
 // Web API handler - Backup yükle
@@ -240,7 +241,7 @@ void handleBackupUpload() {
     
     if (upload.status == UPLOAD_FILE_START) {
         uploadedData = "";
-        addLog("📤 Backup yükleme başladı: " + upload.filename, INFO, "RESTORE");
+        LOG_INFO("RESTORE", "📤 Backup yükleme başladı: %s", upload.filename.c_str());
         
     } else if (upload.status == UPLOAD_FILE_WRITE) {
         for (size_t i = 0; i < upload.currentSize; i++) {
@@ -250,6 +251,7 @@ void handleBackupUpload() {
     } else if (upload.status == UPLOAD_FILE_END) {
         if (importSettingsFromJSON(uploadedData)) {
             server.send(200, "text/plain", "Backup successfully restored. Device will restart.");
+            flushLogStore();
             delay(2000);
             ESP.restart();
         } else {
@@ -291,13 +293,13 @@ void createAutomaticBackup() {
         // 7'den fazla backup varsa en eskisini sil
         if (backupCount >= 7 && oldestBackup != "") {
             LittleFS.remove("/" + oldestBackup);
-            addLog("🗑️ Eski backup silindi: " + oldestBackup, INFO, "BACKUP");
+            LOG_INFO("BACKUP", "🗑️ Eski backup silindi: %s", oldestBackup.c_str());
         }
         
         // Yeni backup oluştur
         if (saveBackupToFile(filename)) {
             lastBackup = millis();
-            addLog("💾 Otomatik backup oluşturuldu", SUCCESS, "BACKUP");
+            LOG_SUCCESS("BACKUP", "💾 Otomatik backup oluşturuldu");
         }
     }
 }
\ No newline at end of file
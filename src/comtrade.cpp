@@ -0,0 +1,180 @@
+// comtrade.cpp - IEEE C37.111-1999 .cfg/.dat üretimi (ASCII ve ikili)
+#include "comtrade.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COMTRADE_SAMPLE_LIMIT       32767
+#define COMTRADE_MISSING_BINARY     ((int16_t)0x8000)
+
+// ==================== YARDIMCI ====================
+
+namespace {
+
+// Taşma olursa used kapasiteyi geçer ve sonuç 0 döner
+struct ComtradeText {
+    char* out;
+    size_t capacity;
+    size_t used;
+
+    void append(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+void ComtradeText::append(const char* format, ...) {
+    if (used >= capacity) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(out + used, capacity - used, format, args);
+    va_end(args);
+    used += written < 0 ? capacity : (size_t)written;
+}
+
+}  // namespace
+
+// İlk örneğe göre µs
+static int64_t sampleOffset(const ComtradeLayout& layout, uint32_t timestamp, uint16_t millis) {
+    return ((int64_t)timestamp - layout.firstTime) * 1000000LL + ((int32_t)millis - layout.firstMillis) * 1000LL;
+}
+
+// x100 değer -> 16 bit örnek (kanalın en büyük genliği ±32767'ye oturur)
+static int16_t scaleSample(const ComtradeLayout& layout, uint8_t channel, int32_t value) {
+    uint32_t magnitude = layout.maxMagnitude[channel];
+    if (magnitude == 0) {
+        return 0;
+    }
+    int64_t scaled = (int64_t)value * COMTRADE_SAMPLE_LIMIT;
+    scaled += scaled < 0 ? -(int64_t)(magnitude / 2) : (int64_t)(magnitude / 2);
+    return (int16_t)(scaled / (int64_t)magnitude);
+}
+
+// Ad alanları virgül ve satır sonu içeremez
+static void appendName(ComtradeText& text, const char* name) {
+    char clean[65];
+    size_t length = 0;
+    for (; name && *name && length < sizeof(clean) - 1; name++) {
+        if (*name != ',' && *name != '\r' && *name != '\n') {
+            clean[length++] = *name;
+        }
+    }
+    clean[length] = '\0';
+    text.append("%s", clean);
+}
+
+// dd/mm/yyyy,hh:mm:ss.ssssss
+static void appendDate(ComtradeText& text, uint32_t timestamp, uint16_t millis) {
+    char digits[13];
+    faultTimestampToDigits(timestamp, digits);
+    text.append("%.2s/%.2s/20%.2s,%.2s:%.2s:%.2s.%03u000\r\n",
+                digits, digits + 2, digits + 4, digits + 6, digits + 8, digits + 10, millis);
+}
+
+// ==================== ÖN GEÇİŞ ====================
+
+void comtradeBegin(ComtradeLayout& layout) {
+    memset(&layout, 0, sizeof(layout));
+    layout.timeMultiplier = 1;
+}
+
+void comtradeAddSample(ComtradeLayout& layout, const FaultRecord& record) {
+    // Depo kayıtları id sırasında verir; dsPIC saati geri gitmişse en eski/en yeni ilk/son değildir
+    int64_t offset = sampleOffset(layout, record.timestamp, record.millis);
+    if (layout.samples == 0 || offset < 0) {
+        layout.firstTime = record.timestamp;
+        layout.firstMillis = record.millis;
+    }
+    if (layout.samples == 0 || offset > sampleOffset(layout, layout.lastTime, layout.lastMillis)) {
+        layout.lastTime = record.timestamp;
+        layout.lastMillis = record.millis;
+    }
+    layout.samples++;
+
+    for (uint8_t i = 0; i < record.valueCount && i < COMTRADE_ANALOG_CHANNELS; i++) {
+        int32_t value = record.values[i];
+        uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+        if (magnitude > layout.maxMagnitude[i]) {
+            layout.maxMagnitude[i] = magnitude;
+        }
+    }
+}
+
+void comtradeFinish(ComtradeLayout& layout) {
+    // .dat zaman alanı 32 bit - uzun aralıklarda birim büyütülür (µs, 10µs, ... )
+    int64_t span = sampleOffset(layout, layout.lastTime, layout.lastMillis);
+    layout.timeMultiplier = 1;
+    while (span / layout.timeMultiplier > 0xFFFFFFFELL) {
+        layout.timeMultiplier *= 10;
+    }
+}
+
+// ==================== ÇIKTI ====================
+
+size_t comtradeConfig(const ComtradeLayout& layout, const char* station, const char* device,
+                      bool binary, char* out, size_t capacity) {
+    if (capacity == 0) return 0;
+    ComtradeText text = {out, capacity, 0};
+
+    appendName(text, station);
+    text.append(",");
+    appendName(text, device);
+    text.append(",1999\r\n");
+    text.append("%u,%uA,0D\r\n", COMTRADE_ANALOG_CHANNELS, COMTRADE_ANALOG_CHANNELS);
+
+    // An,ch_id,ph,ccbm,uu,a,b,skew,min,max,primary,secondary,PS - gerçek değer = a * örnek
+    for (uint8_t i = 0; i < COMTRADE_ANALOG_CHANNELS; i++) {
+        double multiplier = layout.maxMagnitude[i] == 0 ? 1.0 / FAULT_RECORD_VALUE_SCALE :
+            (double)layout.maxMagnitude[i] / ((double)FAULT_RECORD_VALUE_SCALE * COMTRADE_SAMPLE_LIMIT);
+        text.append("%u,V%u,,,,%.9g,0,0,%d,%d,1,1,P\r\n",
+                    i + 1, i + 1, multiplier, -COMTRADE_SAMPLE_LIMIT, COMTRADE_SAMPLE_LIMIT);
+    }
+
+    text.append("%u\r\n", COMTRADE_LINE_FREQUENCY);
+    text.append("0\r\n0,%lu\r\n", (unsigned long)layout.samples);     // Düzensiz örnekleme
+    appendDate(text, layout.firstTime, layout.firstMillis);            // İlk örnek
+    appendDate(text, layout.firstTime, layout.firstMillis);            // Tetik = ilk arıza
+    text.append("%s\r\n", binary ? "BINARY" : "ASCII");
+    text.append("%lu\r\n", (unsigned long)layout.timeMultiplier);
+
+    if (text.used >= capacity) {
+        return 0;
+    }
+    return text.used;
+}
+
+size_t comtradeSample(const ComtradeLayout& layout, uint32_t index, const FaultRecord& record,
+                      bool binary, uint8_t* out, size_t capacity) {
+    int64_t offset = sampleOffset(layout, record.timestamp, record.millis);
+    uint32_t time = offset < 0 ? 0 : (uint32_t)(offset / layout.timeMultiplier);
+
+    if (binary) {
+        // n(4) zaman(4) 8 x örnek(2), little-endian; durum kelimesi yok (0 dijital kanal)
+        const size_t size = 8 + 2 * COMTRADE_ANALOG_CHANNELS;
+        if (capacity < size) return 0;
+        for (int i = 0; i < 4; i++) {
+            out[i] = (uint8_t)(index >> (8 * i));
+            out[4 + i] = (uint8_t)(time >> (8 * i));
+        }
+        for (uint8_t i = 0; i < COMTRADE_ANALOG_CHANNELS; i++) {
+            int16_t sample = i < record.valueCount ? scaleSample(layout, i, record.values[i]) : COMTRADE_MISSING_BINARY;
+            out[8 + 2 * i] = (uint8_t)((uint16_t)sample & 0xFF);
+            out[9 + 2 * i] = (uint8_t)((uint16_t)sample >> 8);
+        }
+        return size;
+    }
+
+    if (capacity == 0) return 0;
+    ComtradeText text = {(char*)out, capacity, 0};
+    text.append("%lu,%lu", (unsigned long)index, (unsigned long)time);
+    for (uint8_t i = 0; i < COMTRADE_ANALOG_CHANNELS; i++) {
+        if (i < record.valueCount) {
+            text.append(",%d", scaleSample(layout, i, record.values[i]));
+        } else {
+            text.append(",");                   // ASCII'de eksik veri boş alan
+        }
+    }
+    text.append("\r\n");
+
+    if (text.used >= capacity) {
+        return 0;
+    }
+    return text.used;
+}
@@ -0,0 +1,108 @@
+// fault_events.cpp - dsPIC arıza olaylarının WebSocket'e anlık iletimi
+#include "fault_events.h"
+#include "fault_record.h"
+#include "fault_store.h"
+#include "websocket_handler.h"
+#include "log_system.h"
+#include <ArduinoJson.h>
+#include <atomic>
+
+FaultEventStats faultEventStats = {0, 0, 0, 0, 0, 0, 0};
+
+struct FaultEvent {
+    uint16_t eventId;
+    uint16_t ageMs;                     // dsPIC'te arıza anından gönderime kadar geçen süre
+    unsigned long receivedAt;           // Frame'in çözüldüğü an (millis)
+    uint16_t length;                    // Kayıt byte sayısı - ikili kayıt 0x00 içerebilir
+    char text[FAULT_EVENT_MAX_TEXT + 1];
+};
+
+// Tek üretici (owner task) / tek tüketici (web task) halka
+static FaultEvent eventQueue[FAULT_EVENT_QUEUE_SIZE];
+static std::atomic<uint32_t> eventHead(0);
+static std::atomic<uint32_t> eventTail(0);
+
+// Frame verisi: [olay no(2), yaş ms(2), kayıt metni ya da ikili kayıt...]
+void handleFaultEventFrame(const UARTFrame& frame) {
+    faultEventStats.received++;
+
+    if (frame.dataLength < 5) {
+        faultEventStats.dropped++;
+        return;
+    }
+
+    uint32_t head = eventHead.load(std::memory_order_relaxed);
+    uint32_t tail = eventTail.load(std::memory_order_acquire);
+    if (head - tail >= FAULT_EVENT_QUEUE_SIZE) {
+        faultEventStats.dropped++;
+        return;
+    }
+
+    FaultEvent& event = eventQueue[head & (FAULT_EVENT_QUEUE_SIZE - 1)];
+    event.eventId = ((uint16_t)frame.data[0] << 8) | frame.data[1];
+    event.ageMs = ((uint16_t)frame.data[2] << 8) | frame.data[3];
+    event.receivedAt = millis();
+
+    size_t length = frame.dataLength - 4;
+    if (length > FAULT_EVENT_MAX_TEXT) length = FAULT_EVENT_MAX_TEXT;
+    memcpy(event.text, frame.data + 4, length);
+    event.text[length] = '\0';
+    event.length = length;
+
+    eventHead.store(head + 1, std::memory_order_release);
+}
+
+void processFaultEvents() {
+    uint32_t tail = eventTail.load(std::memory_order_relaxed);
+    while (tail != eventHead.load(std::memory_order_acquire)) {
+        const FaultEvent& event = eventQueue[tail & (FAULT_EVENT_QUEUE_SIZE - 1)];
+
+        unsigned long latency = event.ageMs + (millis() - event.receivedAt);
+
+        FaultRecord record;
+        char recordJson[FAULT_RECORD_JSON_MAX];
+        bool parsed = parseFaultRecord((const uint8_t*)event.text, event.length, record) &&
+                      faultRecordToJSON(record, recordJson, sizeof(recordJson)) > 0;
+        bool binary = event.length > 0 && (uint8_t)event.text[0] == FAULT_RECORD_BINARY_TAG;
+        if (binary && !parsed) {
+            // Ham ikili veri metin olarak gönderilemez - kayıt deposu senkronu yine de alır
+            faultEventStats.dropped++;
+            LOG_WARN("FAULT", "⚠️ Arıza olayı #%u: ikili kayıt çözülemedi (%u byte)", event.eventId, event.length);
+        } else {
+            // İkili kayıtta sadece çözülmüş kayıt gönderilir
+            broadcastFault(binary ? String() : String(event.text), event.eventId, latency,
+                           parsed ? recordJson : NULL);
+        }
+        requestFaultStoreSync();
+
+        faultEventStats.delivered++;
+        faultEventStats.lastLatencyMs = latency;
+        faultEventStats.totalLatencyMs += latency;
+        if (latency > faultEventStats.maxLatencyMs) {
+            faultEventStats.maxLatencyMs = latency;
+        }
+        if (latency > FAULT_EVENT_LATENCY_BUDGET_MS) {
+            faultEventStats.overBudget++;
+            LOG_WARN("FAULT", "⚠️ Arıza olayı #%u gecikmeli iletildi: %lums", event.eventId, latency);
+        }
+
+        eventTail.store(++tail, std::memory_order_release);
+    }
+}
+
+String getFaultEventStatsJSON() {
+    JsonDocument doc;
+    doc["received"] = faultEventStats.received;
+    doc["delivered"] = faultEventStats.delivered;
+    doc["dropped"] = faultEventStats.dropped;
+    doc["overBudget"] = faultEventStats.overBudget;
+    doc["budgetMs"] = FAULT_EVENT_LATENCY_BUDGET_MS;
+    doc["lastLatencyMs"] = faultEventStats.lastLatencyMs;
+    doc["maxLatencyMs"] = faultEventStats.maxLatencyMs;
+    doc["avgLatencyMs"] = faultEventStats.delivered > 0 ?
+        faultEventStats.totalLatencyMs / faultEventStats.delivered : 0;
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
@@ -0,0 +1,353 @@
+// fault_export.cpp - Arıza deposunun CSV/NDJSON/COMTRADE olarak akış halinde dışa aktarımı
+#include "fault_export.h"
+#include "fault_record.h"
+#include "comtrade.h"
+#include "settings.h"
+#include "auth_system.h"
+#include "log_system.h"
+#include <WebServer.h>
+
+extern WebServer server;
+
+enum ExportFormat {
+    EXPORT_CSV,
+    EXPORT_NDJSON
+};
+
+// Sabit tamponlu çıkış. Range için ilk 'skip' byte atılır, 'remaining' dolunca kesilir.
+// send=false iken sadece toplam boyut sayılır (Content-Range için ön geçiş).
+struct ExportWriter {
+    char buffer[FAULT_EXPORT_BUFFER_SIZE];
+    size_t used;
+    uint32_t skip;
+    uint32_t remaining;
+    uint32_t total;
+    bool send;
+};
+
+static void flushExport(ExportWriter& writer) {
+    if (writer.used > 0 && writer.send) {
+        server.sendContent(writer.buffer, writer.used);
+    }
+    writer.used = 0;
+}
+
+static void writeExport(ExportWriter& writer, const char* data, size_t length) {
+    writer.total += length;
+    if (writer.skip >= length) {
+        writer.skip -= length;
+        return;
+    }
+    data += writer.skip;
+    length -= writer.skip;
+    writer.skip = 0;
+
+    if (length > writer.remaining) length = writer.remaining;
+    writer.remaining -= length;
+    if (!writer.send) {
+        return;
+    }
+
+    while (length > 0) {
+        size_t part = min(length, sizeof(writer.buffer) - writer.used);
+        memcpy(writer.buffer + writer.used, data, part);
+        writer.used += part;
+        data += part;
+        length -= part;
+        if (writer.used == sizeof(writer.buffer)) {
+            flushExport(writer);
+        }
+    }
+}
+
+// ==================== SATIR BİÇİMİ ====================
+
+static const char csvHeader[] = "id,sequence,time,channel,type,v1,v2,v3,v4,v5,v6,v7,v8\r\n";
+
+static size_t formatCSVRow(const StoredFault& entry, char* out, size_t capacity) {
+    const FaultRecord& record = entry.record;
+    char digits[13];
+    faultTimestampToDigits(record.timestamp, digits);
+
+    // DDMMYYHHMMSS -> 20YY-MM-DD HH:MM:SS.mmm
+    int length = snprintf(out, capacity, "%lu,%u,20%.2s-%.2s-%.2s %.2s:%.2s:%.2s.%03u,%u,%u",
+                          (unsigned long)entry.id, record.sequence,
+                          digits + 4, digits + 2, digits, digits + 6, digits + 8, digits + 10,
+                          record.millis, record.channel, record.typeCode);
+
+    for (uint8_t i = 0; i < FAULT_RECORD_MAX_VALUES && length > 0 && (size_t)length < capacity; i++) {
+        if (i >= record.valueCount) {
+            length += snprintf(out + length, capacity - length, ",");
+            continue;
+        }
+        int32_t value = record.values[i];
+        uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+        length += snprintf(out + length, capacity - length, ",%s%lu.%02lu", value < 0 ? "-" : "",
+                           (unsigned long)(magnitude / FAULT_RECORD_VALUE_SCALE),
+                           (unsigned long)(magnitude % FAULT_RECORD_VALUE_SCALE));
+    }
+    if (length <= 0 || (size_t)length + 2 >= capacity) {
+        return 0;
+    }
+    out[length++] = '\r';
+    out[length++] = '\n';
+    return length;
+}
+
+static size_t formatNDJSONRow(const StoredFault& entry, char* out, size_t capacity) {
+    char recordJson[FAULT_RECORD_JSON_MAX];
+    if (faultRecordToJSON(entry.record, recordJson, sizeof(recordJson)) == 0) {
+        return 0;
+    }
+    int length = snprintf(out, capacity, "{\"id\":%lu,\"record\":%s}\n", (unsigned long)entry.id, recordJson);
+    return (length > 0 && (size_t)length < capacity) ? length : 0;
+}
+
+// Sorgunun tamamını yazıcıya ver - aynı sorgu her seferinde aynı byte'ları üretir
+static void writeFaultExport(ExportWriter& writer, FaultQuery query, ExportFormat format) {
+    if (format == EXPORT_CSV) {
+        writeExport(writer, csvHeader, sizeof(csvHeader) - 1);
+    }
+
+    StoredFault entries[8];
+    char row[FAULT_RECORD_JSON_MAX + 32];
+    while (writer.remaining > 0) {
+        size_t found = continueFaultQuery(query, entries, 8);
+        if (found == 0) break;
+        for (size_t i = 0; i < found; i++) {
+            size_t length = format == EXPORT_CSV ? formatCSVRow(entries[i], row, sizeof(row))
+                                                 : formatNDJSONRow(entries[i], row, sizeof(row));
+            writeExport(writer, row, length);
+        }
+    }
+}
+
+// ==================== İSTEK ====================
+
+// Sorgu zamanı: Unix saniye, DDMMYYHHMMSS ya da YYYY-MM-DDTHH:MM[:SS] (dsPIC yerel saati)
+static bool parseQueryTime(const String& value, uint32_t& timestamp) {
+    int year, month, day, hour, minute, second = 0;
+    if (sscanf(value.c_str(), "%d-%d-%d%*c%d:%d:%d", &year, &month, &day, &hour, &minute, &second) >= 5) {
+        char digits[16];
+        snprintf(digits, sizeof(digits), "%02d%02d%02d%02d%02d%02d",
+                 day, month, year % 100, hour, minute, second);
+        return year >= 2000 && year <= 2099 && faultTimestampFromDigits(digits, timestamp);
+    }
+
+    for (size_t i = 0; i < value.length(); i++) {
+        if (!isDigit(value[i])) return false;
+    }
+    if (value.length() == 12) {
+        return faultTimestampFromDigits(value.c_str(), timestamp);
+    }
+    timestamp = strtoul(value.c_str(), NULL, 10);
+    return value.length() > 0;
+}
+
+bool readFaultQueryArgs(FaultQuery& query) {
+    query.startTime = 0;
+    query.endTime = UINT32_MAX;
+    if ((server.hasArg("start") && !parseQueryTime(server.arg("start"), query.startTime)) ||
+        (server.hasArg("end") && !parseQueryTime(server.arg("end"), query.endTime))) {
+        return false;
+    }
+    query.typeCode = server.hasArg("type") ? constrain(server.arg("type").toInt(), 0, 255) : -1;
+    query.channel = server.hasArg("channel") ? constrain(server.arg("channel").toInt(), 0, 255) : -1;
+    return true;
+}
+
+// "bytes=N-" ya da "bytes=N-M"; son ek ("bytes=-M") ve çoklu aralık desteklenmez
+static bool parseRangeHeader(const String& header, uint32_t& first, uint32_t& last) {
+    unsigned long rangeFirst, rangeLast;
+    char extra;
+    if (sscanf(header.c_str(), "bytes=%lu-%lu%c", &rangeFirst, &rangeLast, &extra) == 2 && rangeLast >= rangeFirst) {
+        first = rangeFirst;
+        last = rangeLast;
+        return true;
+    }
+    if (sscanf(header.c_str(), "bytes=%lu-%c", &rangeFirst, &extra) == 1 && header.endsWith("-")) {
+        first = rangeFirst;
+        last = UINT32_MAX;
+        return true;
+    }
+    return false;
+}
+
+void handleFaultExportAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+
+    String formatArg = server.hasArg("format") ? server.arg("format") : String("csv");
+    ExportFormat format;
+    if (formatArg == "csv") {
+        format = EXPORT_CSV;
+    } else if (formatArg == "ndjson") {
+        format = EXPORT_NDJSON;
+    } else {
+        server.send(400, "application/json", "{\"error\":\"format must be csv or ndjson\"}");
+        return;
+    }
+
+    FaultQuery query;
+    if (!readFaultQueryArgs(query)) {
+        server.send(400, "application/json", "{\"error\":\"invalid time\"}");
+        return;
+    }
+    beginFaultQuery(query);
+
+    // Devam isteği: If-Range'deki id aralığı hâlâ depodaysa aynı kayıtlar üretilir. If-Range
+    // yoksa ya da tutmuyorsa (saklama eski kayıtları silmiş) kısmi dosya eşlenemez - tam yanıt (200).
+    bool ranged = false;
+    uint32_t rangeFirst = 0, rangeLast = 0;
+    if (server.hasHeader("Range") && server.hasHeader("If-Range") &&
+        parseRangeHeader(server.header("Range"), rangeFirst, rangeLast)) {
+        unsigned long etagFirst, etagEnd;
+        char etagFormat[8];
+        ranged = sscanf(server.header("If-Range").c_str(), "\"%7[a-z]-%lu-%lu\"", etagFormat, &etagFirst, &etagEnd) == 3 &&
+                 formatArg == etagFormat && etagFirst >= getFaultStoreFirstId() && etagEnd <= getFaultStoreNextId();
+        if (ranged) {
+            query.cursor = etagFirst;
+            query.end = etagEnd;
+        }
+    }
+
+    char etag[40];
+    snprintf(etag, sizeof(etag), "\"%s-%lu-%lu\"", formatArg.c_str(), (unsigned long)query.cursor, (unsigned long)query.end);
+    const char* contentType = format == EXPORT_CSV ? "text/csv" : "application/x-ndjson";
+
+    server.sendHeader("Accept-Ranges", "bytes");
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Content-Disposition", format == EXPORT_CSV ? "attachment; filename=\"faults.csv\""
+                                                                  : "attachment; filename=\"faults.ndjson\"");
+
+    ExportWriter writer;
+    writer.used = 0;
+    writer.skip = 0;
+    writer.remaining = UINT32_MAX;
+    writer.total = 0;
+
+    if (ranged) {
+        // Content-Range toplam boyut ister - önce sadece sayan bir geçiş
+        writer.send = false;
+        writeFaultExport(writer, query, format);
+        uint32_t total = writer.total;
+
+        if (rangeFirst >= total) {
+            server.sendHeader("Content-Range", "bytes */" + String(total));
+            server.send(416, "text/plain", "Range Not Satisfiable");
+            return;
+        }
+        if (rangeLast >= total) rangeLast = total - 1;
+
+        char contentRange[48];
+        snprintf(contentRange, sizeof(contentRange), "bytes %lu-%lu/%lu",
+                 (unsigned long)rangeFirst, (unsigned long)rangeLast, (unsigned long)total);
+        server.sendHeader("Content-Range", contentRange);
+        server.setContentLength(rangeLast - rangeFirst + 1);
+        server.send(206, contentType, "");
+
+        writer.send = true;
+        writer.skip = rangeFirst;
+        writer.remaining = rangeLast - rangeFirst + 1;
+        writer.total = 0;
+        writeFaultExport(writer, query, format);
+        flushExport(writer);
+        LOG_INFO("EXPORT", "📥 Arıza dışa aktarımı devam ettirildi (%s, byte %lu)", formatArg.c_str(), (unsigned long)rangeFirst);
+        return;
+    }
+
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, contentType, "");
+    writer.send = true;
+    writeFaultExport(writer, query, format);
+    flushExport(writer);
+    server.sendContent("");
+
+    LOG_INFO("EXPORT", "📥 Arıza dışa aktarımı: %lu kayıt aralığı, %lu byte (%s)",
+            (unsigned long)(query.end - query.cursor), (unsigned long)writer.total, formatArg.c_str());
+}
+
+// ==================== COMTRADE ====================
+
+// part=cfg|dat, format=ascii|binary, aynı filtreler. .cfg ve .dat aynı kayıtları görmeli:
+// 'before' (hariç id) ile iki indirme aynı depo anına sabitlenir.
+void handleFaultComtradeAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+
+    String part = server.hasArg("part") ? server.arg("part") : String("cfg");
+    String formatArg = server.hasArg("format") ? server.arg("format") : String("binary");
+    if ((part != "cfg" && part != "dat") || (formatArg != "ascii" && formatArg != "binary")) {
+        server.send(400, "application/json", "{\"error\":\"part must be cfg|dat, format ascii|binary\"}");
+        return;
+    }
+    bool binary = formatArg == "binary";
+
+    FaultQuery query;
+    if (!readFaultQueryArgs(query)) {
+        server.send(400, "application/json", "{\"error\":\"invalid time\"}");
+        return;
+    }
+    beginFaultQuery(query);
+    if (server.hasArg("before")) {
+        uint32_t before = strtoul(server.arg("before").c_str(), NULL, 10);
+        if (before < query.end) query.end = max(before, query.cursor);
+    }
+
+    // Ön geçiş: örnek sayısı, zaman aralığı ve kanal ölçekleri
+    ComtradeLayout layout;
+    comtradeBegin(layout);
+    FaultQuery scan = query;
+    StoredFault entries[8];
+    size_t found;
+    while ((found = continueFaultQuery(scan, entries, 8)) > 0) {
+        for (size_t i = 0; i < found; i++) {
+            comtradeAddSample(layout, entries[i].record);
+        }
+    }
+    comtradeFinish(layout);
+
+    if (layout.samples == 0) {
+        server.send(404, "application/json", "{\"error\":\"no records\"}");
+        return;
+    }
+
+    if (part == "cfg") {
+        char cfg[COMTRADE_CFG_MAX];
+        size_t length = comtradeConfig(layout, settings.transformerStation.c_str(), settings.deviceName.c_str(),
+                                       binary, cfg, sizeof(cfg));
+        server.sendHeader("Content-Disposition", "attachment; filename=\"faults.cfg\"");
+        server.setContentLength(length);
+        server.send(200, "text/plain", "");
+        server.sendContent(cfg, length);
+        return;
+    }
+
+    server.sendHeader("Content-Disposition", "attachment; filename=\"faults.dat\"");
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, binary ? "application/octet-stream" : "text/plain", "");
+
+    ExportWriter writer;
+    writer.used = 0;
+    writer.skip = 0;
+    writer.remaining = UINT32_MAX;
+    writer.total = 0;
+    writer.send = true;
+
+    uint8_t sample[COMTRADE_SAMPLE_MAX];
+    uint32_t index = 0;
+    while (index < layout.samples && (found = continueFaultQuery(query, entries, 8)) > 0) {
+        for (size_t i = 0; i < found && index < layout.samples; i++) {
+            size_t length = comtradeSample(layout, ++index, entries[i].record, binary, sample, sizeof(sample));
+            writeExport(writer, (const char*)sample, length);
+        }
+    }
+    flushExport(writer);
+    server.sendContent("");
+
+    LOG_INFO("EXPORT", "📥 COMTRADE dışa aktarımı: %lu örnek (%s)", (unsigned long)index, formatArg.c_str());
+}
@@ -0,0 +1,328 @@
+// fault_jobs.cpp - Asenkron arıza sorguları (HTTP 202 + WebSocket teslimi)
+#include "fault_jobs.h"
+#include "fault_record.h"
+#include "uart_handler.h"
+#include "uart_protocol.h"
+#include "websocket_handler.h"
+#include "log_system.h"
+#include <ArduinoJson.h>
+#include <atomic>
+
+struct FaultJob {
+    uint32_t id;                    // 0: boş slot
+    bool isFirst;
+    int clientId;                   // İsteyen WebSocket client'ı, -1: herkese
+    bool delivered;                 // WebSocket'e iletildi
+    unsigned long createdAt;
+    std::atomic<bool> completed;    // Owner task yazar, web task okur
+    UARTTransaction transaction;    // Tamamlanana kadar owner task'a ait
+};
+
+// Toplu aktarım işi. Kayıtlar tampona [indeks(2)][metin...]['\0'] olarak eklenir.
+struct FaultRangeJob {
+    uint32_t id;
+    int clientId;
+    uint16_t start;
+    uint16_t requested;
+    uint16_t received;              // Owner task yazar (sink)
+    bool truncated;                 // Tampon doldu, kalan kayıtlar atıldı
+    bool delivered;
+    unsigned long createdAt;
+    size_t used;
+    std::atomic<bool> completed;
+    UARTTransaction transaction;
+};
+
+static FaultJob faultJobs[MAX_FAULT_JOBS];
+static FaultRangeJob rangeJob;
+static uint8_t rangeBuffer[FAULT_RANGE_BUFFER_SIZE];
+static uint32_t nextJobId = 1;
+
+static uint32_t allocateJobId() {
+    uint32_t jobId = nextJobId++;
+    if (nextJobId == 0) nextJobId = 1;
+    return jobId;
+}
+
+// Owner task bağlamında çalışır - sadece bayrağı kaldırır, ağır iş web task'ında
+static void onFaultTransactionDone(UARTTransaction* transaction, void* context) {
+    FaultJob* job = static_cast<FaultJob*>(context);
+    job->completed.store(true, std::memory_order_release);
+}
+
+static bool isJobDone(const FaultJob& job) {
+    return job.id != 0 && job.completed.load(std::memory_order_acquire);
+}
+
+// Yanıt metnini ayrıştırıp JSON'a yazar; kayıt biçimi tanınmazsa NULL (sadece ham metin gider)
+static const char* formatFaultRecord(const UARTTransaction& transaction, char* json, size_t capacity) {
+    FaultRecord record;
+    if (transaction.status != UART_STATUS_OK ||
+        !parseFaultRecord(transaction.response, transaction.responseLength, record)) {
+        return NULL;
+    }
+    return faultRecordToJSON(record, json, capacity) > 0 ? json : NULL;
+}
+
+// Boş ya da süresi geçmiş teslim edilmiş bir slot bul
+static FaultJob* allocateJob() {
+    unsigned long now = millis();
+    for (int i = 0; i < MAX_FAULT_JOBS; i++) {
+        FaultJob& job = faultJobs[i];
+        if (job.id == 0) {
+            return &job;
+        }
+        if (isJobDone(job) && job.delivered &&
+            now - job.transaction.completedAt > FAULT_JOB_RETENTION_MS) {
+            return &job;
+        }
+    }
+
+    // Tablo dolu - en eski teslim edilmiş işi feda et
+    FaultJob* oldest = NULL;
+    for (int i = 0; i < MAX_FAULT_JOBS; i++) {
+        FaultJob& job = faultJobs[i];
+        if (isJobDone(job) && job.delivered &&
+            (oldest == NULL || job.transaction.completedAt < oldest->transaction.completedAt)) {
+            oldest = &job;
+        }
+    }
+    return oldest;
+}
+
+static FaultJob* findJob(uint32_t jobId) {
+    if (jobId == 0) return NULL;
+    for (int i = 0; i < MAX_FAULT_JOBS; i++) {
+        if (faultJobs[i].id == jobId) {
+            return &faultJobs[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t createFaultJob(bool isFirst, int clientId) {
+    FaultJob* job = allocateJob();
+    if (job == NULL) {
+        LOG_WARN("FAULT", "⚠️ Arıza sorgu tablosu dolu - istek reddedildi");
+        return 0;
+    }
+
+    job->id = 0;
+    job->completed.store(false, std::memory_order_relaxed);
+
+    const char* command = isFirst ? FAULT_COMMAND_FIRST : FAULT_COMMAND_NEXT;
+    if (!prepareTextTransaction(job->transaction, command, FAULT_RESPONSE_TIMEOUT, UART_PRIORITY_INTERACTIVE)) {
+        return 0;
+    }
+
+    job->transaction.callback = onFaultTransactionDone;
+    job->transaction.context = job;
+    job->isFirst = isFirst;
+    job->clientId = isValidClientIndex(clientId) ? clientId : -1;
+    job->delivered = false;
+    job->createdAt = millis();
+
+    uint32_t jobId = allocateJobId();
+
+    if (!submitUARTTransaction(&job->transaction)) {
+        return 0;
+    }
+    job->id = jobId;
+
+    LOG_DEBUG("FAULT", "Arıza sorgusu kuyruğa alındı: #%lu (%s)", (unsigned long)jobId, command);
+    return jobId;
+}
+
+// Owner task bağlamında her CMD_FAULT_RECORD frame'i için çağrılır
+static void onFaultRangeRecord(const UARTFrame& frame, void* context) {
+    FaultRangeJob* job = static_cast<FaultRangeJob*>(context);
+    // Tampon bir kez dolduysa sonraki (daha kısa) kayıtlar da alınmaz - aksi halde 'next'
+    // atlanan kaydın ötesine geçer ve istemci o kaydı hiç istemez
+    if (job->truncated || frame.command != CMD_FAULT_RECORD || frame.dataLength < 2) {
+        return;
+    }
+
+    // Metin içindeki ilk NUL'da kes - tampon NUL ile ayrılmış kayıtlardan oluşur
+    size_t textLength = strnlen((const char*)frame.data + 2, frame.dataLength - 2);
+    if (job->used + 2 + textLength + 1 > FAULT_RANGE_BUFFER_SIZE) {
+        job->truncated = true;
+        return;
+    }
+
+    uint8_t* cursor = rangeBuffer + job->used;
+    memcpy(cursor, frame.data, 2 + textLength);     // indeks + metin
+    cursor[2 + textLength] = '\0';
+    job->used += 2 + textLength + 1;
+    job->received++;
+}
+
+static void onFaultRangeDone(UARTTransaction* transaction, void* context) {
+    FaultRangeJob* job = static_cast<FaultRangeJob*>(context);
+    job->completed.store(true, std::memory_order_release);
+}
+
+static bool isRangeJobDone() {
+    return rangeJob.id != 0 && rangeJob.completed.load(std::memory_order_acquire);
+}
+
+static void releaseRangeJob() {
+    rangeJob.id = 0;
+}
+
+bool faultRangeSupported() {
+    return peerSupports(CAP_FAULT_RANGE);
+}
+
+uint32_t createFaultRangeJob(uint16_t start, uint16_t count, int clientId) {
+    if (rangeJob.id != 0) {
+        if (!isRangeJobDone() || !rangeJob.delivered) {
+            return 0; // Önceki aktarım sürüyor
+        }
+        releaseRangeJob();
+    }
+
+    // Sonuç tek WebSocket mesajında küçük kalsın - istemci 'next' ile devam eder
+    if (count == 0 || count > FAULT_RANGE_JOB_RECORDS) {
+        count = FAULT_RANGE_JOB_RECORDS;
+    }
+
+    uint8_t request[4] = {
+        (uint8_t)(start >> 8), (uint8_t)(start & 0xFF),
+        (uint8_t)(count >> 8), (uint8_t)(count & 0xFF)
+    };
+
+    rangeJob.completed.store(false, std::memory_order_relaxed);
+    rangeJob.clientId = isValidClientIndex(clientId) ? clientId : -1;
+    rangeJob.start = start;
+    rangeJob.requested = count;
+    rangeJob.received = 0;
+    rangeJob.truncated = false;
+    rangeJob.delivered = false;
+    rangeJob.createdAt = millis();
+    rangeJob.used = 0;
+
+    if (!prepareStreamTransaction(rangeJob.transaction, CMD_GET_FAULT_RANGE, request, sizeof(request),
+                                  CMD_FAULT_RANGE_END, onFaultRangeRecord, &rangeJob,
+                                  FAULT_RANGE_FRAME_TIMEOUT, UART_PRIORITY_INTERACTIVE)) {
+        releaseRangeJob();
+        return 0;
+    }
+    rangeJob.transaction.compressReply = true;     // Düşük hızlı hatlarda en büyük kazanç
+    rangeJob.transaction.callback = onFaultRangeDone;
+    rangeJob.transaction.context = &rangeJob;
+
+    if (!submitUARTTransaction(&rangeJob.transaction)) {
+        releaseRangeJob();
+        return 0;
+    }
+    rangeJob.id = allocateJobId();
+
+    LOG_DEBUG("FAULT", "Toplu arıza aktarımı kuyruğa alındı: #%lu (%u+%u)",
+            (unsigned long)rangeJob.id, start, (unsigned)count);
+    return rangeJob.id;
+}
+
+// Toplu aktarım sonucu - WebSocket mesajı ve yedek sorgu aynı JSON'u kullanır
+static String buildFaultRangeJSON() {
+    JsonDocument doc;
+    doc["type"] = "fault_range";
+    doc["jobId"] = rangeJob.id;
+    doc["start"] = rangeJob.start;
+
+    if (!isRangeJobDone()) {
+        doc["status"] = "pending";
+        doc["queuedFor"] = millis() - rangeJob.createdAt;
+    } else {
+        doc["status"] = transactionStatusToString(rangeJob.transaction.status);
+        doc["count"] = rangeJob.received;
+        doc["truncated"] = rangeJob.truncated;
+        doc["latency"] = rangeJob.transaction.completedAt - rangeJob.createdAt;
+
+        // Bitiş frame'i: [gönderilen(2), toplam(2)]
+        if (rangeJob.transaction.status == UART_STATUS_OK && rangeJob.transaction.responseLength >= 4) {
+            const uint8_t* end = rangeJob.transaction.response;
+            doc["total"] = ((uint16_t)end[2] << 8) | end[3];
+        }
+
+        // 'next': saklanan son kaydın dsPIC indeksinin bir sonrası (kayıt yoksa başlangıç)
+        uint32_t next = rangeJob.start;
+        JsonArray records = doc["records"].to<JsonArray>();
+        size_t offset = 0;
+        while (offset < rangeJob.used) {
+            const uint8_t* entry = rangeBuffer + offset;
+            const char* text = (const char*)(entry + 2);
+            uint16_t index = ((uint16_t)entry[0] << 8) | entry[1];
+            JsonObject record = records.add<JsonObject>();
+            record["index"] = index;
+            record["data"] = text;
+            next = (uint32_t)index + 1;
+            offset += 2 + strlen(text) + 1;
+        }
+        doc["next"] = next;
+    }
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+void processFaultJobs() {
+    if (isRangeJobDone()) {
+        if (!rangeJob.delivered) {
+            rangeJob.delivered = true;
+            String message = buildFaultRangeJSON();
+            sendJobResult(rangeJob.clientId, message);
+            LOG_INFO("FAULT", "📦 Toplu arıza aktarımı #%lu: %u kayıt, %lums",
+                    (unsigned long)rangeJob.id, rangeJob.received, rangeJob.transaction.completedAt - rangeJob.createdAt);
+        } else if (millis() - rangeJob.transaction.completedAt > FAULT_JOB_RETENTION_MS) {
+            releaseRangeJob();
+        }
+    }
+
+    for (int i = 0; i < MAX_FAULT_JOBS; i++) {
+        FaultJob& job = faultJobs[i];
+        if (!isJobDone(job) || job.delivered) {
+            continue;
+        }
+
+        job.delivered = true;
+        String record = transactionResponseString(job.transaction);
+
+        char recordJson[FAULT_RECORD_JSON_MAX];
+        sendFaultResult(job.clientId, job.id, transactionStatusToString(job.transaction.status), record,
+                        formatFaultRecord(job.transaction, recordJson, sizeof(recordJson)));
+    }
+}
+
+String getFaultJobJSON(uint32_t jobId) {
+    if (jobId != 0 && jobId == rangeJob.id) {
+        return buildFaultRangeJSON();
+    }
+
+    FaultJob* job = findJob(jobId);
+    if (job == NULL) {
+        return "";
+    }
+
+    JsonDocument doc;
+    doc["jobId"] = job->id;
+    doc["command"] = job->isFirst ? "first" : "next";
+
+    if (!isJobDone(*job)) {
+        doc["status"] = "pending";
+        doc["queuedFor"] = millis() - job->createdAt;
+    } else {
+        doc["status"] = transactionStatusToString(job->transaction.status);
+        doc["data"] = transactionResponseString(job->transaction);
+        doc["latency"] = job->transaction.completedAt - job->createdAt;
+
+        char recordJson[FAULT_RECORD_JSON_MAX];
+        if (formatFaultRecord(job->transaction, recordJson, sizeof(recordJson))) {
+            doc["record"] = serialized(recordJson);
+        }
+    }
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
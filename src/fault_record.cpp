@@ -0,0 +1,412 @@
+// fault_record.cpp - Arıza kaydı ayrıştırıcı ve JSON/CBOR/ikili serileştiriciler
+#include "fault_record.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ==================== ZAMAN ====================
+
+// Gregoryen takvim -> 1970'ten bu yana gün (H. Hinnant, days_from_civil)
+static int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yearOfEra = (uint32_t)(year - era * 400);
+    uint32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int32_t)dayOfEra - 719468;
+}
+
+static void civilFromDays(int32_t days, int32_t& year, uint32_t& month, uint32_t& day) {
+    days += 719468;
+    int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t dayOfEra = (uint32_t)(days - era * 146097);
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t mp = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = (int32_t)yearOfEra + era * 400 + (month <= 2);
+}
+
+static bool twoDigits(const char* text, uint32_t& value) {
+    if (text[0] < '0' || text[0] > '9' || text[1] < '0' || text[1] > '9') {
+        return false;
+    }
+    value = (text[0] - '0') * 10 + (text[1] - '0');
+    return true;
+}
+
+bool faultTimestampFromDigits(const char* digits, uint32_t& timestamp) {
+    uint32_t day, month, year, hour, minute, second;
+    if (!twoDigits(digits, day) || !twoDigits(digits + 2, month) || !twoDigits(digits + 4, year) ||
+        !twoDigits(digits + 6, hour) || !twoDigits(digits + 8, minute) || !twoDigits(digits + 10, second)) {
+        return false;
+    }
+
+    static const uint8_t monthDays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1 || day > monthDays[month - 1] ||
+        hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    if (month == 2 && day == 29 && (year % 4) != 0) {
+        return false;
+    }
+
+    int32_t days = daysFromCivil(2000 + year, month, day);
+    timestamp = (uint32_t)days * 86400UL + hour * 3600UL + minute * 60UL + second;
+    return true;
+}
+
+void faultTimestampToDigits(uint32_t timestamp, char* out) {
+    int32_t year;
+    uint32_t month, day;
+    civilFromDays((int32_t)(timestamp / 86400UL), year, month, day);
+    uint32_t seconds = timestamp % 86400UL;
+    snprintf(out, 13, "%02u%02u%02u%02u%02u%02u", (unsigned)day, (unsigned)month, (unsigned)(year % 100),
+             (unsigned)(seconds / 3600), (unsigned)(seconds / 60 % 60), (unsigned)(seconds % 60));
+}
+
+// ==================== METİN AYRIŞTIRMA ====================
+
+// Uzunluğu sınırlı alan gezgini - kaynak null ile bitmek zorunda değil
+struct FieldCursor {
+    const char* position;
+    const char* end;
+};
+
+static bool isSeparator(char c) {
+    return c == ',' || c == ';';
+}
+
+// Sıradaki alanı [start, stop) olarak döndürür, kenar boşlukları kırpılır
+static bool nextField(FieldCursor& cursor, const char*& start, const char*& stop) {
+    if (cursor.position > cursor.end) {
+        return false;
+    }
+
+    start = cursor.position;
+    const char* p = start;
+    while (p < cursor.end && !isSeparator(*p)) p++;
+    stop = p;
+    cursor.position = p + 1;            // Son alandan sonra end + 1 -> bir sonraki çağrı false
+
+    while (start < stop && (*start == ' ' || *start == '\t')) start++;
+    while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t' || stop[-1] == '\r' || stop[-1] == '\n')) stop--;
+    return true;
+}
+
+static bool parseUnsigned(const char* start, const char* stop, uint32_t limit, uint32_t& value) {
+    if (start == stop) return false;
+    value = 0;
+    for (const char* p = start; p < stop; p++) {
+        if (*p < '0' || *p > '9') return false;
+        value = value * 10 + (*p - '0');
+        if (value > limit) return false;
+    }
+    return true;
+}
+
+// "-12.5" -> -1250 (FAULT_RECORD_VALUE_SCALE); ikiden fazla ondalık hane kesilir
+static bool parseScaled(const char* start, const char* stop, int32_t& value) {
+    bool negative = false;
+    if (start < stop && (*start == '-' || *start == '+')) {
+        negative = *start == '-';
+        start++;
+    }
+    if (start == stop) return false;
+
+    int64_t whole = 0;
+    int32_t fraction = 0;
+    int fractionDigits = -1;            // -1: nokta görülmedi
+    bool anyDigit = false;
+
+    for (const char* p = start; p < stop; p++) {
+        if (*p == '.' && fractionDigits < 0) {
+            fractionDigits = 0;
+            continue;
+        }
+        if (*p < '0' || *p > '9') return false;
+        anyDigit = true;
+        if (fractionDigits < 0) {
+            whole = whole * 10 + (*p - '0');
+            if (whole > INT32_MAX) return false;
+        } else if (fractionDigits < 2) {
+            fraction = fraction * 10 + (*p - '0');
+            fractionDigits++;
+        }
+    }
+    if (!anyDigit) return false;
+
+    while (fractionDigits > 0 && fractionDigits < 2) {
+        fraction *= 10;
+        fractionDigits++;
+    }
+    if (fractionDigits < 0) fraction = 0;
+
+    // Çarpma-toplama 64 bitte; sınır kesirli kısım eklendikten sonra kontrol edilir
+    int64_t scaled = whole * FAULT_RECORD_VALUE_SCALE + fraction;
+    if (scaled > INT32_MAX) return false;
+    value = negative ? -(int32_t)scaled : (int32_t)scaled;
+    return true;
+}
+
+bool parseFaultRecordText(const char* text, size_t length, FaultRecord& record) {
+    memset(&record, 0, sizeof(record));
+
+    FieldCursor cursor = {text, text + length};
+    const char* start;
+    const char* stop;
+    uint32_t number;
+
+    // Sıra numarası
+    if (!nextField(cursor, start, stop) || !parseUnsigned(start, stop, 0xFFFF, number)) return false;
+    record.sequence = number;
+
+    // DDMMYYHHMMSS[.mmm]
+    if (!nextField(cursor, start, stop) || stop - start < 12) return false;
+    char digits[12];
+    memcpy(digits, start, 12);
+    if (!faultTimestampFromDigits(digits, record.timestamp)) return false;
+    if (stop - start > 12) {
+        // ".5" -> 500 ms, ".05" -> 50 ms: 1-3 hane, eksik haneler sağdan tamamlanır
+        const char* fractionStart = start + 13;
+        ptrdiff_t fractionDigits = stop - fractionStart;
+        if (start[12] != '.' || fractionDigits < 1 || fractionDigits > 3 ||
+            !parseUnsigned(fractionStart, stop, 999, number)) return false;
+        for (ptrdiff_t i = fractionDigits; i < 3; i++) number *= 10;
+        record.millis = number;
+        record.flags |= FAULT_RECORD_HAS_MILLIS;
+    }
+
+    // Kanal ve tip kodu
+    if (!nextField(cursor, start, stop) || !parseUnsigned(start, stop, 0xFF, number)) return false;
+    record.channel = number;
+    if (!nextField(cursor, start, stop) || !parseUnsigned(start, stop, 0xFF, number)) return false;
+    record.typeCode = number;
+
+    // Ölçüm değerleri (isteğe bağlı)
+    while (nextField(cursor, start, stop)) {
+        if (start == stop && cursor.position > cursor.end) break;   // Sondaki ayraç
+        int32_t value;
+        if (!parseScaled(start, stop, value)) return false;
+        if (record.valueCount < FAULT_RECORD_MAX_VALUES) {
+            record.values[record.valueCount++] = value;
+        } else {
+            record.flags |= FAULT_RECORD_TRUNCATED;
+        }
+    }
+    return true;
+}
+
+// ==================== İKİLİ ====================
+
+static uint16_t readU16(const uint8_t* p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint8_t* writeU16(uint8_t* p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+    return p + 2;
+}
+
+static uint8_t* writeU32(uint8_t* p, uint32_t value) {
+    p[0] = value >> 24;
+    p[1] = (value >> 16) & 0xFF;
+    p[2] = (value >> 8) & 0xFF;
+    p[3] = value & 0xFF;
+    return p + 4;
+}
+
+bool parseFaultRecordBinary(const uint8_t* data, size_t length, FaultRecord& record) {
+    memset(&record, 0, sizeof(record));
+    if (length < FAULT_RECORD_BINARY_HEADER || data[0] != FAULT_RECORD_BINARY_TAG) {
+        return false;
+    }
+
+    uint8_t count = data[11];
+    if (length < FAULT_RECORD_BINARY_HEADER + (size_t)count * 4) {
+        return false;
+    }
+
+    record.sequence = readU16(data + 1);
+    record.timestamp = readU32(data + 3);
+    record.millis = readU16(data + 7);
+    if (record.millis > 999) return false;
+    record.channel = data[9];
+    record.typeCode = data[10];
+    record.flags = FAULT_RECORD_FROM_BINARY | FAULT_RECORD_HAS_MILLIS;
+
+    const uint8_t* value = data + FAULT_RECORD_BINARY_HEADER;
+    for (uint8_t i = 0; i < count; i++, value += 4) {
+        if (record.valueCount < FAULT_RECORD_MAX_VALUES) {
+            record.values[record.valueCount++] = (int32_t)readU32(value);
+        } else {
+            record.flags |= FAULT_RECORD_TRUNCATED;
+        }
+    }
+    return true;
+}
+
+bool parseFaultRecord(const uint8_t* data, size_t length, FaultRecord& record) {
+    if (data == NULL || length == 0) {
+        return false;
+    }
+    if (data[0] == FAULT_RECORD_BINARY_TAG) {
+        return parseFaultRecordBinary(data, length, record);
+    }
+
+    // Frame verisi null ile bitebilir - ilk null'da kes
+    const char* text = (const char*)data;
+    const void* nul = memchr(data, 0, length);
+    if (nul) length = (const uint8_t*)nul - data;
+    return parseFaultRecordText(text, length, record);
+}
+
+size_t faultRecordToBinary(const FaultRecord& record, uint8_t* out, size_t capacity) {
+    size_t size = FAULT_RECORD_BINARY_HEADER + (size_t)record.valueCount * 4;
+    if (capacity < size) {
+        return 0;
+    }
+
+    uint8_t* p = out;
+    *p++ = FAULT_RECORD_BINARY_TAG;
+    p = writeU16(p, record.sequence);
+    p = writeU32(p, record.timestamp);
+    p = writeU16(p, record.millis);
+    *p++ = record.channel;
+    *p++ = record.typeCode;
+    *p++ = record.valueCount;
+    for (uint8_t i = 0; i < record.valueCount; i++) {
+        p = writeU32(p, (uint32_t)record.values[i]);
+    }
+    return size;
+}
+
+// ==================== JSON ====================
+
+// Taşma olursa used kapasiteyi geçer ve sonuç 0 döner
+struct TextWriter {
+    char* out;
+    size_t capacity;
+    size_t used;
+
+    void append(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+void TextWriter::append(const char* format, ...) {
+    if (used >= capacity) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(out + used, capacity - used, format, args);
+    va_end(args);
+    used += written < 0 ? capacity : (size_t)written;
+}
+
+size_t faultRecordToJSON(const FaultRecord& record, char* out, size_t capacity) {
+    if (capacity == 0) return 0;
+    TextWriter writer = {out, capacity, 0};
+
+    int32_t year;
+    uint32_t month, day;
+    civilFromDays((int32_t)(record.timestamp / 86400UL), year, month, day);
+    uint32_t seconds = record.timestamp % 86400UL;
+
+    writer.append("{\"seq\":%u,\"time\":%lu,\"ms\":%u,\"iso\":\"%04d-%02u-%02uT%02u:%02u:%02u.%03u\","
+                  "\"channel\":%u,\"type\":%u,\"values\":[",
+                  (unsigned)record.sequence, (unsigned long)record.timestamp, (unsigned)record.millis,
+                  (int)year, (unsigned)month, (unsigned)day, (unsigned)(seconds / 3600),
+                  (unsigned)(seconds / 60 % 60), (unsigned)(seconds % 60), (unsigned)record.millis,
+                  (unsigned)record.channel, (unsigned)record.typeCode);
+
+    for (uint8_t i = 0; i < record.valueCount; i++) {
+        int32_t value = record.values[i];
+        uint32_t magnitude = value < 0 ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+        writer.append("%s%s%lu.%02lu", i ? "," : "", value < 0 ? "-" : "",
+                      (unsigned long)(magnitude / FAULT_RECORD_VALUE_SCALE),
+                      (unsigned long)(magnitude % FAULT_RECORD_VALUE_SCALE));
+    }
+    writer.append("]%s}", (record.flags & FAULT_RECORD_TRUNCATED) ? ",\"truncated\":true" : "");
+
+    if (writer.used >= capacity) {
+        out[0] = '\0';
+        return 0;
+    }
+    return writer.used;
+}
+
+// ==================== CBOR ====================
+// RFC 8949 - anahtarlar kısa metin, değerler x100 tamsayı
+
+struct CBORWriter {
+    uint8_t* out;
+    size_t capacity;
+    size_t used;
+
+    void head(uint8_t major, uint64_t value) {
+        uint8_t bytes[9];
+        size_t count;
+        major <<= 5;
+        if (value < 24) {
+            bytes[0] = major | value;
+            count = 1;
+        } else if (value <= 0xFF) {
+            bytes[0] = major | 24;
+            bytes[1] = value;
+            count = 2;
+        } else if (value <= 0xFFFF) {
+            bytes[0] = major | 25;
+            bytes[1] = value >> 8;
+            bytes[2] = value & 0xFF;
+            count = 3;
+        } else {
+            bytes[0] = major | 26;
+            for (int i = 0; i < 4; i++) bytes[1 + i] = (value >> (24 - 8 * i)) & 0xFF;
+            count = 5;
+        }
+        write(bytes, count);
+    }
+
+    void write(const uint8_t* data, size_t length) {
+        if (used + length <= capacity) memcpy(out + used, data, length);
+        used += length;
+    }
+
+    void key(const char* name) {
+        size_t length = strlen(name);
+        head(3, length);
+        write((const uint8_t*)name, length);
+    }
+
+    void integer(int32_t value) {
+        if (value >= 0) head(0, (uint32_t)value);
+        else head(1, (uint32_t)(-(value + 1)));
+    }
+};
+
+size_t faultRecordToCBOR(const FaultRecord& record, uint8_t* out, size_t capacity) {
+    CBORWriter writer = {out, capacity, 0};
+    bool truncated = record.flags & FAULT_RECORD_TRUNCATED;
+
+    writer.head(5, truncated ? 7 : 6);
+    writer.key("seq");     writer.head(0, record.sequence);
+    writer.key("time");    writer.head(0, record.timestamp);
+    writer.key("ms");      writer.head(0, record.millis);
+    writer.key("channel"); writer.head(0, record.channel);
+    writer.key("type");    writer.head(0, record.typeCode);
+    writer.key("values");
+    writer.head(4, record.valueCount);
+    for (uint8_t i = 0; i < record.valueCount; i++) {
+        writer.integer(record.values[i]);
+    }
+    if (truncated) {
+        writer.key("truncated");
+        writer.head(7, 21);             // true
+    }
+
+    return writer.used <= capacity ? writer.used : 0;
+}
@@ -0,0 +1,638 @@
+// fault_store.cpp - LittleFS üzerinde sadece eklenen arıza kaydı deposu ve dsPIC senkronizasyonu
+#include "fault_store.h"
+#include "fault_jobs.h"
+#include "uart_arbiter.h"
+#include "uart_frame.h"
+#include "uart_protocol.h"
+#include "log_system.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <ArduinoJson.h>
+#include <freertos/semphr.h>
+#include <atomic>
+
+FaultStoreStats faultStoreStats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// Dosya ve indeks değişiklikleri (uartTask) ile okumalar (web task) arasında
+static SemaphoreHandle_t storeMutex = NULL;
+static bool storeReady = false;
+static uint32_t firstId = 0;
+static uint32_t nextId = 0;
+
+// Zaman indeksi: kayıt başına zaman damgası (id % FAULT_STORE_CAPACITY). dsPIC saati
+// sıfırlanabildiği (enerji kesintisi -> 2000 yılı) ya da geri alınabildiği için id sırası
+// zaman sırası değildir; sorgu segment sınırlarıyla daraltılır, kayıtlar tek tek süzülür.
+static uint32_t timeIndex[FAULT_STORE_CAPACITY];
+
+// Tekrar indeksi: kayıt başına dsPIC indeksi + kayıt içeriğinin parmak izi
+static uint32_t keyIndex[FAULT_STORE_CAPACITY];
+
+// Segment başına tip/kanal bitmap'i ve zaman sınırları - filtreye uymayan segment hiç okunmaz
+struct SegmentIndex {
+    uint32_t types[8];
+    uint32_t channels[8];
+    uint32_t minTime;
+    uint32_t maxTime;
+};
+static SegmentIndex segmentIndex[FAULT_STORE_MAX_SEGMENTS];
+
+// FNV-1a - ham kayıt metni ya da kayıt yapısı üzerinden (devam için önceki hash verilir)
+static uint32_t fingerprint(const uint8_t* data, size_t length, uint32_t hash = 2166136261UL) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+// Ayrıştırılmış kayıt memset ile sıfırlanıp doldurulduğundan aynı kayıt hep aynı anahtarı verir
+static uint32_t recordKey(uint16_t dspicIndex, const FaultRecord& record) {
+    uint8_t index[2] = {(uint8_t)(dspicIndex >> 8), (uint8_t)(dspicIndex & 0xFF)};
+    return fingerprint((const uint8_t*)&record, sizeof(record), fingerprint(index, sizeof(index)));
+}
+
+static void indexRecord(uint32_t id, uint16_t dspicIndex, const FaultRecord& record) {
+    SegmentIndex& index = segmentIndex[(id / FAULT_STORE_SEGMENT_RECORDS) % FAULT_STORE_MAX_SEGMENTS];
+    if (id % FAULT_STORE_SEGMENT_RECORDS == 0) {
+        memset(&index, 0, sizeof(index));
+        index.minTime = UINT32_MAX;
+    }
+    index.types[record.typeCode >> 5] |= 1UL << (record.typeCode & 31);
+    index.channels[record.channel >> 5] |= 1UL << (record.channel & 31);
+    if (record.timestamp < index.minTime) index.minTime = record.timestamp;
+    if (record.timestamp > index.maxTime) index.maxTime = record.timestamp;
+    timeIndex[id % FAULT_STORE_CAPACITY] = record.timestamp;
+    keyIndex[id % FAULT_STORE_CAPACITY] = recordKey(dspicIndex, record);
+}
+
+// Rescan sonrası aynı dsPIC kaydı tekrar gelir; zaman damgasına bakılmaz
+static bool alreadyStored(uint32_t key) {
+    for (uint32_t id = firstId; id < nextId; id++) {
+        if (keyIndex[id % FAULT_STORE_CAPACITY] == key) return true;
+    }
+    return false;
+}
+
+// dsPIC'teki son okunan kaydın parmak izi - kayıt silinip başa sarıldığını anlamak için
+static uint32_t cursorMark = 0;
+static std::atomic<bool> syncRequested(true);   // Açılışta bir kez
+
+// Senkronizasyon aktarımı - sink owner task'ta doldurur, uartTask iş bitince okur
+struct PendingFault {
+    uint16_t dspicIndex;
+    bool valid;
+    uint32_t mark;
+    FaultRecord record;
+};
+
+static PendingFault pending[FAULT_STORE_SYNC_BATCH + 1];
+static uint16_t pendingCount = 0;
+static UARTTransaction syncTransaction;
+
+// ==================== DOSYA ====================
+
+static void segmentPath(uint32_t segment, char* path, size_t capacity) {
+    snprintf(path, capacity, FAULT_STORE_DIR "/%08lu.seg", (unsigned long)segment);
+}
+
+static uint8_t entryChecksum(StoredFault entry) {
+    entry.crc = 0;
+    return calculateCRC8((const uint8_t*)&entry, sizeof(entry));
+}
+
+static bool validEntry(const StoredFault& entry, uint32_t expectedId) {
+    return entry.id == expectedId && entry.crc == entryChecksum(entry);
+}
+
+static void removeSegment(uint32_t segment) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    LittleFS.remove(path);
+}
+
+// Geçerli ilk 'count' kaydı bırakıp dosyanın kalanını at (yarım kalmış yazma)
+static bool truncateSegment(uint32_t segment, size_t count) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    const char* tempPath = FAULT_STORE_DIR "/repair.tmp";
+
+    File source = LittleFS.open(path, "r");
+    File target = LittleFS.open(tempPath, "w");
+    if (!source || !target) {
+        return false;
+    }
+
+    StoredFault entry;
+    for (size_t i = 0; i < count; i++) {
+        if (source.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry) ||
+            target.write((const uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+            source.close();
+            target.close();
+            return false;
+        }
+    }
+    source.close();
+    target.close();
+
+    LittleFS.remove(path);
+    return LittleFS.rename(tempPath, path);
+}
+
+// Segmenti baştan sona doğrula ve zaman indeksini kur. Geçerli kayıt sayısını döndürür.
+static size_t loadSegment(uint32_t segment) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return 0;
+    }
+
+    uint32_t expectedId = segment * FAULT_STORE_SEGMENT_RECORDS;
+    size_t count = 0;
+    StoredFault entry;
+
+    while (count < FAULT_STORE_SEGMENT_RECORDS &&
+           file.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry) &&
+           validEntry(entry, expectedId + count)) {
+        indexRecord(entry.id, entry.dspicIndex, entry.record);
+        count++;
+    }
+
+    bool trailing = file.size() != count * sizeof(entry);
+    file.close();
+
+    if (trailing) {
+        LOG_WARN("STORE", "⚠️ Arıza deposu segmenti onarıldı: %s (%u kayıt)", path, (unsigned)count);
+        truncateSegment(segment, count);
+    }
+    return count;
+}
+
+// ==================== KURULUM ====================
+
+static uint16_t loadCursor() {
+    Preferences prefs;
+    prefs.begin(FAULT_STORE_NVS_NAMESPACE, true);
+    uint16_t cursor = prefs.getUShort("cursor", 0);
+    cursorMark = prefs.getULong("mark", 0);
+    prefs.end();
+    return cursor;
+}
+
+static void storeCursor(uint16_t cursor, uint32_t mark) {
+    if (cursor == faultStoreStats.dspicCursor && mark == cursorMark) {
+        return;
+    }
+    Preferences prefs;
+    prefs.begin(FAULT_STORE_NVS_NAMESPACE, false);
+    prefs.putUShort("cursor", cursor);
+    prefs.putULong("mark", mark);
+    prefs.end();
+    faultStoreStats.dspicCursor = cursor;
+    cursorMark = mark;
+}
+
+bool initFaultStore() {
+    if (storeMutex == NULL) {
+        storeMutex = xSemaphoreCreateMutex();
+    }
+
+    if (!LittleFS.exists(FAULT_STORE_DIR) && !LittleFS.mkdir(FAULT_STORE_DIR)) {
+        LOG_ERROR("STORE", "❌ Arıza deposu dizini oluşturulamadı");
+        return false;
+    }
+
+    // Mevcut segment numaraları
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0;
+    bool any = false;
+
+    File dir = LittleFS.open(FAULT_STORE_DIR);
+    File file = dir.openNextFile();
+    while (file) {
+        const char* name = file.name();
+        const char* base = strrchr(name, '/');
+        base = base ? base + 1 : name;
+        if (strstr(base, ".seg")) {
+            uint32_t segment = strtoul(base, NULL, 10);
+            if (segment < lowest) lowest = segment;
+            if (segment > highest) highest = segment;
+            any = true;
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+
+    if (any) {
+        // Saklama sınırı dışında kalanlar ve en yeniden geriye kopuk olanlar silinir
+        uint32_t first = highest;
+        char path[32];
+        while (first > lowest && highest - (first - 1) < FAULT_STORE_MAX_SEGMENTS) {
+            segmentPath(first - 1, path, sizeof(path));
+            if (!LittleFS.exists(path)) break;
+            first--;
+        }
+        if (first > lowest) {
+            dir = LittleFS.open(FAULT_STORE_DIR);
+            file = dir.openNextFile();
+            while (file) {
+                const char* name = file.name();
+                const char* base = strrchr(name, '/');
+                base = base ? base + 1 : name;
+                bool stale = strstr(base, ".seg") && strtoul(base, NULL, 10) < first;
+                file.close();
+                if (stale) {
+                    char path[32];
+                    snprintf(path, sizeof(path), FAULT_STORE_DIR "/%s", base);
+                    LittleFS.remove(path);
+                }
+                file = dir.openNextFile();
+            }
+            dir.close();
+        }
+
+        // Doğrula - bozuk segmentten sonrası kimliği sürdüremez, atılır
+        firstId = first * FAULT_STORE_SEGMENT_RECORDS;
+        nextId = firstId;
+        for (uint32_t segment = first; segment <= highest; segment++) {
+            size_t count = loadSegment(segment);
+            nextId = segment * FAULT_STORE_SEGMENT_RECORDS + count;
+            if (count < FAULT_STORE_SEGMENT_RECORDS) {
+                for (uint32_t stale = segment + 1; stale <= highest; stale++) {
+                    removeSegment(stale);
+                }
+                break;
+            }
+        }
+    }
+
+    faultStoreStats.dspicCursor = loadCursor();
+    if (nextId == firstId) {
+        // Depo boş - dsPIC'teki tüm kayıtlar yeniden alınır
+        storeCursor(0, 0);
+    }
+
+    storeReady = true;
+    LOG_INFO("STORE", "💾 Arıza deposu: %lu kayıt (#%lu-#%lu), dsPIC imleci %u",
+            (unsigned long)(nextId - firstId), (unsigned long)firstId, (unsigned long)nextId, faultStoreStats.dspicCursor);
+    return true;
+}
+
+// ==================== YAZMA ====================
+
+// uartTask - kilit altında çağrılır
+static bool appendRecords(const PendingFault* items, size_t count) {
+    size_t written = 0;
+    while (written < count) {
+        uint32_t segment = nextId / FAULT_STORE_SEGMENT_RECORDS;
+
+        // Yeni segment açılıyorsa saklama sınırı: en eskiyi sil
+        if (nextId % FAULT_STORE_SEGMENT_RECORDS == 0) {
+            while (segment - firstId / FAULT_STORE_SEGMENT_RECORDS >= FAULT_STORE_MAX_SEGMENTS) {
+                removeSegment(firstId / FAULT_STORE_SEGMENT_RECORDS);
+                firstId += FAULT_STORE_SEGMENT_RECORDS;
+            }
+        }
+
+        char path[32];
+        segmentPath(segment, path, sizeof(path));
+        File file = LittleFS.open(path, FILE_APPEND);
+        if (!file) {
+            faultStoreStats.writeErrors++;
+            return false;
+        }
+
+        while (written < count && nextId / FAULT_STORE_SEGMENT_RECORDS == segment) {
+            StoredFault entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.id = nextId;
+            entry.dspicIndex = items[written].dspicIndex;
+            entry.record = items[written].record;
+            entry.crc = entryChecksum(entry);
+
+            if (file.write((const uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+                faultStoreStats.writeErrors++;
+                file.close();
+                return false;
+            }
+
+            indexRecord(entry.id, entry.dspicIndex, entry.record);
+            nextId++;
+            written++;
+        }
+        file.close();
+    }
+    return true;
+}
+
+// ==================== SENKRONİZASYON ====================
+
+// Owner task bağlamında - sadece ayrıştırır ve tampona koyar, dosyaya yazmaz
+static void onSyncRecord(const UARTFrame& frame, void* context) {
+    if (frame.command != CMD_FAULT_RECORD || frame.dataLength < 2 || pendingCount >= FAULT_STORE_SYNC_BATCH + 1) {
+        return;
+    }
+
+    PendingFault& item = pending[pendingCount++];
+    item.dspicIndex = ((uint16_t)frame.data[0] << 8) | frame.data[1];
+    item.mark = fingerprint(frame.data + 2, frame.dataLength - 2);
+    item.valid = parseFaultRecord(frame.data + 2, frame.dataLength - 2, item.record);
+}
+
+// Tek CMD_GET_FAULT_RANGE turu. true: dsPIC'te okunacak kayıt kalmış olabilir.
+// İmleç > 0 ise son okunan kayıt da tekrar istenir; parmak izi tutmazsa dsPIC kaydı
+// silinmiş/başa sarmıştır ve baştan taranır (dsPIC indeksi + parmak izi tekrarları eler).
+static bool syncBatch() {
+    uint16_t cursor = faultStoreStats.dspicCursor;
+    bool overlap = cursor > 0;
+    uint16_t start = overlap ? cursor - 1 : cursor;
+    uint16_t count = FAULT_STORE_SYNC_BATCH + (overlap ? 1 : 0);
+
+    uint8_t request[4] = {
+        (uint8_t)(start >> 8), (uint8_t)(start & 0xFF),
+        (uint8_t)(count >> 8), (uint8_t)(count & 0xFF)
+    };
+
+    pendingCount = 0;
+    if (!prepareStreamTransaction(syncTransaction, CMD_GET_FAULT_RANGE, request, sizeof(request),
+                                  CMD_FAULT_RANGE_END, onSyncRecord, NULL,
+                                  FAULT_RANGE_FRAME_TIMEOUT, UART_PRIORITY_BACKGROUND)) {
+        return false;
+    }
+    syncTransaction.compressReply = true;
+
+    if (!executeUARTTransaction(syncTransaction) || syncTransaction.status != UART_STATUS_OK) {
+        return false;
+    }
+    if (syncTransaction.responseLength >= 4) {
+        faultStoreStats.dspicTotal = ((uint16_t)syncTransaction.response[2] << 8) | syncTransaction.response[3];
+    }
+
+    size_t first = 0;
+    if (overlap) {
+        if (pendingCount == 0 || pending[0].dspicIndex != start || pending[0].mark != cursorMark) {
+            faultStoreStats.rescans++;
+            LOG_WARN("STORE", "🔁 dsPIC arıza kaydı değişmiş - baştan taranıyor");
+            storeCursor(0, 0);
+            return true;
+        }
+        first = 1;
+    }
+
+    // Yeni kayıtları ayıkla (yerinde sıkıştır). Zamanı geriye giden kayıt da yenidir.
+    size_t accepted = 0;
+    for (size_t i = first; i < pendingCount; i++) {
+        if (!pending[i].valid) {
+            faultStoreStats.parseErrors++;
+            continue;
+        }
+        uint32_t key = recordKey(pending[i].dspicIndex, pending[i].record);
+        bool repeated = alreadyStored(key);
+        for (size_t j = 0; j < accepted && !repeated; j++) {
+            repeated = recordKey(pending[j].dspicIndex, pending[j].record) == key;
+        }
+        if (repeated) {
+            faultStoreStats.duplicates++;
+            continue;
+        }
+        pending[accepted++] = pending[i];
+    }
+
+    if (accepted > 0) {
+        xSemaphoreTake(storeMutex, portMAX_DELAY);
+        bool ok = appendRecords(pending, accepted);
+        xSemaphoreGive(storeMutex);
+        faultStoreStats.appended += accepted;
+        if (!ok) {
+            LOG_ERROR("STORE", "❌ Arıza deposuna yazılamadı");
+            return false;
+        }
+    }
+
+    // İmleç, parmak izi ile birlikte son okunan kayda ilerler (saklanmasa bile)
+    if (pendingCount > first) {
+        const PendingFault& last = pending[pendingCount - 1];
+        storeCursor(last.dspicIndex + 1, last.mark);
+    }
+
+    return pendingCount == count;
+}
+
+void requestFaultStoreSync() {
+    syncRequested.store(true, std::memory_order_relaxed);
+}
+
+void processFaultStoreSync() {
+    if (!storeReady || !faultRangeSupported()) {
+        return;
+    }
+
+    bool requested = syncRequested.exchange(false, std::memory_order_relaxed);
+    if (!requested && millis() - faultStoreStats.lastSyncAt < FAULT_STORE_SYNC_INTERVAL) {
+        return;
+    }
+    faultStoreStats.lastSyncAt = millis();
+    faultStoreStats.syncs++;
+
+    unsigned long appendedBefore = faultStoreStats.appended;
+    for (int batch = 0; batch < FAULT_STORE_SYNC_MAX_BATCHES; batch++) {
+        if (!syncBatch()) {
+            break;
+        }
+        // Tur bitmeden devam edilecekse sonraki turu bekletme
+        if (batch == FAULT_STORE_SYNC_MAX_BATCHES - 1) {
+            requestFaultStoreSync();
+        }
+    }
+
+    unsigned long added = faultStoreStats.appended - appendedBefore;
+    if (added > 0) {
+        LOG_INFO("STORE", "💾 %lu yeni arıza kaydı depoya eklendi (toplam %lu)",
+                added, (unsigned long)(nextId - firstId));
+    }
+}
+
+// ==================== OKUMA ====================
+
+size_t readStoredFaults(uint32_t from, StoredFault* out, size_t count) {
+    if (!storeReady || count == 0) {
+        return 0;
+    }
+
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    if (from < firstId) from = firstId;
+
+    size_t read = 0;
+    while (read < count && from + read < nextId) {
+        uint32_t id = from + read;
+        uint32_t segment = id / FAULT_STORE_SEGMENT_RECORDS;
+        char path[32];
+        segmentPath(segment, path, sizeof(path));
+
+        File file = LittleFS.open(path, "r");
+        if (!file || !file.seek((id % FAULT_STORE_SEGMENT_RECORDS) * sizeof(StoredFault))) {
+            break;
+        }
+
+        bool failed = false;
+        while (read < count && from + read < nextId && (from + read) / FAULT_STORE_SEGMENT_RECORDS == segment) {
+            StoredFault& entry = out[read];
+            if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry) || !validEntry(entry, from + read)) {
+                failed = true;
+                break;
+            }
+            read++;
+        }
+        file.close();
+        if (failed) break;
+    }
+
+    xSemaphoreGive(storeMutex);
+    return read;
+}
+
+// ==================== SORGU ====================
+
+static bool timeMatches(const FaultQuery& query, uint32_t id) {
+    uint32_t time = timeIndex[id % FAULT_STORE_CAPACITY];
+    return time >= query.startTime && time <= query.endTime;
+}
+
+static bool segmentTimeMatches(const FaultQuery& query, uint32_t segment) {
+    const SegmentIndex& index = segmentIndex[segment % FAULT_STORE_MAX_SEGMENTS];
+    return index.maxTime >= query.startTime && index.minTime <= query.endTime;
+}
+
+static bool segmentMayMatch(const FaultQuery& query, uint32_t segment) {
+    const SegmentIndex& index = segmentIndex[segment % FAULT_STORE_MAX_SEGMENTS];
+    int16_t typeCode = query.typeCode;
+    int16_t channel = query.channel;
+    if (!segmentTimeMatches(query, segment)) return false;
+    if (typeCode >= 0 && !(index.types[typeCode >> 5] & (1UL << (typeCode & 31)))) return false;
+    if (channel >= 0 && !(index.channels[channel >> 5] & (1UL << (channel & 31)))) return false;
+    return true;
+}
+
+// Zamanı aralıkta olan ilk ve son kaydın id'leri - sadece RAM'deki indeks taranır.
+// Aradaki aralık dışı kayıtlar continueFaultQuery'de diskten okunmadan atlanır.
+void beginFaultQuery(FaultQuery& query) {
+    query.scanned = 0;
+    if (!storeReady || query.endTime < query.startTime) {
+        query.cursor = query.end = 0;
+        return;
+    }
+
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    uint32_t first = nextId;
+    uint32_t last = nextId;
+    uint32_t id = firstId;
+    while (id < nextId) {
+        uint32_t segment = id / FAULT_STORE_SEGMENT_RECORDS;
+        uint32_t segmentEnd = min(nextId, (segment + 1) * FAULT_STORE_SEGMENT_RECORDS);
+        if (!segmentTimeMatches(query, segment)) {
+            id = segmentEnd;
+            continue;
+        }
+        for (; id < segmentEnd; id++) {
+            if (!timeMatches(query, id)) continue;
+            if (first == nextId) first = id;
+            last = id + 1;
+        }
+    }
+    query.cursor = first;
+    query.end = last;
+    xSemaphoreGive(storeMutex);
+}
+
+size_t continueFaultQuery(FaultQuery& query, StoredFault* out, size_t capacity) {
+    if (!storeReady || capacity == 0) {
+        return 0;
+    }
+
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    // Sorgu sırasında en eski segment silinmiş olabilir
+    if (query.cursor < firstId) query.cursor = firstId;
+    if (query.end > nextId) query.end = nextId;
+
+    size_t found = 0;
+    while (found < capacity && query.cursor < query.end) {
+        uint32_t segment = query.cursor / FAULT_STORE_SEGMENT_RECORDS;
+        uint32_t segmentEnd = min(query.end, (segment + 1) * FAULT_STORE_SEGMENT_RECORDS);
+
+        if (!segmentMayMatch(query, segment)) {
+            query.cursor = segmentEnd;
+            continue;
+        }
+
+        char path[32];
+        segmentPath(segment, path, sizeof(path));
+        File file = LittleFS.open(path, "r");
+        if (!file) {
+            query.cursor = query.end;
+            break;
+        }
+
+        // Zamanı aralık dışındaki kayıt okunmaz; sonraki eşleşmede yeniden konumlanılır
+        bool positioned = false;
+        while (found < capacity && query.cursor < segmentEnd) {
+            if (!timeMatches(query, query.cursor)) {
+                query.cursor++;
+                positioned = false;
+                continue;
+            }
+            if (!positioned && !file.seek((query.cursor % FAULT_STORE_SEGMENT_RECORDS) * sizeof(StoredFault))) {
+                query.cursor = query.end;
+                break;
+            }
+            positioned = true;
+
+            StoredFault& entry = out[found];
+            if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry) || !validEntry(entry, query.cursor)) {
+                query.cursor = query.end;
+                break;
+            }
+            query.cursor++;
+            query.scanned++;
+            if ((query.typeCode < 0 || entry.record.typeCode == query.typeCode) &&
+                (query.channel < 0 || entry.record.channel == query.channel)) {
+                found++;
+            }
+        }
+        file.close();
+    }
+
+    xSemaphoreGive(storeMutex);
+    return found;
+}
+
+uint32_t getFaultStoreFirstId() {
+    return firstId;
+}
+
+uint32_t getFaultStoreNextId() {
+    return nextId;
+}
+
+String getFaultStoreStatsJSON() {
+    JsonDocument doc;
+    doc["ready"] = storeReady;
+    doc["first"] = firstId;
+    doc["next"] = nextId;
+    doc["count"] = nextId - firstId;
+    doc["segments"] = nextId == firstId ? 0 :
+        (nextId - 1) / FAULT_STORE_SEGMENT_RECORDS - firstId / FAULT_STORE_SEGMENT_RECORDS + 1;
+    doc["maxRecords"] = FAULT_STORE_SEGMENT_RECORDS * FAULT_STORE_MAX_SEGMENTS;
+    doc["syncs"] = faultStoreStats.syncs;
+    doc["appended"] = faultStoreStats.appended;
+    doc["duplicates"] = faultStoreStats.duplicates;
+    doc["parseErrors"] = faultStoreStats.parseErrors;
+    doc["writeErrors"] = faultStoreStats.writeErrors;
+    doc["rescans"] = faultStoreStats.rescans;
+    doc["dspicCursor"] = faultStoreStats.dspicCursor;
+    doc["dspicTotal"] = faultStoreStats.dspicTotal;
+    doc["lastSyncAgo"] = faultStoreStats.lastSyncAt ? millis() - faultStoreStats.lastSyncAt : 0;
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
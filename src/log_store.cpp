@@ -0,0 +1,430 @@
+// log_store.cpp - Halkadaki logların LittleFS'e toplu (group commit) yazılması ve NDJSON okuma
+#include "log_store.h"
+#include "log_system.h"
+#include "uart_frame.h"
+#include "auth_system.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <WebServer.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+extern WebServer server;
+
+LogStoreStats logStoreStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+enum LogFlushReason {
+    LOG_FLUSH_SIZE,
+    LOG_FLUSH_TIME,
+    LOG_FLUSH_FORCED
+};
+
+// Tampon ve dosya durumu konsol task'ı ile flushLogStore/dışa aktarma arasında paylaşılır
+static SemaphoreHandle_t storeMutex = NULL;
+static bool storeReady = false;
+static uint32_t firstSegment = 0;
+static uint32_t currentSegment = 0;
+static uint32_t segmentBytes = 0;
+static uint32_t totalBytes = 0;
+static uint32_t storeCursor = 0;            // Halkada sıradaki okunacak girdi
+
+static uint8_t batch[LOG_STORE_BATCH_SIZE];
+static size_t batchUsed = 0;
+static unsigned long batchStartedAt = 0;
+
+// ==================== DOSYA ====================
+
+static void segmentPath(uint32_t segment, char* path, size_t capacity) {
+    snprintf(path, capacity, LOG_STORE_DIR "/%08lu.log", (unsigned long)segment);
+}
+
+static size_t segmentSize(uint32_t segment) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return 0;
+    }
+    size_t size = file.size();
+    file.close();
+    return size;
+}
+
+// Toplam sınır aşıldıysa en eski segmentleri sil (yazılan segment hariç)
+static void enforceRetention() {
+    while (totalBytes > LOG_STORE_MAX_BYTES && firstSegment < currentSegment) {
+        size_t size = segmentSize(firstSegment);
+        char path[32];
+        segmentPath(firstSegment, path, sizeof(path));
+        LittleFS.remove(path);
+        totalBytes -= size < totalBytes ? size : totalBytes;
+        firstSegment++;
+    }
+}
+
+static void writeBatch(LogFlushReason reason) {
+    if (batchUsed == 0) {
+        return;
+    }
+
+    char path[32];
+    segmentPath(currentSegment, path, sizeof(path));
+
+    unsigned long started = micros();
+    File file = LittleFS.open(path, "a");
+    bool written = file && file.write(batch, batchUsed) == batchUsed;
+    if (file) {
+        file.close();
+    }
+    unsigned long elapsed = micros() - started;
+
+    logStoreStats.flushes++;
+    logStoreStats.lastFlushUs = elapsed;
+    logStoreStats.totalFlushUs += elapsed;
+    if (elapsed > logStoreStats.maxFlushUs) logStoreStats.maxFlushUs = elapsed;
+    if (reason == LOG_FLUSH_SIZE) logStoreStats.sizeFlushes++;
+    else if (reason == LOG_FLUSH_TIME) logStoreStats.timeFlushes++;
+    else logStoreStats.forcedFlushes++;
+
+    if (written) {
+        // Sona ekleme, yarım dolu son bloğu yeniden programlar - tahmin buna göre
+        logStoreStats.fileBytes += batchUsed;
+        logStoreStats.flashBytes += (segmentBytes % LOG_STORE_FS_BLOCK) + batchUsed;
+        segmentBytes += batchUsed;
+        totalBytes += batchUsed;
+    } else {
+        // Tekrar denenmez - dolu/bozuk dosya sistemi log akışını durdurmasın
+        logStoreStats.writeErrors++;
+    }
+    batchUsed = 0;
+
+    if (segmentBytes >= LOG_STORE_SEGMENT_SIZE) {
+        currentSegment++;
+        segmentBytes = 0;
+        enforceRetention();
+    }
+}
+
+// ==================== TOPLAMA ====================
+
+static void appendRecord(const LogEntry& entry) {
+    char message[LOG_MESSAGE_MAX];
+    const char* source = logSourceName(entry.sourceId);
+    size_t sourceLength = strnlen(source, LOG_SOURCE_NAME_MAX - 1);
+    size_t messageLength = formatLogMessage(entry, message, sizeof(message));
+    size_t size = sizeof(StoredLogHeader) + sourceLength + messageLength;
+
+    if (batchUsed + size > sizeof(batch)) {
+        writeBatch(LOG_FLUSH_SIZE);
+    }
+    if (batchUsed == 0) {
+        batchStartedAt = millis();
+    }
+
+    StoredLogHeader header;
+    header.marker = LOG_STORE_MARKER;
+    header.crc = 0;
+    header.level = entry.level;
+    header.flags = entry.flags;
+    header.boot = logStoreStats.boot;
+    header.sequence = entry.sequence;
+    header.timestamp = entry.timestamp;
+    header.sourceLength = (uint8_t)sourceLength;
+    header.messageLength = (uint8_t)messageLength;
+    header.millis = entry.millis;
+
+    uint8_t* record = batch + batchUsed;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), source, sourceLength);
+    memcpy(record + sizeof(header) + sourceLength, message, messageLength);
+    record[offsetof(StoredLogHeader, crc)] = calculateCRC8(record, size);
+    batchUsed += size;
+
+    logStoreStats.records++;
+    logStoreStats.logicalBytes += sourceLength + messageLength;
+}
+
+// Halkadaki yeni girdileri tampona al. Yayınlanmamış girdi birkaç tur beklenir
+// (konsoldaki gibi); üretici slotu alamadıysa hiç yayınlanmaz ve atlanır.
+static void collectEntries() {
+    static uint8_t stalls = 0;
+    uint32_t head = getLogHead();
+    uint32_t tail = getLogTail();
+
+    if ((int32_t)(storeCursor - tail) < 0) {
+        if (head - storeCursor > LOG_RING_SIZE) {
+            logStoreStats.skipped += tail - storeCursor;
+        }
+        storeCursor = tail;
+    }
+
+    LogEntry entry;
+    while (storeCursor != head) {
+        if (!readLogEntry(storeCursor, entry)) {
+            if (head - storeCursor < LOG_RING_SIZE && stalls < 3) {
+                stalls++;
+                break;
+            }
+            logStoreStats.skipped++;
+            storeCursor++;
+            stalls = 0;
+            continue;
+        }
+        stalls = 0;
+        storeCursor++;
+
+        if (LOG_STORE_LEVEL_MASK & (1 << entry.level)) {
+            appendRecord(entry);
+        }
+    }
+}
+
+// ==================== KURULUM ====================
+
+static const char* resetReasonName(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return "power-on";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "int-wdt";
+        case ESP_RST_TASK_WDT:  return "task-wdt";
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deep-sleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "sdio";
+        default:                return "unknown";
+    }
+}
+
+bool initLogStore() {
+    if (storeMutex == NULL) {
+        storeMutex = xSemaphoreCreateMutex();
+    }
+
+    if (!LittleFS.exists(LOG_STORE_DIR) && !LittleFS.mkdir(LOG_STORE_DIR)) {
+        LOG_ERROR("LOG", "❌ Kalıcı log dizini oluşturulamadı");
+        return false;
+    }
+
+    Preferences prefs;
+    prefs.begin(LOG_STORE_NVS_NAMESPACE, false);
+    logStoreStats.boot = prefs.getUInt("boot", 0) + 1;
+    prefs.putUInt("boot", logStoreStats.boot);
+    prefs.end();
+
+    // Mevcut segmentler - yeni açılış en yüksek numaranın bir sonrasıyla başlar
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0;
+    bool any = false;
+    totalBytes = 0;
+
+    File dir = LittleFS.open(LOG_STORE_DIR);
+    File file = dir.openNextFile();
+    while (file) {
+        const char* name = file.name();
+        const char* base = strrchr(name, '/');
+        base = base ? base + 1 : name;
+        if (strstr(base, ".log")) {
+            uint32_t segment = strtoul(base, NULL, 10);
+            if (segment < lowest) lowest = segment;
+            if (segment > highest) highest = segment;
+            totalBytes += file.size();
+            any = true;
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    currentSegment = any ? highest + 1 : 0;
+    firstSegment = any ? lowest : currentSegment;
+    segmentBytes = 0;
+    enforceRetention();
+    storeReady = true;
+    xSemaphoreGive(storeMutex);
+
+    LOG_INFO("LOG", "💾 Kalıcı log: açılış #%lu (%s), %lu segment, %lu byte",
+             (unsigned long)logStoreStats.boot, resetReasonName(esp_reset_reason()),
+             (unsigned long)(currentSegment - firstSegment), (unsigned long)totalBytes);
+    return true;
+}
+
+void processLogStore() {
+    if (!storeReady) {
+        return;
+    }
+
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    collectEntries();
+    if (batchUsed >= LOG_STORE_FLUSH_BYTES) {
+        writeBatch(LOG_FLUSH_SIZE);
+    } else if (batchUsed > 0 && millis() - batchStartedAt >= LOG_STORE_FLUSH_INTERVAL) {
+        writeBatch(LOG_FLUSH_TIME);
+    }
+    xSemaphoreGive(storeMutex);
+}
+
+void flushLogStore() {
+    if (!storeReady) {
+        return;
+    }
+
+    if (xSemaphoreTake(storeMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return;
+    }
+    collectEntries();
+    writeBatch(LOG_FLUSH_FORCED);
+    xSemaphoreGive(storeMutex);
+}
+
+// ==================== OKUMA ====================
+
+// JSON metin değeri - tırnak, ters bölü ve kontrol karakterleri kaçışlı; UTF-8 olduğu gibi
+static size_t writeJsonString(char* out, size_t capacity, const char* text, size_t length) {
+    size_t used = 0;
+    for (size_t i = 0; i < length && used + 7 < capacity; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            out[used++] = '\\';
+            out[used++] = (char)c;
+        } else if (c < 0x20) {
+            used += snprintf(out + used, capacity - used, "\\u%04x", c);
+        } else {
+            out[used++] = (char)c;
+        }
+    }
+    return used;
+}
+
+static size_t formatStoredLog(const StoredLogHeader& header, const char* text, char* out, size_t capacity) {
+    char timestamp[32];
+    formatLogTime(header.timestamp, header.millis, header.flags, timestamp, sizeof(timestamp));
+
+    int length = snprintf(out, capacity, "{\"boot\":%lu,\"seq\":%lu,\"ts\":%lu,\"ms\":%u,\"wallclock\":%s,\"t\":\"%s\",\"l\":\"%s\",\"s\":\"",
+                          (unsigned long)header.boot, (unsigned long)header.sequence, (unsigned long)header.timestamp,
+                          (unsigned)header.millis,
+                          (header.flags & LOG_FLAG_WALLCLOCK) ? "true" : "false", timestamp, logLevelName(header.level));
+    if (length <= 0 || (size_t)length >= capacity) {
+        return 0;
+    }
+    size_t used = length;
+    used += writeJsonString(out + used, capacity - used, text, header.sourceLength);
+    used += snprintf(out + used, capacity - used, "\",\"m\":\"");
+    used += writeJsonString(out + used, capacity - used, text + header.sourceLength, header.messageLength);
+    used += snprintf(out + used, capacity - used, "\"}\n");
+    return used < capacity ? used : capacity - 1;
+}
+
+// Bir segmenti baştan oku; ilk geçersiz kayıtta (yarım yazma) segment biter
+static void streamSegment(uint32_t segment, bool filterBoot, uint32_t boot, char* chunk, size_t capacity, size_t& used) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return;
+    }
+
+    uint8_t record[sizeof(StoredLogHeader) + LOG_SOURCE_NAME_MAX + LOG_MESSAGE_MAX];
+    StoredLogHeader header;
+    while (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header)) {
+        if (header.marker != LOG_STORE_MARKER || header.sourceLength >= LOG_SOURCE_NAME_MAX ||
+            header.messageLength >= LOG_MESSAGE_MAX) {
+            break;
+        }
+        size_t textLength = header.sourceLength + header.messageLength;
+        if (file.read(record + sizeof(header), textLength) != textLength) {
+            break;
+        }
+        uint8_t crc = header.crc;
+        header.crc = 0;
+        memcpy(record, &header, sizeof(header));
+        if (calculateCRC8(record, sizeof(header) + textLength) != crc) {
+            break;
+        }
+        if (filterBoot && header.boot != boot) {
+            continue;
+        }
+
+        // En kötü satır: her mesaj byte'ı \u00XX olarak 6 byte
+        if (capacity - used < 6 * (LOG_MESSAGE_MAX + LOG_SOURCE_NAME_MAX) + 160) {
+            server.sendContent(chunk, used);
+            used = 0;
+        }
+        used += formatStoredLog(header, (const char*)record + sizeof(header), chunk + used, capacity - used);
+    }
+    file.close();
+}
+
+void handlePersistentLogAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    if (!storeReady) {
+        server.send(503, "text/plain", "Log store unavailable");
+        return;
+    }
+
+    bool filterBoot = server.hasArg("boot");
+    uint32_t boot = filterBoot ? strtoul(server.arg("boot").c_str(), NULL, 10) : 0;
+
+    // Tampondakiler de dahil olsun; okuma sırasında eklenen kayıtlar sonraki indirmeye kalır
+    flushLogStore();
+    xSemaphoreTake(storeMutex, portMAX_DELAY);
+    uint32_t first = firstSegment;
+    uint32_t last = currentSegment;
+    xSemaphoreGive(storeMutex);
+
+    server.sendHeader("Content-Disposition", "attachment; filename=\"logs.ndjson\"");
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/x-ndjson", "");
+
+    static char chunk[2048];
+    size_t used = 0;
+    for (uint32_t segment = first; segment <= last; segment++) {
+        streamSegment(segment, filterBoot, boot, chunk, sizeof(chunk), used);
+    }
+    if (used > 0) {
+        server.sendContent(chunk, used);
+    }
+    server.sendContent("");
+}
+
+void fillLogStoreJSON(JsonObject stats) {
+    stats["boot"] = logStoreStats.boot;
+    stats["records"] = logStoreStats.records;
+    stats["skipped"] = logStoreStats.skipped;
+    stats["logicalBytes"] = logStoreStats.logicalBytes;
+    stats["fileBytes"] = logStoreStats.fileBytes;
+    stats["flashBytes"] = logStoreStats.flashBytes;
+    stats["writeAmplification"] = logStoreStats.logicalBytes > 0
+        ? (float)logStoreStats.flashBytes / logStoreStats.logicalBytes : 0.0f;
+    stats["flushes"] = logStoreStats.flushes;
+    stats["sizeFlushes"] = logStoreStats.sizeFlushes;
+    stats["timeFlushes"] = logStoreStats.timeFlushes;
+    stats["forcedFlushes"] = logStoreStats.forcedFlushes;
+    stats["writeErrors"] = logStoreStats.writeErrors;
+    stats["lastFlushUs"] = logStoreStats.lastFlushUs;
+    stats["maxFlushUs"] = logStoreStats.maxFlushUs;
+    stats["avgFlushUs"] = logStoreStats.flushes > 0 ? logStoreStats.totalFlushUs / logStoreStats.flushes : 0;
+    stats["pendingBytes"] = (unsigned long)batchUsed;
+    stats["firstSegment"] = firstSegment;
+    stats["currentSegment"] = currentSegment;
+    stats["storedBytes"] = totalBytes;
+}
+
+void handlePersistentLogStatsAPI() {
+    if (!checkSession()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    fillLogStoreJSON(doc.to<JsonObject>());
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
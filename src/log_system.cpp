@@ -1,92 +1,567 @@
-#include "log_system.h"
-#include <time.h>
-#include "time_sync.h" // Zaman senkronizasyon durumunu kontrol etmek için ekleyin
-
-
-// log_system.h'de 'extern' olarak bildirilen global değişkenlerin
-// gerçek tanımlamaları burada yapılır.
-LogEntry logs[50];
-int logIndex = 0;
-int totalLogs = 0;
-
-// NTP'den geçerli zaman alınamazsa kullanılacak zaman formatı
-String getFormattedTimestampFallback() {
-    unsigned long seconds = millis() / 1000;
-    unsigned long minutes = seconds / 60;
-    unsigned long hours = minutes / 60;
-    seconds %= 60;
-    minutes %= 60;
-    hours %= 24;
-
-    char buffer[16];
-    sprintf(buffer, "%02lu:%02lu:%02lu", hours, minutes, seconds);
-    return String(buffer);
-}
-
-// NTP'den veya sistemden zamanı alıp formatlayan ana fonksiyon
-String getFormattedTimestamp() {
-    // Zamanın gerçekten senkronize olup olmadığını kontrol et
-    if (isTimeSynced()) {
-        struct tm timeinfo;
-        if (getLocalTime(&timeinfo)) {
-            char buffer[32];
-            strftime(buffer, sizeof(buffer), "%d.%m.%Y %H:%M:%S", &timeinfo);
-            return String(buffer);
-        }
-    }
-    // Eğer senkronize değilse, çalışma süresini göster
-    unsigned long seconds = millis() / 1000;
-    char buffer[32];
-    sprintf(buffer, "[NO_SYNC %02lu:%02lu:%02lu]", (seconds/3600)%24, (seconds/60)%60, seconds%60);
-    return String(buffer);
-}
-
-// Log sistemini başlatan fonksiyon
-void initLogSystem() {
-    for (int i = 0; i < 50; i++) {
-        logs[i].message = "";
-    }
-    logIndex = 0;
-    totalLogs = 0;
-    // Sistem başlatıldığında ilk logu ekle
-    addLog("Log sistemi başlatıldı.", INFO, "SYSTEM");
-}
-
-// Yeni bir log ekleyen ana fonksiyon
-void addLog(const String& msg, LogLevel level, const String& source) {
-    logs[logIndex].timestamp = getFormattedTimestamp();
-    logs[logIndex].message = msg;
-    logs[logIndex].level = level;
-    logs[logIndex].source = source;
-    logs[logIndex].millis_time = millis();
-
-    logIndex = (logIndex + 1) % 50; // Dairesel arabellek mantığı
-    if (totalLogs < 50) {
-        totalLogs++;
-    }
-
-    // Seri monitöre de logu bas
-    Serial.println("[" + getFormattedTimestamp() + "] [" + logLevelToString(level) + "] [" + source + "] " + msg);
-}
-
-// Log seviyesini string'e çeviren yardımcı fonksiyon
-String logLevelToString(LogLevel level) {
-    switch (level) {
-        case ERROR: return "ERROR";
-        case WARN:  return "WARN";
-        case INFO:  return "INFO";
-        case DEBUG: return "DEBUG";
-        case SUCCESS: return "SUCCESS";
-        default: return "UNKNOWN";
-    }
-}
-
-// Tüm logları temizleyen fonksiyon
-void clearLogs() {
-    for (int i = 0; i < 50; i++) {
-        logs[i].message = "";
-    }
-    logIndex = 0;
-    totalLogs = 0;
-    addLog("Log kayıtları temizlendi.", WARN, "SYSTEM");
-}
\ No newline at end of file
+#include "log_system.h"
+#include "log_store.h"
+#include <time.h>
+#include <sys/time.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+
+// Bu değerden büyük sistem saati NTP/dsPIC ile ayarlanmış sayılır (2020-09-13)
+#define LOG_WALLCLOCK_MIN_EPOCH     1600000000LL
+#define LOG_SLOT_EMPTY              0
+#define LOG_SLOT_BUSY               0xFFFFFFFFUL
+
+// commit: 0 boş, LOG_SLOT_BUSY yazılıyor, aksi halde içindeki girdinin sırası + 1
+struct LogSlot {
+    std::atomic<uint32_t> commit;
+    LogEntry entry;
+};
+
+static LogSlot ring[LOG_RING_SIZE];
+static std::atomic<uint32_t> logHead(0);
+
+// Uzun %s içerikleri - üretici yer ayırıp kopyalar, girdinin commit'i metinden sonra gelir.
+// Okuyucu kopyaladıktan sonra head'e bakar; aradan LOG_STRING_ARENA geçtiyse metin gitmiştir.
+static char stringArena[LOG_STRING_ARENA];
+static std::atomic<uint32_t> stringHead(0);
+static std::atomic<uint32_t> logCleared(0);     // Bu sıradan öncekiler temizlendi
+static std::atomic<uint32_t> droppedLogs(0);
+
+// Konsol task'ı - halkayı kendi imleciyle okur
+static TaskHandle_t consoleTaskHandle = NULL;
+static volatile bool consoleEnabled = true;
+static uint32_t consoleCursor = 0;
+static std::atomic<uint32_t> consoleDropped(0);
+
+volatile uint8_t logSourceMasks[LOG_MAX_SOURCES];
+volatile uint8_t logDefaultMask = LOG_MASK_ALL;
+
+// Kaynak adları - bir kez eklenir, sonra sadece okunur
+static char sourceNames[LOG_MAX_SOURCES][LOG_SOURCE_NAME_MAX];
+static std::atomic<bool> sourceReady[LOG_MAX_SOURCES];
+static std::atomic<uint32_t> sourceClaimed(0);
+
+// ==================== ZAMAN ====================
+
+static uint32_t currentTimestamp(uint8_t& flags, uint16_t& millis) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    if (now.tv_sec > LOG_WALLCLOCK_MIN_EPOCH) {
+        flags |= LOG_FLAG_WALLCLOCK;
+        millis = (uint16_t)(now.tv_usec / 1000);
+        return (uint32_t)now.tv_sec;
+    }
+    int64_t uptime = esp_timer_get_time();
+    millis = (uint16_t)((uptime / 1000) % 1000);
+    return (uint32_t)(uptime / 1000000LL);
+}
+
+static size_t formatTimestamp(uint32_t timestamp, uint8_t flags, char* out, size_t capacity) {
+    int length;
+    if (flags & LOG_FLAG_WALLCLOCK) {
+        time_t seconds = (time_t)timestamp;
+        struct tm timeinfo;
+        localtime_r(&seconds, &timeinfo);
+        length = (int)strftime(out, capacity, "%d.%m.%Y %H:%M:%S", &timeinfo);
+    } else {
+        // Senkronize değilse çalışma süresi
+        unsigned long uptime = timestamp;
+        length = snprintf(out, capacity, "[NO_SYNC %02lu:%02lu:%02lu]",
+                          (uptime / 3600) % 24, (uptime / 60) % 60, uptime % 60);
+    }
+    return length > 0 && (size_t)length < capacity ? length : 0;
+}
+
+// Log zamanı - ms ile (NO_SYNC biçiminde kapanış köşeli parantezinden önce)
+size_t formatLogTime(uint32_t timestamp, uint16_t millis, uint8_t flags, char* out, size_t capacity) {
+    size_t length = formatTimestamp(timestamp, flags, out, capacity);
+    if (length == 0) {
+        return 0;
+    }
+    bool bracket = !(flags & LOG_FLAG_WALLCLOCK);
+    if (bracket) length--;
+    int written = snprintf(out + length, capacity - length, bracket ? ".%03u]" : ".%03u", (unsigned)millis % 1000);
+    return written > 0 && length + written < capacity ? length + written : 0;
+}
+
+size_t formatLogTimestamp(const LogEntry& entry, char* out, size_t capacity) {
+    return formatLogTime(entry.timestamp, entry.millis, entry.flags, out, capacity);
+}
+
+// NTP'den geçerli zaman alınamazsa kullanılacak zaman formatı
+String getFormattedTimestampFallback() {
+    unsigned long seconds = millis() / 1000;
+    unsigned long minutes = seconds / 60;
+    unsigned long hours = minutes / 60;
+    seconds %= 60;
+    minutes %= 60;
+    hours %= 24;
+
+    char buffer[16];
+    sprintf(buffer, "%02lu:%02lu:%02lu", hours, minutes, seconds);
+    return String(buffer);
+}
+
+// NTP'den veya sistemden zamanı alıp formatlayan ana fonksiyon
+String getFormattedTimestamp() {
+    uint8_t flags = 0;
+    uint16_t ms;
+    uint32_t now = currentTimestamp(flags, ms);
+    char buffer[32];
+    formatTimestamp(now, flags, buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+// ==================== KAYNAK ADLARI ====================
+
+uint8_t internLogSource(const char* name) {
+    if (name == NULL || name[0] == '\0') {
+        return LOG_SOURCE_UNKNOWN;
+    }
+
+    uint32_t claimed = sourceClaimed.load(std::memory_order_acquire);
+    if (claimed > LOG_MAX_SOURCES) claimed = LOG_MAX_SOURCES;
+    for (uint32_t i = 0; i < claimed; i++) {
+        if (sourceReady[i].load(std::memory_order_acquire) &&
+            strncmp(sourceNames[i], name, LOG_SOURCE_NAME_MAX - 1) == 0) {
+            return (uint8_t)i;
+        }
+    }
+
+    // Yeni ad - aynı anda iki task aynı adı eklerse iki kimlik oluşur, zararsız
+    uint32_t index = sourceClaimed.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= LOG_MAX_SOURCES) {
+        return LOG_SOURCE_UNKNOWN;
+    }
+    strncpy(sourceNames[index], name, LOG_SOURCE_NAME_MAX - 1);
+    sourceNames[index][LOG_SOURCE_NAME_MAX - 1] = '\0';
+    logSourceMasks[index] = logDefaultMask;
+    sourceReady[index].store(true, std::memory_order_release);
+    return (uint8_t)index;
+}
+
+const char* logSourceName(uint8_t sourceId) {
+    if (sourceId < LOG_MAX_SOURCES && sourceReady[sourceId].load(std::memory_order_acquire)) {
+        return sourceNames[sourceId];
+    }
+    return "?";
+}
+
+uint8_t getLogSourceCount() {
+    uint32_t claimed = sourceClaimed.load(std::memory_order_acquire);
+    return claimed > LOG_MAX_SOURCES ? LOG_MAX_SOURCES : (uint8_t)claimed;
+}
+
+uint8_t getLogSourceMask(uint8_t sourceId) {
+    return sourceId < LOG_MAX_SOURCES ? logSourceMasks[sourceId] : logDefaultMask;
+}
+
+bool setLogSourceMask(const char* source, uint8_t mask) {
+    uint8_t sourceId = internLogSource(source);
+    if (sourceId >= LOG_MAX_SOURCES) {
+        return false;
+    }
+    logSourceMasks[sourceId] = mask & LOG_MASK_ALL;
+    return true;
+}
+
+// ==================== YAZMA ====================
+
+static void consoleTask(void* parameter);
+
+// Log sistemini başlatan fonksiyon - halkaya daha önce yazılanlar da konsola çıkar
+void initLogSystem() {
+    if (consoleTaskHandle == NULL) {
+        xTaskCreatePinnedToCore(
+            consoleTask,
+            "LogConsole",
+            LOG_CONSOLE_TASK_STACK,
+            NULL,
+            LOG_CONSOLE_TASK_PRIORITY,
+            &consoleTaskHandle,
+            LOG_CONSOLE_TASK_CORE
+        );
+    }
+    // Sistem başlatıldığında ilk logu ekle
+    LOG_INFO("SYSTEM", "Log sistemi başlatıldı.");
+}
+
+uint32_t logStoreString(const char* text, size_t length) {
+    uint32_t position = stringHead.fetch_add(length, std::memory_order_relaxed);
+    size_t offset = position & (LOG_STRING_ARENA - 1);
+    size_t first = length < LOG_STRING_ARENA - offset ? length : LOG_STRING_ARENA - offset;
+    memcpy(stringArena + offset, text, first);
+    memcpy(stringArena, text + first, length - first);
+    return position;
+}
+
+// LOG_* makrolarının hedefi - argümanlar paketlenmiş gelir, burada sadece kopyalanır
+void logCommit(LogLevel level, uint8_t sourceId, const char* format, const uint8_t* args,
+               uint8_t argLength, uint8_t flags) {
+    uint16_t ms;
+    uint32_t timestamp = currentTimestamp(flags, ms);
+
+    uint32_t sequence = logHead.fetch_add(1, std::memory_order_relaxed);
+    LogSlot& slot = ring[sequence & (LOG_RING_SIZE - 1)];
+
+    // Slotu sahiplen. Meşgulse (başka üretici tur bindirdi) ya da daha yeni bir sıra
+    // çoktan yazılmışsa bu girdi düşer - beklemek yok.
+    uint32_t observed = slot.commit.load(std::memory_order_relaxed);
+    if (observed == LOG_SLOT_BUSY || (observed != LOG_SLOT_EMPTY && (int32_t)(observed - (sequence + 1)) > 0) ||
+        !slot.commit.compare_exchange_strong(observed, LOG_SLOT_BUSY, std::memory_order_acquire)) {
+        droppedLogs.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogEntry& entry = slot.entry;
+    entry.sequence = sequence;
+    entry.timestamp = timestamp;
+    entry.millis = ms;
+    entry.level = (uint8_t)level;
+    entry.sourceId = sourceId;
+    entry.flags = flags;
+    entry.argLength = argLength;
+    entry.format = format;
+    memcpy(entry.args, args, argLength);
+
+    slot.commit.store(sequence + 1, std::memory_order_release);
+}
+
+// Yeni bir log ekleyen ana fonksiyon (hazır metin) - kaynak maskesine uyar
+void addLog(const char* msg, LogLevel level, const char* source) {
+    uint8_t sourceId = internLogSource(source);
+    if (isLogEnabled(sourceId, level)) {
+        logWrite(level, sourceId, "%s", msg ? msg : "");
+    }
+}
+
+void addLog(const String& msg, LogLevel level, const String& source) {
+    addLog(msg.c_str(), level, source.c_str());
+}
+
+// ==================== OKUMA ====================
+
+uint32_t getLogHead() {
+    return logHead.load(std::memory_order_acquire);
+}
+
+uint32_t getLogTail() {
+    uint32_t head = getLogHead();
+    uint32_t cleared = logCleared.load(std::memory_order_acquire);
+    uint32_t oldest = head > LOG_RING_SIZE ? head - LOG_RING_SIZE : 0;
+    return (int32_t)(cleared - oldest) > 0 ? cleared : oldest;
+}
+
+uint32_t getLogCount() {
+    return getLogHead() - getLogTail();
+}
+
+uint32_t getDroppedLogCount() {
+    return droppedLogs.load(std::memory_order_relaxed);
+}
+
+bool readLogEntry(uint32_t sequence, LogEntry& entry) {
+    if ((int32_t)(sequence - logCleared.load(std::memory_order_acquire)) < 0) {
+        return false;
+    }
+
+    const LogSlot& slot = ring[sequence & (LOG_RING_SIZE - 1)];
+    uint32_t before = slot.commit.load(std::memory_order_acquire);
+    if (before != sequence + 1) {
+        return false;
+    }
+    memcpy(&entry, &slot.entry, sizeof(entry));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.commit.load(std::memory_order_relaxed) == before;
+}
+
+// ==================== BİÇİMLENDİRME ====================
+
+struct LogArgReader {
+    const uint8_t* data;
+    uint8_t length;
+    uint8_t offset;
+
+    bool take(uint8_t expected, void* value, uint8_t size) {
+        if (offset + 1 + size > length || data[offset] != expected) {
+            offset = length;            // Uyuşmazlıkta kalan argümanlar da gösterilmez
+            return false;
+        }
+        memcpy(value, data + offset + 1, size);
+        offset += 1 + size;
+        return true;
+    }
+
+    bool takeInteger(bool isSigned, int64_t& value) {
+        if (offset < length && data[offset] == LOG_ARG_INT32) {
+            uint32_t narrow;
+            take(LOG_ARG_INT32, &narrow, 4);
+            value = isSigned ? (int64_t)(int32_t)narrow : (int64_t)narrow;
+            return true;
+        }
+        return take(LOG_ARG_INT64, &value, 8);
+    }
+
+    // out en az LOG_STRING_MAX + 1 byte. lost: metin halkada üzerine yazılmış.
+    bool takeString(char* out, bool& lost) {
+        lost = false;
+        if (offset + 2 > length) {
+            offset = length;
+            return false;
+        }
+        uint8_t size = data[offset + 1];
+
+        if (data[offset] == LOG_ARG_STRING && offset + 2 + size <= length) {
+            memcpy(out, data + offset + 2, size);
+            out[size] = '\0';
+            offset += 2 + size;
+            return true;
+        }
+        if (data[offset] == LOG_ARG_STRING_REF && offset + 6 <= length && size <= LOG_STRING_MAX) {
+            uint32_t position;
+            memcpy(&position, data + offset + 2, 4);
+            offset += 6;
+
+            size_t start = position & (LOG_STRING_ARENA - 1);
+            size_t first = size < LOG_STRING_ARENA - start ? size : LOG_STRING_ARENA - start;
+            memcpy(out, stringArena + start, first);
+            memcpy(out + first, stringArena, size - first);
+            out[size] = '\0';
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            lost = stringHead.load(std::memory_order_relaxed) - position > LOG_STRING_ARENA;
+            return true;
+        }
+
+        offset = length;
+        return false;
+    }
+};
+
+// Tek dönüşümü yaz. spec: '%' + bayrak/genişlik/duyarlık (uzunluk belirteci atılmış)
+static int renderLogArg(LogArgReader& reader, char* spec, size_t specLength, char conversion,
+                        char* out, size_t capacity) {
+    int64_t integer;
+    double real;
+    uint64_t address;
+    bool lost;
+
+    switch (conversion) {
+        case 'd': case 'i':
+            if (!reader.takeInteger(true, integer)) break;
+            memcpy(spec + specLength, "lld", 4);
+            return snprintf(out, capacity, spec, (long long)integer);
+        case 'u': case 'x': case 'X': case 'o':
+            if (!reader.takeInteger(false, integer)) break;
+            spec[specLength] = 'l';
+            spec[specLength + 1] = 'l';
+            spec[specLength + 2] = conversion;
+            spec[specLength + 3] = '\0';
+            return snprintf(out, capacity, spec, (unsigned long long)integer);
+        case 'c':
+            if (!reader.takeInteger(false, integer)) break;
+            memcpy(spec + specLength, "c", 2);
+            return snprintf(out, capacity, spec, (int)integer);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            if (!reader.take(LOG_ARG_DOUBLE, &real, sizeof(real))) break;
+            spec[specLength] = conversion;
+            spec[specLength + 1] = '\0';
+            return snprintf(out, capacity, spec, real);
+        case 's': {
+            char copy[LOG_STRING_MAX + 1];
+            if (!reader.takeString(copy, lost)) break;
+            memcpy(spec + specLength, "s", 2);
+            return snprintf(out, capacity, spec, lost ? "[...]" : copy);
+        }
+        case 'p':
+            if (!reader.take(LOG_ARG_POINTER, &address, sizeof(address))) break;
+            return snprintf(out, capacity, "0x%08lx", (unsigned long)address);
+        default:
+            break;
+    }
+    return snprintf(out, capacity, "?");
+}
+
+// Biçim dizgisini paketlenmiş argümanlarla metne çevir - sadece okuyucular çağırır
+size_t formatLogMessage(const LogEntry& entry, char* out, size_t capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+
+    LogArgReader reader = { entry.args, entry.argLength, 0 };
+    const char* format = entry.format != NULL ? entry.format : "";
+    size_t used = 0;
+
+    while (*format != '\0' && used + 1 < capacity) {
+        if (*format != '%') {
+            out[used++] = *format++;
+            continue;
+        }
+        format++;
+        if (*format == '%') {
+            out[used++] = '%';
+            format++;
+            continue;
+        }
+
+        char spec[16];
+        size_t specLength = 0;
+        spec[specLength++] = '%';
+        while (*format != '\0' && strchr("-+ #0123456789.", *format) != NULL && specLength < sizeof(spec) - 4) {
+            spec[specLength++] = *format++;
+        }
+        while (*format != '\0' && strchr("hlLqjzt", *format) != NULL) {
+            format++;               // Genişlik argümanın etiketinden gelir
+        }
+        char conversion = *format;
+        if (conversion == '\0') {
+            break;
+        }
+        format++;
+
+        int written = renderLogArg(reader, spec, specLength, conversion, out + used, capacity - used);
+        if (written > 0) {
+            used += (size_t)written < capacity - used ? (size_t)written : capacity - used - 1;
+        }
+    }
+
+    if ((entry.flags & LOG_FLAG_TRUNCATED) && used + 4 <= capacity) {
+        memcpy(out + used, "...", 3);
+        used += 3;
+    }
+    out[used] = '\0';
+    return used;
+}
+
+// ==================== KONSOL ====================
+
+struct ConsoleBatch {
+    char buffer[LOG_CONSOLE_BATCH];
+    size_t used;
+};
+
+static void flushConsole(ConsoleBatch& batch) {
+    if (batch.used > 0) {
+        Serial.write((const uint8_t*)batch.buffer, batch.used);
+        batch.used = 0;
+    }
+}
+
+static void appendConsole(ConsoleBatch& batch, const char* line, size_t length) {
+    if (batch.used + length > sizeof(batch.buffer)) {
+        flushConsole(batch);
+    }
+    if (length > sizeof(batch.buffer)) {
+        Serial.write((const uint8_t*)line, length);
+        return;
+    }
+    memcpy(batch.buffer + batch.used, line, length);
+    batch.used += length;
+}
+
+// Yeni girdileri toplu yaz. Yayınlanmamış girdi için birkaç tur beklenir;
+// üretici slotu alamadıysa hiç yayınlanmaz ve atlanır.
+static void drainConsole() {
+    static uint8_t stalls = 0;
+    uint32_t head = getLogHead();
+
+    if (!consoleEnabled) {
+        consoleCursor = head;
+        return;
+    }
+
+    uint32_t tail = getLogTail();
+    if ((int32_t)(consoleCursor - tail) < 0) {
+        // Temizleme sınırı ya da konsolun yetişemediği girdiler
+        if (head - consoleCursor > LOG_RING_SIZE) {
+            consoleDropped.fetch_add(tail - consoleCursor, std::memory_order_relaxed);
+        }
+        consoleCursor = tail;
+    }
+
+    static ConsoleBatch batch;
+    LogEntry entry;
+    char line[LOG_MESSAGE_MAX + 64];
+    char message[LOG_MESSAGE_MAX];
+    char timestamp[32];
+
+    while (consoleCursor != head) {
+        if (!readLogEntry(consoleCursor, entry)) {
+            if (head - consoleCursor < LOG_RING_SIZE && stalls < 3) {
+                stalls++;
+                break;
+            }
+            consoleDropped.fetch_add(1, std::memory_order_relaxed);
+            consoleCursor++;
+            stalls = 0;
+            continue;
+        }
+        stalls = 0;
+
+        formatLogTimestamp(entry, timestamp, sizeof(timestamp));
+        formatLogMessage(entry, message, sizeof(message));
+        int length = snprintf(line, sizeof(line), "[%s] [%s] [%s] %s\n", timestamp,
+                              logLevelName(entry.level), logSourceName(entry.sourceId), message);
+        if (length > 0) {
+            appendConsole(batch, line, (size_t)length < sizeof(line) ? length : sizeof(line) - 1);
+        }
+        consoleCursor++;
+    }
+    flushConsole(batch);
+
+    static uint32_t reportedDrops = 0;
+    uint32_t dropped = consoleDropped.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops) {
+        Serial.printf("[LOG] %lu satır konsola yazılamadı (toplam %lu)\n",
+                      (unsigned long)(dropped - reportedDrops), (unsigned long)dropped);
+        reportedDrops = dropped;
+    }
+}
+
+static void consoleTask(void* parameter) {
+    while (true) {
+        drainConsole();
+        processLogStore();
+        vTaskDelay(pdMS_TO_TICKS(LOG_CONSOLE_INTERVAL));
+    }
+}
+
+void setLogConsoleEnabled(bool enabled) {
+    if (consoleEnabled != enabled) {
+        LOG_INFO("SYSTEM", "Seri konsol log çıktısı %s", enabled ? "açıldı" : "kapatıldı");
+    }
+    consoleEnabled = enabled;
+}
+
+bool isLogConsoleEnabled() {
+    return consoleEnabled;
+}
+
+uint32_t getConsoleDroppedCount() {
+    return consoleDropped.load(std::memory_order_relaxed);
+}
+
+// ==================== YARDIMCI ====================
+
+const char* logLevelName(uint8_t level) {
+    switch (level) {
+        case ERROR:   return "ERROR";
+        case WARN:    return "WARN";
+        case INFO:    return "INFO";
+        case DEBUG:   return "DEBUG";
+        case SUCCESS: return "SUCCESS";
+        default:      return "UNKNOWN";
+    }
+}
+
+// Log seviyesini string'e çeviren yardımcı fonksiyon
+String logLevelToString(LogLevel level) {
+    return String(logLevelName(level));
+}
+
+// Tüm logları temizleyen fonksiyon - girdiler silinmez, okuma sınırı ilerler
+void clearLogs() {
+    logCleared.store(getLogHead(), std::memory_order_release);
+    LOG_WARN("SYSTEM", "Log kayıtları temizlendi.");
+}
@@ -6,6 +6,7 @@
 #include "settings.h"
 #include "log_system.h"
 #include "uart_handler.h"
+#include "uart_arbiter.h"
 #include "web_routes.h"
 #include "websocket_handler.h"
 #include "password_policy.h"
@@ -13,6 +14,10 @@
 #include "time_sync.h"
 #include "network_config.h"
 #include "ntp_handler.h"
+#include "fault_jobs.h"
+#include "fault_events.h"
+#include "fault_store.h"
+#include "log_store.h"
 
 // Task handle'ları
 TaskHandle_t webTaskHandle = NULL;
@@ -29,18 +34,21 @@ void checkSystemHealth();
 
 // Web server task - Core 0'da çalışacak
 void webServerTask(void *parameter) {
-    addLog("🌐 Web server task başlatıldı (Core 0)", INFO, "TASK");
+    LOG_INFO("TASK", "🌐 Web server task başlatıldı (Core 0)");
     
     while(true) {
         server.handleClient();
         handleWebSocket();
+        processFaultJobs();
+        processFaultEvents();
+        broadcastUARTStats();
         vTaskDelay(1);
     }
 }
 
 // UART ve zaman senkronizasyon task - Core 1'de
 void uartTask(void *parameter) {
-    addLog("📡 UART task başlatıldı (Core 1)", INFO, "TASK");
+    LOG_INFO("TASK", "📡 UART task başlatıldı (Core 1)");
     
     unsigned long lastTimeSync = 0;
     unsigned long lastUartHealth = 0;
@@ -60,13 +68,16 @@ void uartTask(void *parameter) {
             lastUartHealth = now;
         }
         
+        // Arıza deposu - yeni olay varsa hemen, yoksa dakikada bir artımlı senkronizasyon
+        processFaultStoreSync();
+        
         vTaskDelay(1000 / portTICK_PERIOD_MS);
     }
 }
 
 // Sistem monitoring task
 void systemTask(void *parameter) {
-    addLog("🔧 System monitoring task başlatıldı", INFO, "TASK");
+    LOG_INFO("TASK", "🔧 System monitoring task başlatıldı");
     
     unsigned long lastBackupCheck = 0;
     unsigned long lastEthCheck = 0;
@@ -89,11 +100,10 @@ void systemTask(void *parameter) {
             
             if (currentEthStatus != lastEthStatus) {
                 if (currentEthStatus) {
-                    addLog("✅ Ethernet yeniden bağlandı - IP: " + ETH.localIP().toString(), SUCCESS, "ETH");
-                    addLog("Hız: " + String(ETH.linkSpeed()) + " Mbps, " + 
-                           String(ETH.fullDuplex() ? "Full" : "Half") + " Duplex", INFO, "ETH");
+                    LOG_SUCCESS("ETH", "✅ Ethernet yeniden bağlandı - IP: %s", ETH.localIP().toString().c_str());
+                    LOG_INFO("ETH", "Hız: %d Mbps, %s Duplex", ETH.linkSpeed(), ETH.fullDuplex() ? "Full" : "Half");
                 } else {
-                    addLog("❌ Ethernet bağlantısı kesildi", ERROR, "ETH");
+                    LOG_ERROR("ETH", "❌ Ethernet bağlantısı kesildi");
                 }
                 lastEthStatus = currentEthStatus;
                 
@@ -120,7 +130,7 @@ void systemTask(void *parameter) {
         if (settings.isLoggedIn) {
             if (now - settings.sessionStartTime > settings.SESSION_TIMEOUT) {
                 settings.isLoggedIn = false;
-                addLog("⏰ Oturum zaman aşımı", INFO, "AUTH");
+                LOG_INFO("AUTH", "⏰ Oturum zaman aşımı");
                 
                 if (isWebSocketConnected()) {
                     broadcastLog("Oturum zaman aşımı nedeniyle sonlandırıldı", "WARNING", "AUTH");
@@ -151,7 +161,7 @@ void initMDNS() {
     sprintf(hostname, "teias-%02x%02x", mac[4], mac[5]);
     
     if (MDNS.begin(hostname)) {
-        addLog("✅ mDNS başlatıldı: " + String(hostname) + ".local", SUCCESS, "mDNS");
+        LOG_SUCCESS("mDNS", "✅ mDNS başlatıldı: %s.local", hostname);
         
         MDNS.addService("http", "tcp", 80);
         MDNS.addServiceTxt("http", "tcp", "device", "TEİAŞ EKLİM");
@@ -185,7 +195,7 @@ void initMDNS() {
         Serial.println("╚════════════════════════════════════════╝\n");
         
     } else {
-        addLog("❌ mDNS başlatılamadı", ERROR, "mDNS");
+        LOG_ERROR("mDNS", "❌ mDNS başlatılamadı");
     }
 }
 
@@ -194,9 +204,9 @@ void initWatchdog() {
     // ESP-IDF v4.4+ için eski API kullan (platform compatibility)
     if (esp_task_wdt_init(30, true) == ESP_OK) {  // 30 saniye timeout, panic enable
         esp_task_wdt_add(NULL); // Current task'ı ekle
-        addLog("🐕 Watchdog timer etkinleştirildi (30s)", INFO, "WDT");
+        LOG_INFO("WDT", "🐕 Watchdog timer etkinleştirildi (30s)");
     } else {
-        addLog("⚠️ Watchdog timer başlatılamadı", WARN, "WDT");
+        LOG_WARN("WDT", "⚠️ Watchdog timer başlatılamadı");
     }
 }
 
@@ -228,7 +238,7 @@ void setup() {
     Serial.print("► Dosya Sistemi (LittleFS)... ");
     if(!LittleFS.begin(true)){
         Serial.println("❌ HATA!");
-        addLog("❌ LittleFS başlatılamadı - RESTART", ERROR, "FS");
+        LOG_ERROR("FS", "❌ LittleFS başlatılamadı - RESTART");
         ESP.restart();
         return;
     }
@@ -241,6 +251,9 @@ void setup() {
     initLogSystem();
     Serial.println("✅");
     
+    Serial.print("► Kalıcı Log... ");
+    Serial.println(initLogStore() ? "✅" : "❌");
+    
     Serial.print("► Ayarlar... ");
     loadSettings();
     Serial.println("✅");
@@ -257,6 +270,14 @@ void setup() {
     initUART();
     Serial.println("✅");
     
+    // Hattın tek sahibi - tüm dsPIC istekleri bu task'ın kuyruğundan geçer
+    Serial.print("► UART Owner Task... ");
+    initUARTArbiter();
+    Serial.println("✅");
+    
+    Serial.print("► Arıza Deposu... ");
+    Serial.println(initFaultStore() ? "✅" : "❌");
+    
     Serial.print("► NTP Handler... ");
     initNTPHandler();
     Serial.println("✅");
@@ -334,9 +355,9 @@ void setup() {
     Serial.println("║");
     Serial.println("╚════════════════════════════════════════╝\n");
     
-    addLog("🚀 Sistem başlatıldı - Multi-core aktif", SUCCESS, "SYSTEM");
-    addLog("📍 Trafo Merkezi: " + settings.transformerStation, INFO, "SYSTEM");
-    addLog("🌐 IP Adresi: " + ETH.localIP().toString(), INFO, "SYSTEM");
+    LOG_SUCCESS("SYSTEM", "🚀 Sistem başlatıldı - Multi-core aktif");
+    LOG_INFO("SYSTEM", "📍 Trafo Merkezi: %s", settings.transformerStation.c_str());
+    LOG_INFO("SYSTEM", "🌐 IP Adresi: %s", ETH.localIP().toString().c_str());
 }
 
 // Sistem sağlık kontrolü - FONKSIYON TANIMLANDI
@@ -348,20 +369,21 @@ void checkSystemHealth() {
     }
     
     if (currentHeap < 20000) {
-        addLog("🚨 KRİTİK: Düşük bellek: " + String(currentHeap) + " bytes", ERROR, "SYSTEM");
+        LOG_ERROR("SYSTEM", "🚨 KRİTİK: Düşük bellek: %u bytes", (unsigned)currentHeap);
         systemStable = false;
         
         if (currentHeap < 10000) {
-            addLog("💥 ACİL DURUM: Bellek tükendi, yeniden başlatılıyor...", ERROR, "SYSTEM");
+            LOG_ERROR("SYSTEM", "💥 ACİL DURUM: Bellek tükendi, yeniden başlatılıyor...");
+            flushLogStore();
             delay(1000);
             ESP.restart();
         }
     } else if (currentHeap < 40000) {
-        addLog("⚠️ UYARI: Düşük bellek: " + String(currentHeap) + " bytes", WARN, "SYSTEM");
+        LOG_WARN("SYSTEM", "⚠️ UYARI: Düşük bellek: %u bytes", (unsigned)currentHeap);
         systemStable = false;
     } else {
         if (!systemStable) {
-            addLog("✅ Bellek durumu normale döndü: " + String(currentHeap) + " bytes", SUCCESS, "SYSTEM");
+            LOG_SUCCESS("SYSTEM", "✅ Bellek durumu normale döndü: %u bytes", (unsigned)currentHeap);
             systemStable = true;
         }
     }
@@ -372,16 +394,18 @@ void checkSystemHealth() {
         lastTaskCheck = millis();
         
         UBaseType_t taskCount = uxTaskGetNumberOfTasks();
-        addLog("📊 Aktif task sayısı: " + String(taskCount), DEBUG, "SYSTEM");
+        LOG_DEBUG("SYSTEM", "📊 Aktif task sayısı: %u", (unsigned)taskCount);
         
         // Task health check
         if (webTaskHandle && eTaskGetState(webTaskHandle) == eDeleted) {
-            addLog("❌ Web task crashed! Yeniden başlatılıyor...", ERROR, "TASK");
+            LOG_ERROR("TASK", "❌ Web task crashed! Yeniden başlatılıyor...");
+            flushLogStore();
             ESP.restart();
         }
         
         if (uartTaskHandle && eTaskGetState(uartTaskHandle) == eDeleted) {
-            addLog("❌ UART task crashed! Yeniden başlatılıyor...", ERROR, "TASK");
+            LOG_ERROR("TASK", "❌ UART task crashed! Yeniden başlatılıyor...");
+            flushLogStore();
             ESP.restart();
         }
     }
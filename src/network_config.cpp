@@ -30,27 +30,27 @@ void loadNetworkConfig() {
     // IP validasyonu ve atama
     if (!netConfig.staticIP.fromString(staticIPStr)) {
         netConfig.staticIP.fromString("192.168.1.160");
-        addLog("⚠️ Geçersiz statik IP, varsayılan kullanılıyor", WARN, "NET");
+        LOG_WARN("NET", "⚠️ Geçersiz statik IP, varsayılan kullanılıyor");
     }
     
     if (!netConfig.gateway.fromString(gatewayStr)) {
         netConfig.gateway.fromString("192.168.1.1");
-        addLog("⚠️ Geçersiz gateway, varsayılan kullanılıyor", WARN, "NET");
+        LOG_WARN("NET", "⚠️ Geçersiz gateway, varsayılan kullanılıyor");
     }
     
     if (!netConfig.subnet.fromString(subnetStr)) {
         netConfig.subnet.fromString("255.255.255.0");
-        addLog("⚠️ Geçersiz subnet, varsayılan kullanılıyor", WARN, "NET");
+        LOG_WARN("NET", "⚠️ Geçersiz subnet, varsayılan kullanılıyor");
     }
     
     if (!netConfig.dns1.fromString(dns1Str)) {
         netConfig.dns1.fromString("8.8.8.8");
-        addLog("⚠️ Geçersiz DNS1, varsayılan kullanılıyor", WARN, "NET");
+        LOG_WARN("NET", "⚠️ Geçersiz DNS1, varsayılan kullanılıyor");
     }
     
     if (!netConfig.dns2.fromString(dns2Str)) {
         netConfig.dns2.fromString("8.8.4.4");
-        addLog("⚠️ Geçersiz DNS2, varsayılan kullanılıyor", WARN, "NET");
+        LOG_WARN("NET", "⚠️ Geçersiz DNS2, varsayılan kullanılıyor");
     }
     
     prefs.end();
@@ -63,10 +63,10 @@ void loadNetworkConfig() {
         settings.primaryDNS = netConfig.dns1;
     }
     
-    addLog("✅ Network konfigürasyonu yüklendi", SUCCESS, "NET");
-    addLog("DHCP: " + String(netConfig.useDHCP ? "Aktif" : "Pasif"), INFO, "NET");
+    LOG_SUCCESS("NET", "✅ Network konfigürasyonu yüklendi");
+    LOG_INFO("NET", "DHCP: %s", netConfig.useDHCP ? "Aktif" : "Pasif");
     if (!netConfig.useDHCP) {
-        addLog("Statik IP: " + netConfig.staticIP.toString(), INFO, "NET");
+        LOG_INFO("NET", "Statik IP: %s", netConfig.staticIP.toString().c_str());
     }
 }
 
@@ -76,23 +76,23 @@ void saveNetworkConfig(bool useDHCP, String ip, String gw, String sn, String d1,
     IPAddress testIP;
     if (!useDHCP) {
         if (!testIP.fromString(ip)) {
-            addLog("❌ Geçersiz IP adresi: " + ip, ERROR, "NET");
+            LOG_ERROR("NET", "❌ Geçersiz IP adresi: %s", ip.c_str());
             return;
         }
         if (!testIP.fromString(gw)) {
-            addLog("❌ Geçersiz Gateway adresi: " + gw, ERROR, "NET");
+            LOG_ERROR("NET", "❌ Geçersiz Gateway adresi: %s", gw.c_str());
             return;
         }
         if (!testIP.fromString(sn)) {
-            addLog("❌ Geçersiz Subnet adresi: " + sn, ERROR, "NET");
+            LOG_ERROR("NET", "❌ Geçersiz Subnet adresi: %s", sn.c_str());
             return;
         }
         if (d1.length() > 0 && !testIP.fromString(d1)) {
-            addLog("❌ Geçersiz DNS1 adresi: " + d1, ERROR, "NET");
+            LOG_ERROR("NET", "❌ Geçersiz DNS1 adresi: %s", d1.c_str());
             return;
         }
         if (d2.length() > 0 && !testIP.fromString(d2)) {
-            addLog("❌ Geçersiz DNS2 adresi: " + d2, ERROR, "NET");
+            LOG_ERROR("NET", "❌ Geçersiz DNS2 adresi: %s", d2.c_str());
             return;
         }
     }
@@ -126,7 +126,7 @@ void saveNetworkConfig(bool useDHCP, String ip, String gw, String sn, String d1,
         settings.primaryDNS = netConfig.dns1;
     }
     
-    addLog("✅ Network konfigürasyonu kaydedildi", SUCCESS, "NET");
+    LOG_SUCCESS("NET", "✅ Network konfigürasyonu kaydedildi");
 }
 
 // Network config JSON döndür 
@@ -157,7 +157,7 @@ String getNetworkConfigJSON() {
 
 // Ethernet başlatma - GELİŞTİRİLMİŞ VERSİYON
 void initEthernetAdvanced() {
-    addLog("🌐 Gelişmiş Ethernet başlatılıyor...", INFO, "ETH");
+    LOG_INFO("ETH", "🌐 Gelişmiş Ethernet başlatılıyor...");
     
     // WT32-ETH01 için doğru pin konfigürasyonu
     // RMII interface kullanıyor
@@ -171,54 +171,54 @@ void initEthernetAdvanced() {
     );
     
     // MAC address'i logla
-    addLog("MAC Adresi: " + ETH.macAddress(), INFO, "ETH");
+    LOG_INFO("ETH", "MAC Adresi: %s", ETH.macAddress().c_str());
     
     // Network konfigürasyonuna göre IP ayarla
     if (!netConfig.useDHCP) {
-        addLog("Statik IP konfigürasyonu uygulanıyor...", INFO, "ETH");
+        LOG_INFO("ETH", "Statik IP konfigürasyonu uygulanıyor...");
         
         if (!ETH.config(netConfig.staticIP, netConfig.gateway, netConfig.subnet, netConfig.dns1, netConfig.dns2)) {
-            addLog("❌ Statik IP konfigürasyonu başarısız!", ERROR, "ETH");
-            addLog("DHCP'ye geri dönülüyor...", WARN, "ETH");
+            LOG_ERROR("ETH", "❌ Statik IP konfigürasyonu başarısız!");
+            LOG_WARN("ETH", "DHCP'ye geri dönülüyor...");
             
             // DHCP'ye fallback
             netConfig.useDHCP = true;
             ETH.config(INADDR_NONE, INADDR_NONE, INADDR_NONE, INADDR_NONE);
         } else {
-            addLog("✅ Statik IP konfigürasyonu başarılı", SUCCESS, "ETH");
-            addLog("IP: " + netConfig.staticIP.toString(), INFO, "ETH");
-            addLog("Gateway: " + netConfig.gateway.toString(), INFO, "ETH");
-            addLog("Subnet: " + netConfig.subnet.toString(), INFO, "ETH");
-            addLog("DNS1: " + netConfig.dns1.toString(), INFO, "ETH");
+            LOG_SUCCESS("ETH", "✅ Statik IP konfigürasyonu başarılı");
+            LOG_INFO("ETH", "IP: %s", netConfig.staticIP.toString().c_str());
+            LOG_INFO("ETH", "Gateway: %s", netConfig.gateway.toString().c_str());
+            LOG_INFO("ETH", "Subnet: %s", netConfig.subnet.toString().c_str());
+            LOG_INFO("ETH", "DNS1: %s", netConfig.dns1.toString().c_str());
         }
     } else {
-        addLog("DHCP ile IP adresi alınıyor...", INFO, "ETH");
+        LOG_INFO("ETH", "DHCP ile IP adresi alınıyor...");
     }
     
     // Bağlantı bekleme (max 15 saniye)
     unsigned long startTime = millis();
     const unsigned long CONNECT_TIMEOUT = 15000;
     
-    addLog("Ethernet bağlantısı bekleniyor...", INFO, "ETH");
+    LOG_INFO("ETH", "Ethernet bağlantısı bekleniyor...");
     
     while (!ETH.linkUp() && millis() - startTime < CONNECT_TIMEOUT) {
         delay(100);
         
         // Her 2 saniyede bir durum güncelle
         if ((millis() - startTime) % 2000 == 0) {
-            addLog("Bağlantı bekleniyor... (" + String((millis() - startTime) / 1000) + "s)", DEBUG, "ETH");
+            LOG_DEBUG("ETH", "Bağlantı bekleniyor... (%lus)", (millis() - startTime) / 1000);
         }
     }
     
     if (ETH.linkUp()) {
         // Bağlantı başarılı
-        addLog("🎉 Ethernet bağlantısı başarılı!", SUCCESS, "ETH");
-        addLog("📍 IP Adresi: " + ETH.localIP().toString(), SUCCESS, "ETH");
-        addLog("🚪 Gateway: " + ETH.gatewayIP().toString(), INFO, "ETH");
-        addLog("🔍 Subnet Mask: " + ETH.subnetMask().toString(), INFO, "ETH");
-        addLog("🌐 DNS: " + ETH.dnsIP().toString(), INFO, "ETH");
-        addLog("⚡ Link Hızı: " + String(ETH.linkSpeed()) + " Mbps", INFO, "ETH");
-        addLog("🔀 Duplex: " + String(ETH.fullDuplex() ? "Full" : "Half"), INFO, "ETH");
+        LOG_SUCCESS("ETH", "🎉 Ethernet bağlantısı başarılı!");
+        LOG_SUCCESS("ETH", "📍 IP Adresi: %s", ETH.localIP().toString().c_str());
+        LOG_INFO("ETH", "🚪 Gateway: %s", ETH.gatewayIP().toString().c_str());
+        LOG_INFO("ETH", "🔍 Subnet Mask: %s", ETH.subnetMask().toString().c_str());
+        LOG_INFO("ETH", "🌐 DNS: %s", ETH.dnsIP().toString().c_str());
+        LOG_INFO("ETH", "⚡ Link Hızı: %d Mbps", ETH.linkSpeed());
+        LOG_INFO("ETH", "🔀 Duplex: %s", ETH.fullDuplex() ? "Full" : "Half");
         
         // DHCP'den alınan IP'yi settings'e kaydet
         if (netConfig.useDHCP) {
@@ -227,18 +227,18 @@ void initEthernetAdvanced() {
             settings.subnet = ETH.subnetMask();
             settings.primaryDNS = ETH.dnsIP();
             
-            addLog("DHCP bilgileri settings'e kaydedildi", DEBUG, "ETH");
+            LOG_DEBUG("ETH", "DHCP bilgileri settings'e kaydedildi");
         }
         
         // Network test
-        addLog("🔗 Network erişilebilirlik testi yapılıyor...", INFO, "ETH");
+        LOG_INFO("ETH", "🔗 Network erişilebilirlik testi yapılıyor...");
         // Bu kısımda ping test'i eklenebilir
         
     } else {
         // Bağlantı başarısız
-        addLog("❌ Ethernet bağlantısı başarısız!", ERROR, "ETH");
-        addLog("🔌 Kablo bağlantısını kontrol edin", WARN, "ETH");
-        addLog("⚙️ Network ayarlarını kontrol edin", WARN, "ETH");
+        LOG_ERROR("ETH", "❌ Ethernet bağlantısı başarısız!");
+        LOG_WARN("ETH", "🔌 Kablo bağlantısını kontrol edin");
+        LOG_WARN("ETH", "⚙️ Network ayarlarını kontrol edin");
         
         // Fallback IP ayarları (emergency access)
         settings.local_IP.fromString("192.168.1.160");
@@ -246,31 +246,31 @@ void initEthernetAdvanced() {
         settings.subnet.fromString("255.255.255.0");
         settings.primaryDNS.fromString("8.8.8.8");
         
-        addLog("🆘 Acil durum IP ayarları yüklendi", WARN, "ETH");
+        LOG_WARN("ETH", "🆘 Acil durum IP ayarları yüklendi");
     }
     
     // Ethernet event handler'ları ayarla
     WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t info) {
         switch (event) {
             case ARDUINO_EVENT_ETH_START:
-                addLog("🔄 Ethernet başlatıldı", INFO, "ETH");
+                LOG_INFO("ETH", "🔄 Ethernet başlatıldı");
                 break;
             case ARDUINO_EVENT_ETH_CONNECTED:
-                addLog("🔌 Ethernet kablosu bağlandı", SUCCESS, "ETH");
+                LOG_SUCCESS("ETH", "🔌 Ethernet kablosu bağlandı");
                 break;
             case ARDUINO_EVENT_ETH_GOT_IP:
-                addLog("📶 IP adresi alındı: " + ETH.localIP().toString(), SUCCESS, "ETH");
+                LOG_SUCCESS("ETH", "📶 IP adresi alındı: %s", ETH.localIP().toString().c_str());
                 break;
             case ARDUINO_EVENT_ETH_DISCONNECTED:
-                addLog("🔌 Ethernet kablosu çıkarıldı", ERROR, "ETH");
+                LOG_ERROR("ETH", "🔌 Ethernet kablosu çıkarıldı");
                 break;
             case ARDUINO_EVENT_ETH_STOP:
-                addLog("🛑 Ethernet durduruldu", WARN, "ETH");
+                LOG_WARN("ETH", "🛑 Ethernet durduruldu");
                 break;
             default:
                 break;
         }
     });
     
-    addLog("✅ Ethernet Advanced Init tamamlandı", SUCCESS, "ETH");
+    LOG_SUCCESS("ETH", "✅ Ethernet Advanced Init tamamlandı");
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ bool requestNTPFromBackend() {
     
     // getNTP komutu gönder
     if (!sendCustomCommand("getNTP", response, 3000)) {
-        addLog("❌ dsPIC33EP'den NTP bilgisi alınamadı", ERROR, "NTP");
+        LOG_ERROR("NTP", "❌ dsPIC33EP'den NTP bilgisi alınamadı");
         return false;
     }
     
@@ -35,19 +35,19 @@ bool requestNTPFromBackend() {
             server1.toCharArray(ntpConfig.ntpServer1, sizeof(ntpConfig.ntpServer1));
             server2.toCharArray(ntpConfig.ntpServer2, sizeof(ntpConfig.ntpServer2));
             
-            addLog("✅ NTP sunucuları dsPIC33EP'den alındı: " + server1 + ", " + server2, SUCCESS, "NTP");
+            LOG_SUCCESS("NTP", "✅ NTP sunucuları dsPIC33EP'den alındı: %s, %s", server1.c_str(), server2.c_str());
             return true;
         }
     }
     
-    addLog("❌ Geçersiz NTP yanıt formatı: " + response, ERROR, "NTP");
+    LOG_ERROR("NTP", "❌ Geçersiz NTP yanıt formatı: %s", response.c_str());
     return false;
 }
 
 // NTP ayarlarını dsPIC33EP'ye gönder
 void sendNTPConfigToBackend() {
     if (strlen(ntpConfig.ntpServer1) == 0) {
-        addLog("NTP sunucu adresi boş", WARN, "NTP");
+        LOG_WARN("NTP", "NTP sunucu adresi boş");
         return;
     }
     
@@ -57,12 +57,12 @@ void sendNTPConfigToBackend() {
     
     if (sendCustomCommand(command, response, 2000)) {
         if (response == "ACK" || response.indexOf("OK") >= 0) {
-            addLog("✅ NTP ayarları dsPIC33EP tarafından onaylandı", SUCCESS, "NTP");
+            LOG_SUCCESS("NTP", "✅ NTP ayarları dsPIC33EP tarafından onaylandı");
         } else {
-            addLog("dsPIC33EP yanıtı: " + response, WARN, "NTP");
+            LOG_WARN("NTP", "dsPIC33EP yanıtı: %s", response.c_str());
         }
     } else {
-        addLog("⚠️ NTP ayarları için yanıt alınamadı", WARN, "NTP");
+        LOG_WARN("NTP", "⚠️ NTP ayarları için yanıt alınamadı");
     }
 }
 
@@ -98,7 +98,7 @@ bool loadNTPSettings() {
     preferences.end();
     
     ntpConfigured = true;
-    addLog("✅ NTP ayarları yüklendi", SUCCESS, "NTP");
+    LOG_SUCCESS("NTP", "✅ NTP ayarları yüklendi");
     return true;
 }
 
@@ -121,12 +121,12 @@ bool isValidIPOrDomain(const String& address) {
 
 bool saveNTPSettings(const String& server1, const String& server2, int timezone) {
     if (!isValidIPOrDomain(server1)) {
-        addLog("Geçersiz birincil NTP sunucu", ERROR, "NTP");
+        LOG_ERROR("NTP", "Geçersiz birincil NTP sunucu");
         return false;
     }
     
     if (server2.length() > 0 && !isValidIPOrDomain(server2)) {
-        addLog("Geçersiz ikincil NTP sunucu", ERROR, "NTP");
+        LOG_ERROR("NTP", "Geçersiz ikincil NTP sunucu");
         return false;
     }
     
@@ -147,7 +147,7 @@ bool saveNTPSettings(const String& server1, const String& server2, int timezone)
     ntpConfig.enabled = true;
     ntpConfigured = true;
     
-    addLog("✅ NTP ayarları kaydedildi", SUCCESS, "NTP");
+    LOG_SUCCESS("NTP", "✅ NTP ayarları kaydedildi");
     
     // dsPIC33EP'ye gönder
     sendNTPConfigToBackend();
@@ -158,7 +158,7 @@ bool saveNTPSettings(const String& server1, const String& server2, int timezone)
 void initNTPHandler() {
     // NTP ayarları yükleme
     if (!loadNTPSettings()) {
-        addLog("⚠️ Kayıtlı NTP ayarı bulunamadı, varsayılanlar kullanılıyor", WARN, "NTP");
+        LOG_WARN("NTP", "⚠️ Kayıtlı NTP ayarı bulunamadı, varsayılanlar kullanılıyor");
         // Varsayılan ayarları yükle
         strcpy(ntpConfig.ntpServer1, "pool.ntp.org");
         strcpy(ntpConfig.ntpServer2, "time.google.com");
@@ -171,7 +171,7 @@ void initNTPHandler() {
     delay(1000); // Backend'in hazır olmasını bekle
     sendNTPConfigToBackend();
     
-    addLog("✅ NTP Handler başlatıldı", SUCCESS, "NTP");
+    LOG_SUCCESS("NTP", "✅ NTP Handler başlatıldı");
 }
 
 // Eski fonksiyonları inline yap (çoklu tanımlama hatası için)
@@ -208,5 +208,5 @@ void resetNTPSettings() {
     
     ntpConfigured = false;
     
-    addLog("NTP ayarları sıfırlandı", INFO, "NTP");
+    LOG_INFO("NTP", "NTP ayarları sıfırlandı");
 }
\ No newline at end of file
@@ -37,7 +37,7 @@ void loadPasswordPolicy() {
     
     prefs.end();
     
-    addLog("Parola politikası yüklendi", INFO, "POLICY");
+    LOG_INFO("POLICY", "Parola politikası yüklendi");
 }
 
 // Parola politikasını kaydet
@@ -373,7 +373,7 @@ void handlePasswordChangeAPI() {
     String hashedCurrent = sha256(currentPassword, settings.passwordSalt);
     if (hashedCurrent != settings.passwordHash) {
         server.send(400, "application/json", "{\"error\":\"Mevcut parola yanlış\"}");
-        addLog("❌ Parola değiştirme başarısız: Yanlış mevcut parola", ERROR, "AUTH");
+        LOG_ERROR("AUTH", "❌ Parola değiştirme başarısız: Yanlış mevcut parola");
         return;
     }
     
@@ -418,7 +418,7 @@ void handlePasswordChangeAPI() {
     passwordPolicy.lastPasswordChange = millis();
     savePasswordPolicy();
     
-    addLog("✅ Parola başarıyla değiştirildi", SUCCESS, "AUTH");
+    LOG_SUCCESS("AUTH", "✅ Parola başarıyla değiştirildi");
     
     server.send(200, "application/json", "{\"success\":true,\"message\":\"Parola değiştirildi\"}");
     
@@ -48,9 +48,9 @@ void loadSettings() {
 
     // BaudRate
     long baudRate = prefs.getLong("baudrate", 115200);
-    const long validBaudRates[] = {9600, 19200, 38400, 57600, 115200};
+    const long validBaudRates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
     bool validBaud = false;
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < 8; i++) {
         if (baudRate == validBaudRates[i]) {
             validBaud = true;
             break;
@@ -73,7 +73,7 @@ void loadSettings() {
         prefs.putString("p_hash", settings.passwordHash);
         prefs.putString("username", settings.username);
         
-        addLog("Varsayılan parola: 1234", WARN, "SETTINGS");
+        LOG_WARN("SETTINGS", "Varsayılan parola: 1234");
     }
 
     prefs.end();
@@ -83,7 +83,7 @@ void loadSettings() {
     settings.sessionStartTime = 0;
     settings.SESSION_TIMEOUT = 1800000; // 30 dakika
 
-    addLog("Ayarlar yüklendi", SUCCESS, "SETTINGS");
+    LOG_SUCCESS("SETTINGS", "Ayarlar yüklendi");
 }
 
 bool saveSettings(const String& newDevName, const String& newTmName, const String& newUsername, const String& newPassword) {
@@ -128,28 +128,28 @@ bool saveSettings(const String& newDevName, const String& newTmName, const Strin
         prefs.putString("p_salt", settings.passwordSalt);
         prefs.putString("p_hash", settings.passwordHash);
         
-        addLog("Parola güncellendi", SUCCESS, "SETTINGS");
+        LOG_SUCCESS("SETTINGS", "Parola güncellendi");
         
         // Oturumu sonlandır
         settings.isLoggedIn = false;
     }
 
     prefs.end();
-    addLog("Ayarlar kaydedildi", SUCCESS, "SETTINGS");
+    LOG_SUCCESS("SETTINGS", "Ayarlar kaydedildi");
     return true;
 }
 
 void initEthernet() {
-    addLog("Ethernet başlatılıyor...", INFO, "ETH");
+    LOG_INFO("ETH", "Ethernet başlatılıyor...");
     
     // WT32-ETH01 için doğru pinler
     ETH.begin(1, 16, 23, 18, ETH_PHY_LAN8720, ETH_CLOCK_GPIO17_OUT);
     
     // Statik IP
     if (!ETH.config(settings.local_IP, settings.gateway, settings.subnet, settings.primaryDNS)) {
-        addLog("❌ Statik IP atanamadı!", ERROR, "ETH");
+        LOG_ERROR("ETH", "❌ Statik IP atanamadı!");
     } else {
-        addLog("✅ IP: " + settings.local_IP.toString(), SUCCESS, "ETH");
+        LOG_SUCCESS("ETH", "✅ IP: %s", settings.local_IP.toString().c_str());
     }
 
     // Bağlantı bekleme - max 5 saniye
@@ -159,8 +159,8 @@ void initEthernet() {
     }
     
     if (ETH.linkUp()) {
-        addLog("✅ Ethernet aktif", SUCCESS, "ETH");
+        LOG_SUCCESS("ETH", "✅ Ethernet aktif");
     } else {
-        addLog("⚠️ Ethernet kablosu bağlı değil", WARN, "ETH");
+        LOG_WARN("ETH", "⚠️ Ethernet kablosu bağlı değil");
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 // time_sync.cpp - Düzeltilmiş ve İyileştirilmiş Versiyon
 #include "time_sync.h"
 #include "uart_handler.h"
+#include "uart_breaker.h"
 #include "log_system.h"
 #include <time.h>
 
@@ -17,14 +18,14 @@ void updateSystemTime();
 // Tarih formatla: DDMMYY -> DD.MM.20YY - İYİLEŞTİRİLMİŞ
 String formatDate(const String& dateStr) {
     if (dateStr.length() != 6) {
-        addLog("❌ Geçersiz tarih formatı uzunluğu: " + String(dateStr.length()), ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Geçersiz tarih formatı uzunluğu: %u", dateStr.length());
         return "Geçersiz";
     }
     
     // Numeric validation
     for (int i = 0; i < 6; i++) {
         if (!isDigit(dateStr.charAt(i))) {
-            addLog("❌ Tarihte numeric olmayan karakter: " + String(dateStr.charAt(i)), ERROR, "TIME");
+            LOG_ERROR("TIME", "❌ Tarihte numeric olmayan karakter: %c", dateStr.charAt(i));
             return "Geçersiz";
         }
     }
@@ -35,7 +36,7 @@ String formatDate(const String& dateStr) {
     
     // Date validation
     if (day < 1 || day > 31 || month < 1 || month > 12 || year < 2020 || year > 2050) {
-        addLog("❌ Geçersiz tarih değerleri: " + String(day) + "/" + String(month) + "/" + String(year), ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Geçersiz tarih değerleri: %d/%d/%d", day, month, year);
         return "Geçersiz";
     }
     
@@ -47,14 +48,14 @@ String formatDate(const String& dateStr) {
 // Saat formatla: HHMMSS -> HH:MM:SS - İYİLEŞTİRİLMİŞ
 String formatTime(const String& timeStr) {
     if (timeStr.length() != 6) {
-        addLog("❌ Geçersiz saat formatı uzunluğu: " + String(timeStr.length()), ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Geçersiz saat formatı uzunluğu: %u", timeStr.length());
         return "Geçersiz";
     }
     
     // Numeric validation
     for (int i = 0; i < 6; i++) {
         if (!isDigit(timeStr.charAt(i))) {
-            addLog("❌ Saatte numeric olmayan karakter: " + String(timeStr.charAt(i)), ERROR, "TIME");
+            LOG_ERROR("TIME", "❌ Saatte numeric olmayan karakter: %c", timeStr.charAt(i));
             return "Geçersiz";
         }
     }
@@ -65,7 +66,7 @@ String formatTime(const String& timeStr) {
     
     // Time validation
     if (hour > 23 || minute > 59 || second > 59) {
-        addLog("❌ Geçersiz saat değerleri: " + String(hour) + ":" + String(minute) + ":" + String(second), ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Geçersiz saat değerleri: %02d:%02d:%02d", hour, minute, second);
         return "Geçersiz";
     }
     
@@ -77,7 +78,7 @@ String formatTime(const String& timeStr) {
 // ESP32 sistem saatini güncelle - İYİLEŞTİRİLMİŞ
 void updateSystemTime() {
     if (!timeData.isValid || timeData.lastDate == "Geçersiz" || timeData.lastTime == "Geçersiz") {
-        addLog("❌ Geçersiz zaman verisi, sistem saati güncellenemiyor", ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Geçersiz zaman verisi, sistem saati güncellenemiyor");
         return;
     }
     
@@ -85,12 +86,12 @@ void updateSystemTime() {
     int day, month, year, hour, minute, second;
     
     if (sscanf(timeData.lastDate.c_str(), "%d.%d.%d", &day, &month, &year) != 3) {
-        addLog("❌ Tarih parse hatası: " + timeData.lastDate, ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Tarih parse hatası: %s", timeData.lastDate.c_str());
         return;
     }
     
     if (sscanf(timeData.lastTime.c_str(), "%d:%d:%d", &hour, &minute, &second) != 3) {
-        addLog("❌ Saat parse hatası: " + timeData.lastTime, ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Saat parse hatası: %s", timeData.lastTime.c_str());
         return;
     }
     
@@ -107,31 +108,31 @@ void updateSystemTime() {
     // Validate the time structure
     time_t t = mktime(&timeinfo);
     if (t == -1) {
-        addLog("❌ Sistem saati oluşturulamadı", ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Sistem saati oluşturulamadı");
         return;
     }
     
     // Sistem saatini ayarla
     struct timeval now = { .tv_sec = t, .tv_usec = 0 };
     if (settimeofday(&now, NULL) == 0) {
-        addLog("✅ Sistem saati güncellendi: " + timeData.lastDate + " " + timeData.lastTime, SUCCESS, "TIME");
+        LOG_SUCCESS("TIME", "✅ Sistem saati güncellendi: %s %s", timeData.lastDate.c_str(), timeData.lastTime.c_str());
         
         // Timezone ayarla (Türkiye saati - UTC+3)
         setenv("TZ", "TRT-3", 1);
         tzset();
     } else {
-        addLog("❌ Sistem saati ayarlanamadı", ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Sistem saati ayarlanamadı");
     }
 }
 
 // dsPIC'ten gelen zaman verisini parse et - İYİLEŞTİRİLMİŞ
 bool parseTimeResponse(const String& response) {
     if (response.length() < 6) {
-        addLog("❌ Zaman yanıtı çok kısa: " + String(response.length()), ERROR, "TIME");
+        LOG_ERROR("TIME", "❌ Zaman yanıtı çok kısa: %u", response.length());
         return false;
     }
     
-    addLog("🔍 Zaman yanıtı parse ediliyor: " + response, DEBUG, "TIME");
+    LOG_DEBUG("TIME", "🔍 Zaman yanıtı parse ediliyor: %s", response.c_str());
     
     // Format 1: "DATE:DDMMYY,TIME:HHMMSS"
     if (response.indexOf("DATE:") >= 0 && response.indexOf("TIME:") >= 0) {
@@ -153,7 +154,7 @@ bool parseTimeResponse(const String& response) {
                 if (formattedDate != "Geçersiz" && formattedTime != "Geçersiz") {
                     timeData.lastDate = formattedDate;
                     timeData.lastTime = formattedTime;
-                    addLog("✅ Format 1 parse başarılı: " + formattedDate + " " + formattedTime, DEBUG, "TIME");
+                    LOG_DEBUG("TIME", "✅ Format 1 parse başarılı: %s %s", formattedDate.c_str(), formattedTime.c_str());
                     return true;
                 }
             }
@@ -171,7 +172,7 @@ bool parseTimeResponse(const String& response) {
         if (formattedDate != "Geçersiz" && formattedTime != "Geçersiz") {
             timeData.lastDate = formattedDate;
             timeData.lastTime = formattedTime;
-            addLog("✅ Format 2 parse başarılı: " + formattedDate + " " + formattedTime, DEBUG, "TIME");
+            LOG_DEBUG("TIME", "✅ Format 2 parse başarılı: %s %s", formattedDate.c_str(), formattedTime.c_str());
             return true;
         }
     }
@@ -181,7 +182,7 @@ bool parseTimeResponse(const String& response) {
         String formattedDate = formatDate(response);
         if (formattedDate != "Geçersiz") {
             timeData.lastDate = formattedDate;
-            addLog("✅ Sadece tarih parse edildi: " + formattedDate, DEBUG, "TIME");
+            LOG_DEBUG("TIME", "✅ Sadece tarih parse edildi: %s", formattedDate.c_str());
             return true;
         }
     }
@@ -195,7 +196,7 @@ bool parseTimeResponse(const String& response) {
             String formattedDate = formatDate(dataOnly);
             if (formattedDate != "Geçersiz") {
                 timeData.lastDate = formattedDate;
-                addLog("✅ Checksum'lı tarih parse edildi: " + formattedDate, DEBUG, "TIME");
+                LOG_DEBUG("TIME", "✅ Checksum'lı tarih parse edildi: %s", formattedDate.c_str());
                 return true;
             }
         } else if (checksum >= 'a' && checksum <= 'z') { // Saat
@@ -203,13 +204,13 @@ bool parseTimeResponse(const String& response) {
             if (formattedTime != "Geçersiz") {
                 timeData.lastTime = formattedTime;
                 timeData.isValid = true;
-                addLog("✅ Checksum'lı saat parse edildi: " + formattedTime, DEBUG, "TIME");
+                LOG_DEBUG("TIME", "✅ Checksum'lı saat parse edildi: %s", formattedTime.c_str());
                 return true;
             }
         }
     }
     
-    addLog("❌ Hiçbir format eşleşmedi: " + response, WARN, "TIME");
+    LOG_WARN("TIME", "❌ Hiçbir format eşleşmedi: %s", response.c_str());
     return false;
 }
 
@@ -222,18 +223,24 @@ bool requestTimeFromDsPIC() {
     }
     lastSyncAttempt = now;
     
+    // Hat yanıt vermiyor - 4 komut x 3 sn boşuna beklenmez
+    if (isUARTCircuitOpen()) {
+        return timeData.isValid;
+    }
+    
     String response;
     
     // Zaman isteği komutu gönder - birden fazla komut dene
     String commands[] = {"GETTIME", "TIME", "DT", "DATETIME"};
     bool success = false;
     
-    for (int i = 0; i < 4 && !success; i++) {
-        addLog("🔄 Zaman komutu gönderiliyor: " + commands[i], DEBUG, "TIME");
+    for (int i = 0; i < 4 && !success && !isUARTCircuitOpen(); i++) {
+        LOG_DEBUG("TIME", "🔄 Zaman komutu gönderiliyor: %s", commands[i].c_str());
         
-        if (sendCustomCommand(commands[i], response, 3000)) {
+        // Arka plan önceliği - web arayüzü istekleri sırada öne geçer
+        if (sendCustomCommand(commands[i], response, 3000, UART_PRIORITY_BACKGROUND)) {
             if (response.length() > 0) {
-                addLog("📥 Yanıt alındı (" + String(response.length()) + " byte): " + response, DEBUG, "TIME");
+                LOG_DEBUG("TIME", "📥 Yanıt alındı (%u byte): %s", response.length(), response.c_str());
                 
                 if (parseTimeResponse(response)) {
                     success = true;
@@ -253,8 +260,8 @@ bool requestTimeFromDsPIC() {
         // Error flag'i sıfırla
         timeSyncErrorLogged = false;
         
-        addLog("✅ Zaman senkronize edildi (#" + String(timeData.syncCount) + "): " + 
-               timeData.lastDate + " " + timeData.lastTime, SUCCESS, "TIME");
+        LOG_SUCCESS("TIME", "✅ Zaman senkronize edildi (#%d): %s %s",
+                timeData.syncCount, timeData.lastDate.c_str(), timeData.lastTime.c_str());
         
         // Sistem saatini güncelle
         updateSystemTime();
@@ -263,14 +270,14 @@ bool requestTimeFromDsPIC() {
     } else {
         // Sadece hata daha önce loglanmadıysa logla
         if (!timeSyncErrorLogged) {
-            addLog("❌ dsPIC'ten zaman bilgisi alınamadı (tüm komutlar denendi)", ERROR, "TIME");
+            LOG_ERROR("TIME", "❌ dsPIC'ten zaman bilgisi alınamadı (tüm komutlar denendi)");
             timeSyncErrorLogged = true;
         }
         
         // Uzun süre senkronizasyon yoksa geçerliliği kaldır
         if (timeData.isValid && (now - timeData.lastSync > 1800000)) { // 30 dakika
             timeData.isValid = false;
-            addLog("⚠️ Zaman verisi eskidi, geçerlilik kaldırıldı", WARN, "TIME");
+            LOG_WARN("TIME", "⚠️ Zaman verisi eskidi, geçerlilik kaldırıldı");
         }
         
         return false;
@@ -294,19 +301,19 @@ void checkTimeSync() {
         if (requestTimeFromDsPIC()) {
             if (!firstSyncDone) {
                 firstSyncDone = true;
-                addLog("🎯 İlk zaman senkronizasyonu tamamlandı", SUCCESS, "TIME");
+                LOG_SUCCESS("TIME", "🎯 İlk zaman senkronizasyonu tamamlandı");
             }
         }
     }
     
     // Zaman geçerliliğini kontrol et (15 dakika timeout)
     if (timeData.isValid && (now - timeData.lastSync > 900000)) {
-        addLog("⚠️ Zaman senkronizasyonu 15 dakikadır yok, geçerlilik sorgulanıyor...", WARN, "TIME");
+        LOG_WARN("TIME", "⚠️ Zaman senkronizasyonu 15 dakikadır yok, geçerlilik sorgulanıyor...");
         
         // Acil senkronizasyon denemesi
         if (!requestTimeFromDsPIC()) {
             timeData.isValid = false;
-            addLog("❌ Zaman senkronizasyonu kayıp", ERROR, "TIME");
+            LOG_ERROR("TIME", "❌ Zaman senkronizasyonu kayıp");
         }
     }
 }
@@ -0,0 +1,734 @@
+// uart_arbiter.cpp - UART sahibi task ve öncelikli istek kuyruğu
+#include "uart_arbiter.h"
+#include "uart_handler.h"
+#include "uart_protocol.h"
+#include "uart_link.h"
+#include "uart_rate.h"
+#include "uart_lzss.h"
+#include "uart_stats.h"
+#include "uart_breaker.h"
+#include "log_system.h"
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+UARTArbiterStats uartArbiterStats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// Öncelik başına kuyruk (UARTTransaction* taşır). Yeni istek ve gelen veri
+// owner task'ı task bildirimi ile uyandırır.
+static QueueHandle_t priorityQueues[UART_PRIORITY_COUNT] = {NULL, NULL, NULL};
+static TaskHandle_t ownerTaskHandle = NULL;
+static volatile bool reinitRequested = false;
+
+// Kuyrukta en fazla bekleme (son başlama zamanı) - öncelik başına varsayılan
+static const unsigned long defaultQueueWait[UART_PRIORITY_COUNT] = {5000, 10000, 30000};
+
+// Owner task'ın frame yanıt tamponu (task stack'inde değil)
+static UARTFrame replyFrame;
+
+// Senkron çağıranların transaction havuzu. Sayaç semaforu boş yuva sayısını tutar,
+// yuva seçimi kısa kritik bölgede yapılır.
+static UARTTransaction callerPool[UART_CALLER_POOL_SIZE];
+static bool callerPoolBusy[UART_CALLER_POOL_SIZE];
+static SemaphoreHandle_t callerPoolSlots = NULL;
+static StaticSemaphore_t callerPoolSlotsStorage;
+static portMUX_TYPE callerPoolLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Sıkıştırılmış yanıtlar - aynı anda tek akış açılır (pencere istekleri tek blokluk)
+static CompressedFrameReader lzssReader;
+
+// Boru hattı penceresi - yanıtı beklenen sıralı FRAME istekleri
+struct WindowSlot {
+    UARTTransaction* transaction;           // NULL: boş slot
+    uint8_t sequence;
+    uint8_t retries;
+    unsigned long sentAt;
+};
+
+static WindowSlot window[UART_PIPELINE_WINDOW];
+static uint8_t inflightCount = 0;
+
+static void completeTransaction(UARTTransaction* transaction, UARTTransactionStatus status) {
+    transaction->status = status;
+    transaction->completedAt = millis();
+
+    if (status == UART_STATUS_EXPIRED) {
+        uartArbiterStats.expired++;
+    } else if (status == UART_STATUS_CIRCUIT_OPEN) {
+        uartArbiterStats.rejected++;
+    } else {
+        uartArbiterStats.completed++;
+    }
+    recordUARTTransaction(*transaction);
+    uartBreakerRecord(status);
+
+    if (transaction->callback) {
+        transaction->callback(transaction, transaction->context);
+    }
+
+    // Give sonrası çağıran belleği serbest bırakabilir - transaction'a bir daha dokunma
+    if (transaction->done) {
+        xSemaphoreGive(transaction->done);
+    }
+}
+
+static UARTTransactionStatus runTextTransaction(UARTTransaction* transaction) {
+    // Önceki yanıtlardan kalan byte'lar bu isteğin yanıtına karışmasın
+    flushLinkInput();
+
+    if (uartLinkWrite(transaction->request, transaction->requestLength) != transaction->requestLength ||
+        uartLinkWrite((const uint8_t*)"\r\n", 2) != 2) {
+        return UART_STATUS_ERROR;
+    }
+
+    size_t length = readUARTLine((char*)transaction->response, sizeof(transaction->response), transaction->timeoutMs);
+    transaction->responseLength = length;
+    return length > 0 ? UART_STATUS_OK : UART_STATUS_TIMEOUT;
+}
+
+// İstek komutu - sıkıştırma izni komut başına verilir, dsPIC desteklemiyorsa gönderilmez
+static uint8_t wireCommand(const UARTTransaction* transaction) {
+    if (transaction->compressReply && peerSupports(CAP_LZSS)) {
+        return transaction->command | CMD_FLAG_COMPRESS;
+    }
+    return transaction->command;
+}
+
+static void storeResponse(UARTTransaction* transaction, const UARTFrame& frame) {
+    transaction->responseCommand = frame.command;
+    transaction->responseLength = frame.dataLength;
+    memcpy(transaction->response, frame.data, frame.dataLength);
+    transaction->response[frame.dataLength] = '\0';
+}
+
+// CMD_LZSS_BLOCK verisini açar; açılan kayıtlar lzssReader handler'ına gider. true: son blok
+static bool pushCompressedBlock(const UARTFrame& block) {
+    uint32_t inBefore = lzssReader.bytesIn();
+    uint32_t outBefore = lzssReader.bytesOut();
+    bool last = lzssReader.pushBlock(block.data, block.dataLength);
+    uartArbiterStats.compressedBytes += lzssReader.bytesIn() - inBefore;
+    uartArbiterStats.inflatedBytes += lzssReader.bytesOut() - outBefore;
+    return last;
+}
+
+static bool storeInflatedResponse(const UARTFrame& frame, void* context) {
+    storeResponse(static_cast<UARTTransaction*>(context), frame);
+    return false; // Tek yanıt - sonrası yok sayılır
+}
+
+// Tek frame yanıtı: düz ya da tek blokluk sıkıştırılmış akış içinde tek kayıt
+static UARTTransactionStatus acceptResponse(UARTTransaction* transaction, const UARTFrame& frame) {
+    if (frame.command != CMD_LZSS_BLOCK) {
+        storeResponse(transaction, frame);
+    } else {
+        transaction->responseCommand = 0;   // Geçerli komut değil - kayıt çıkmazsa hata
+        transaction->responseLength = 0;
+        lzssReader.begin(storeInflatedResponse, transaction);
+        if (!pushCompressedBlock(frame) || lzssReader.failed() || transaction->responseCommand == 0) {
+            LOG_ERROR("UART", "❌ Sıkıştırılmış yanıt açılamadı");
+            return UART_STATUS_ERROR;
+        }
+    }
+    return transaction->responseCommand == CMD_NACK ? UART_STATUS_NACK : UART_STATUS_OK;
+}
+
+static UARTTransactionStatus runFrameTransaction(UARTTransaction* transaction) {
+    if (!sendCommandFrame(wireCommand(transaction), transaction->request, transaction->requestLength)) {
+        return UART_STATUS_ERROR;
+    }
+
+    if (!receiveFrame(replyFrame, transaction->timeoutMs)) {
+        return UART_STATUS_TIMEOUT;
+    }
+
+    return acceptResponse(transaction, replyFrame);
+}
+
+// Akış durumu - düz ve açılmış frame'ler aynı işleyiciden geçer
+struct StreamProgress {
+    UARTTransaction* transaction;
+    UARTTransactionStatus status;           // PENDING: akış sürüyor
+};
+
+static bool handleStreamFrame(const UARTFrame& frame, void* context) {
+    StreamProgress* progress = static_cast<StreamProgress*>(context);
+    UARTTransaction* transaction = progress->transaction;
+
+    if (frame.command == CMD_NACK) {
+        progress->status = UART_STATUS_NACK;
+        return false;
+    }
+
+    if (frame.command == transaction->streamEndCommand) {
+        storeResponse(transaction, frame);
+        progress->status = UART_STATUS_OK;
+        return false;
+    }
+
+    transaction->streamFrames++;
+    transaction->streamBytes += frame.dataLength;
+    if (transaction->frameSink) {
+        transaction->frameSink(frame, transaction->sinkContext);
+    }
+    return true;
+}
+
+// Tek istek, çok yanıt: her frame sink'e gider, bitiş frame'i response'a yazılır.
+// Timeout frame'ler arası uygulanır, böylece uzun aktarımlar düşük hızda da tamamlanır.
+// Sıkıştırılmış bloklar geldikçe açılır; yanıtın tamamı bellekte tutulmaz.
+static UARTTransactionStatus runStreamTransaction(UARTTransaction* transaction) {
+    if (!sendCommandFrame(wireCommand(transaction), transaction->request, transaction->requestLength)) {
+        return UART_STATUS_ERROR;
+    }
+
+    StreamProgress progress = {transaction, UART_STATUS_PENDING};
+    bool compressedOpen = false;
+
+    while (progress.status == UART_STATUS_PENDING && receiveFrame(replyFrame, transaction->timeoutMs)) {
+        if (replyFrame.command != CMD_LZSS_BLOCK) {
+            handleStreamFrame(replyFrame, &progress);
+            continue;
+        }
+
+        if (!compressedOpen) {
+            lzssReader.begin(handleStreamFrame, &progress);
+            compressedOpen = true;
+        }
+        if (pushCompressedBlock(replyFrame)) {
+            compressedOpen = false;
+        }
+        if (lzssReader.failed()) {
+            LOG_ERROR("UART", "❌ Sıkıştırılmış akış bozuk");
+            return UART_STATUS_ERROR;
+        }
+    }
+
+    // PENDING: akış yarıda kesildi - sink'e verilen frame'ler geçerli, bitiş bilgisi yok
+    return progress.status == UART_STATUS_PENDING ? UART_STATUS_TIMEOUT : progress.status;
+}
+
+// Başlamadan önce son başlama zamanını kontrol et; geçtiyse EXPIRED ile tamamlanır
+static bool admitTransaction(UARTTransaction* transaction) {
+    unsigned long now = millis();
+
+    // Son başlama zamanı geçtiyse hatta hiç gönderme - çağıran zaten vazgeçmiş olabilir
+    if ((long)(now - transaction->deadline) > 0) {
+        LOG_WARN("UART", "⏱️ UART isteği kuyrukta süresi doldu (%lums)", now - transaction->queuedAt);
+        completeTransaction(transaction, UART_STATUS_EXPIRED);
+        return false;
+    }
+
+    // Devre kesici açık ya da yarı açıkken deneme zaten hatta - boşuna timeout bekleme
+    if (!uartBreakerAdmit()) {
+        completeTransaction(transaction, UART_STATUS_CIRCUIT_OPEN);
+        return false;
+    }
+
+    transaction->startedAt = now;
+    unsigned long queueWait = now - transaction->queuedAt;
+    if (queueWait > uartArbiterStats.maxQueueWaitMs) {
+        uartArbiterStats.maxQueueWaitMs = queueWait;
+    }
+    return true;
+}
+
+static void runTransaction(UARTTransaction* transaction) {
+    if (!admitTransaction(transaction)) {
+        return;
+    }
+
+    UARTTransactionStatus status;
+    switch (transaction->kind) {
+        case UART_TRANSACTION_FRAME:  status = runFrameTransaction(transaction);  break;
+        case UART_TRANSACTION_STREAM: status = runStreamTransaction(transaction); break;
+        default:                      status = runTextTransaction(transaction);   break;
+    }
+    completeTransaction(transaction, status);
+}
+
+// En yüksek öncelikli bekleyen isteğe bak (aynı öncelikte FIFO). Kuyruktan
+// yalnızca owner task aldığı için sonraki dequeueTransaction aynı isteği döndürür.
+static UARTTransaction* peekNextTransaction(int& priority) {
+    UARTTransaction* transaction = NULL;
+    for (int p = 0; p < UART_PRIORITY_COUNT; p++) {
+        if (xQueuePeek(priorityQueues[p], &transaction, 0) == pdTRUE) {
+            priority = p;
+            return transaction;
+        }
+    }
+    return NULL;
+}
+
+static void dequeueTransaction(int priority) {
+    UARTTransaction* transaction;
+    xQueueReceive(priorityQueues[priority], &transaction, 0);
+}
+
+// ==================== BORU HATTI (SIRALI PROTOKOL) ====================
+// FRAME istekleri yanıt beklenmeden pencere dolana kadar gönderilir; yanıtlar
+// sıra numarası ile eşleştirilir. Checksum hatası ya da timeout sadece ilgili
+// isteğin yeniden gönderilmesine yol açar. dsPIC tekrar gelen sıra numarası için
+// komutu yeniden çalıştırmaz, önbellekteki yanıtı gönderir.
+
+// Toplam timeout deneme sayısına bölünür - tüm denemeler timeoutMs civarında biter
+static unsigned long attemptTimeout(const WindowSlot& slot) {
+    unsigned long perAttempt = slot.transaction->timeoutMs / (UART_MAX_RETRANSMITS + 1);
+    return perAttempt > UART_MIN_ATTEMPT_TIMEOUT ? perAttempt : UART_MIN_ATTEMPT_TIMEOUT;
+}
+
+static void releaseSlot(WindowSlot& slot, UARTTransactionStatus status) {
+    UARTTransaction* transaction = slot.transaction;
+    slot.transaction = NULL;
+    inflightCount--;
+    completeTransaction(transaction, status);
+}
+
+static bool transmitSlot(WindowSlot& slot) {
+    UARTTransaction* transaction = slot.transaction;
+    slot.sentAt = millis();
+    if (!sendSequencedFrame(wireCommand(transaction), slot.sequence, transaction->request, transaction->requestLength)) {
+        releaseSlot(slot, UART_STATUS_ERROR);
+        return false;
+    }
+    return true;
+}
+
+// Deneme hakkı varsa yeniden gönder, yoksa TIMEOUT ile tamamla
+static void retransmitSlot(WindowSlot& slot) {
+    if (slot.retries >= UART_MAX_RETRANSMITS) {
+        releaseSlot(slot, UART_STATUS_TIMEOUT);
+        return;
+    }
+    slot.retries++;
+    slot.transaction->retries++;
+    uartArbiterStats.retransmits++;
+    transmitSlot(slot);
+}
+
+static WindowSlot* oldestSlot() {
+    WindowSlot* oldest = NULL;
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        if (window[i].transaction && (oldest == NULL || (long)(window[i].sentAt - oldest->sentAt) < 0)) {
+            oldest = &window[i];
+        }
+    }
+    return oldest;
+}
+
+static void startPipelined(UARTTransaction* transaction) {
+    // Pencere boşken hatta kalan eski byte'lar yeni yanıtlara karışmasın
+    if (inflightCount == 0) {
+        flushLinkInput();
+    }
+
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        WindowSlot& slot = window[i];
+        if (slot.transaction == NULL) {
+            slot.transaction = transaction;
+            slot.sequence = nextFrameSequence();
+            slot.retries = 0;
+            inflightCount++;
+            if (inflightCount > uartArbiterStats.peakInflight) {
+                uartArbiterStats.peakInflight = inflightCount;
+            }
+            transmitSlot(slot);
+            return;
+        }
+    }
+}
+
+// Çözücü handler'ı - gelen frame'i sıra numarasıyla bekleyen isteğe eşle
+static bool onWindowFrame(const UARTFrame& frame, void* context) {
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        WindowSlot& slot = window[i];
+        if (slot.transaction == NULL || slot.sequence != frame.sequence) {
+            continue;
+        }
+
+        // dsPIC isteği bozuk aldı - aynı sıra ile yeniden gönder
+        if (frame.command == CMD_NACK && frame.dataLength >= 1 && frame.data[0] == NACK_REASON_CHECKSUM) {
+            retransmitSlot(slot);
+            return true;
+        }
+
+        releaseSlot(slot, acceptResponse(slot.transaction, frame));
+        return true;
+    }
+
+    // Tamamlanmış ya da iptal edilmiş isteğin geç/tekrar yanıtı
+    uartArbiterStats.staleResponses++;
+    return true;
+}
+
+static void abortWindow(UARTTransactionStatus status) {
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        if (window[i].transaction) {
+            releaseSlot(window[i], status);
+        }
+    }
+}
+
+// Pencereyi bir adım ilerlet: veri ya da en yakın deneme süresi dolana kadar bekle,
+// gelen yanıtları eşle, bozuk/eksik yanıtları yeniden iste
+static void serviceWindow() {
+    unsigned long now = millis();
+    unsigned long wait = UART_OWNER_IDLE_INTERVAL;
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        if (window[i].transaction) {
+            unsigned long elapsed = now - window[i].sentAt;
+            unsigned long limit = attemptTimeout(window[i]);
+            unsigned long remaining = elapsed >= limit ? 0 : limit - elapsed;
+            if (remaining < wait) wait = remaining;
+        }
+    }
+
+    // Yeni istek bildirimi de uyandırır; pencerede yer varsa bir sonraki turda gönderilir
+    if (uartLinkAvailable() == 0 && wait > 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    }
+
+    uint32_t checksumErrors = pumpReceivedFrames(onWindowFrame, NULL);
+
+    // Art arda hatalar protokolü sıfırladı - sıra numarasız hatta pencere sürdürülemez
+    if (!linkProtocol.sequenced) {
+        LOG_WARN("UART", "⚠️ Protokol sıfırlandı - bekleyen %u istek iptal", inflightCount);
+        abortWindow(UART_STATUS_ERROR);
+        return;
+    }
+
+    // Bozuk frame'in sırası bilinemez - en eski bekleyen yanıtı yeniden iste
+    if (checksumErrors > 0) {
+        WindowSlot* oldest = oldestSlot();
+        if (oldest) {
+            retransmitSlot(*oldest);
+        }
+    }
+
+    now = millis();
+    for (int i = 0; i < UART_PIPELINE_WINDOW; i++) {
+        WindowSlot& slot = window[i];
+        if (slot.transaction && now - slot.sentAt >= attemptTimeout(slot)) {
+            retransmitSlot(slot);
+        }
+    }
+}
+
+// Kuyruktaki istekleri başlat. Sıralı FRAME istekleri pencereye girer; metin,
+// akış ve sırasız frame istekleri hattı tek başına kullanır (pencere boşalınca).
+// false: bekleyen iş yok ya da pencere boşalmayı bekliyor.
+static bool dispatchTransactions() {
+    int priority;
+    UARTTransaction* transaction = peekNextTransaction(priority);
+    if (transaction == NULL) {
+        return false;
+    }
+
+    bool pipelined = linkProtocol.sequenced && transaction->kind == UART_TRANSACTION_FRAME;
+    if (!pipelined) {
+        if (inflightCount > 0) {
+            return false;
+        }
+        dequeueTransaction(priority);
+        runTransaction(transaction);
+        return true;
+    }
+
+    if (inflightCount >= linkProtocol.window) {
+        return false;
+    }
+
+    dequeueTransaction(priority);
+    if (admitTransaction(transaction)) {
+        startPipelined(transaction);
+    }
+    return true;
+}
+
+// İstekler arasında yapılan bakım - hat bu sırada başka kimseye ait değil
+static void runMaintenance() {
+    if (reinitRequested) {
+        reinitRequested = false;
+        initUART();
+    }
+
+    // Protokol sürümü el sıkışması (açılışta ve UART yeniden başlatıldığında)
+    if (!linkProtocol.negotiated) {
+        negotiateProtocolVersion();
+    }
+
+    // Yüksek hız anlaşması (el sıkışmadan sonra) ve hata oranına göre geri düşme
+    if (!linkRate.negotiated) {
+        negotiateLinkRate();
+    }
+    checkLinkRateHealth();
+
+    // Boşta gelen arıza olayları - veri bildirimi owner task'ı uyandırır
+    if (peerSupports(CAP_FAULT_EVENT) && uartLinkAvailable() > 0) {
+        pumpReceivedFrames(NULL, NULL);
+    }
+}
+
+static void uartOwnerTask(void* parameter) {
+    LOG_INFO("TASK", "📡 UART owner task başlatıldı (Core %d)", UART_OWNER_TASK_CORE);
+
+    uartLinkSetDataNotify(xTaskGetCurrentTaskHandle());
+
+    while (true) {
+        // Bakım hattı ele alır - sadece pencere boşken
+        if (inflightCount == 0) {
+            if (getUARTQueueDepth() == 0) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UART_OWNER_IDLE_INTERVAL));
+            }
+            runMaintenance();
+        }
+
+        // Pencere dolana ya da sıradaki istek hattı tek başına isteyene kadar gönder
+        while (dispatchTransactions() && inflightCount > 0) {
+        }
+
+        if (inflightCount > 0) {
+            serviceWindow();
+        }
+    }
+}
+
+bool initUARTArbiter() {
+    if (ownerTaskHandle != NULL) {
+        return true;
+    }
+
+    for (int p = 0; p < UART_PRIORITY_COUNT; p++) {
+        priorityQueues[p] = xQueueCreate(UART_QUEUE_DEPTH, sizeof(UARTTransaction*));
+    }
+
+    if (priorityQueues[0] == NULL || priorityQueues[1] == NULL || priorityQueues[2] == NULL) {
+        LOG_ERROR("UART", "❌ UART istek kuyrukları oluşturulamadı");
+        return false;
+    }
+
+    callerPoolSlots = xSemaphoreCreateCountingStatic(UART_CALLER_POOL_SIZE, UART_CALLER_POOL_SIZE,
+                                                     &callerPoolSlotsStorage);
+
+    xTaskCreatePinnedToCore(
+        uartOwnerTask,
+        "UART_Owner",
+        UART_OWNER_TASK_STACK,
+        NULL,
+        UART_OWNER_TASK_PRIORITY,
+        &ownerTaskHandle,
+        UART_OWNER_TASK_CORE
+    );
+
+    return ownerTaskHandle != NULL;
+}
+
+bool isUARTOwnerTask() {
+    return ownerTaskHandle != NULL && xTaskGetCurrentTaskHandle() == ownerTaskHandle;
+}
+
+static void resetTransaction(UARTTransaction& transaction, UARTPriority priority, unsigned long timeoutMs) {
+    transaction.priority = priority;
+    transaction.command = 0;
+    transaction.requestLength = 0;
+    transaction.timeoutMs = timeoutMs;
+    transaction.deadline = 0;
+    transaction.compressReply = false;
+    transaction.streamEndCommand = 0;
+    transaction.streamFrames = 0;
+    transaction.frameSink = NULL;
+    transaction.sinkContext = NULL;
+    transaction.status = UART_STATUS_PENDING;
+    transaction.responseCommand = 0;
+    transaction.responseLength = 0;
+    transaction.response[0] = '\0';
+    transaction.streamBytes = 0;
+    transaction.retries = 0;
+    transaction.queuedAt = 0;
+    transaction.startedAt = 0;
+    transaction.completedAt = 0;
+    transaction.done = NULL;
+    transaction.callback = NULL;
+    transaction.context = NULL;
+}
+
+bool prepareTextTransaction(UARTTransaction& transaction, const String& line,
+                            unsigned long timeoutMs, UARTPriority priority) {
+    resetTransaction(transaction, priority, timeoutMs);
+    transaction.kind = UART_TRANSACTION_TEXT;
+
+    if (line.length() == 0 || line.length() > UART_TX_MAX_REQUEST) {
+        transaction.status = UART_STATUS_REJECTED;
+        return false;
+    }
+
+    memcpy(transaction.request, line.c_str(), line.length());
+    transaction.requestLength = line.length();
+    return true;
+}
+
+bool prepareFrameTransaction(UARTTransaction& transaction, uint8_t command, const uint8_t* data,
+                             uint16_t dataLength, unsigned long timeoutMs, UARTPriority priority) {
+    resetTransaction(transaction, priority, timeoutMs == 0 ? FRAME_TIMEOUT : timeoutMs);
+    transaction.kind = UART_TRANSACTION_FRAME;
+    transaction.command = command;
+
+    if (dataLength > UART_TX_MAX_REQUEST || (dataLength > 0 && data == nullptr)) {
+        LOG_ERROR("UART", "❌ Frame verisi çok büyük: %u/%d", dataLength, UART_TX_MAX_REQUEST);
+        transaction.status = UART_STATUS_REJECTED;
+        return false;
+    }
+
+    if (dataLength > 0) {
+        memcpy(transaction.request, data, dataLength);
+    }
+    transaction.requestLength = dataLength;
+    return true;
+}
+
+bool prepareStreamTransaction(UARTTransaction& transaction, uint8_t command, const uint8_t* data,
+                              uint16_t dataLength, uint8_t endCommand, UARTFrameSink sink, void* sinkContext,
+                              unsigned long frameTimeoutMs, UARTPriority priority) {
+    if (!prepareFrameTransaction(transaction, command, data, dataLength, frameTimeoutMs, priority)) {
+        return false;
+    }
+
+    transaction.kind = UART_TRANSACTION_STREAM;
+    transaction.streamEndCommand = endCommand;
+    transaction.frameSink = sink;
+    transaction.sinkContext = sinkContext;
+    return true;
+}
+
+bool submitUARTTransaction(UARTTransaction* transaction) {
+    if (transaction == NULL || transaction->status != UART_STATUS_PENDING) {
+        return false;
+    }
+
+    if (ownerTaskHandle == NULL || transaction->priority >= UART_PRIORITY_COUNT) {
+        uartArbiterStats.rejected++;
+        transaction->status = UART_STATUS_REJECTED;
+        return false;
+    }
+
+    // Hat yanıt vermiyor - kuyrukta beklemeden hemen hata
+    if (isUARTCircuitOpen()) {
+        uartBreakerStats.rejected++;
+        transaction->status = UART_STATUS_CIRCUIT_OPEN;
+        return false;
+    }
+
+    transaction->queuedAt = millis();
+    if (transaction->deadline == 0) {
+        transaction->deadline = transaction->queuedAt + defaultQueueWait[transaction->priority];
+    }
+
+    // Kuyruk doluysa bekleme - çağıran hemen hata alır
+    if (xQueueSend(priorityQueues[transaction->priority], &transaction, 0) != pdTRUE) {
+        uartArbiterStats.rejected++;
+        transaction->status = UART_STATUS_REJECTED;
+        LOG_WARN("UART", "⚠️ UART istek kuyruğu dolu - istek reddedildi");
+        return false;
+    }
+
+    xTaskNotifyGive(ownerTaskHandle);
+    return true;
+}
+
+bool executeUARTTransaction(UARTTransaction& transaction) {
+    if (transaction.status != UART_STATUS_PENDING) {
+        return false;
+    }
+
+    // Owner task kendi kuyruğunu bekleyemez - doğrudan çalıştır. Kuyruk beklemesi
+    // olmadığından son başlama zamanı, çağıran vermediyse, yanıt süresi kadar ileride.
+    if (isUARTOwnerTask()) {
+        transaction.queuedAt = millis();
+        if (transaction.deadline == 0) {
+            transaction.deadline = transaction.queuedAt + transaction.timeoutMs;
+        }
+        runTransaction(&transaction);
+        return transaction.status == UART_STATUS_OK;
+    }
+
+    transaction.done = xSemaphoreCreateBinaryStatic(&transaction.doneStorage);
+    if (!submitUARTTransaction(&transaction)) {
+        return false;
+    }
+
+    // Owner her isteği deadline + timeout içinde tamamlar; erken dönmek
+    // owner'ın çağıranın stack'ine yazmasına yol açacağından süresiz beklenir
+    xSemaphoreTake(transaction.done, portMAX_DELAY);
+    return transaction.status == UART_STATUS_OK;
+}
+
+UARTTransaction* acquireUARTTransaction() {
+    if (callerPoolSlots == NULL) {
+        return NULL;
+    }
+
+    // Owner task beklerse yuvayı tutan çağıranlar hiç tamamlanmaz - beklemeden dene
+    TickType_t wait = isUARTOwnerTask() ? 0 : pdMS_TO_TICKS(UART_CALLER_POOL_WAIT_MS);
+    if (xSemaphoreTake(callerPoolSlots, wait) != pdTRUE) {
+        uartArbiterStats.rejected++;
+        LOG_WARN("UART", "⚠️ UART çağıran havuzu dolu - istek reddedildi");
+        return NULL;
+    }
+
+    UARTTransaction* transaction = NULL;
+    portENTER_CRITICAL(&callerPoolLock);
+    for (int i = 0; i < UART_CALLER_POOL_SIZE; i++) {
+        if (!callerPoolBusy[i]) {
+            callerPoolBusy[i] = true;
+            transaction = &callerPool[i];
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&callerPoolLock);
+    return transaction;
+}
+
+void releaseUARTTransaction(UARTTransaction* transaction) {
+    if (transaction == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&callerPoolLock);
+    callerPoolBusy[transaction - callerPool] = false;
+    portEXIT_CRITICAL(&callerPoolLock);
+    xSemaphoreGive(callerPoolSlots);
+}
+
+String transactionResponseString(const UARTTransaction& transaction) {
+    String response;
+    response.reserve(transaction.responseLength);
+    for (uint16_t i = 0; i < transaction.responseLength; i++) {
+        response += (char)transaction.response[i];
+    }
+    return response;
+}
+
+const char* transactionStatusToString(UARTTransactionStatus status) {
+    switch (status) {
+        case UART_STATUS_PENDING:      return "pending";
+        case UART_STATUS_OK:           return "ok";
+        case UART_STATUS_TIMEOUT:      return "timeout";
+        case UART_STATUS_NACK:         return "nack";
+        case UART_STATUS_EXPIRED:      return "expired";
+        case UART_STATUS_REJECTED:     return "rejected";
+        case UART_STATUS_ERROR:        return "error";
+        case UART_STATUS_CIRCUIT_OPEN: return "circuit_open";
+    }
+    return "unknown";
+}
+
+void scheduleUARTReinit() {
+    reinitRequested = true;
+}
+
+uint8_t getUARTQueueDepth() {
+    uint8_t depth = 0;
+    for (int p = 0; p < UART_PRIORITY_COUNT; p++) {
+        if (priorityQueues[p]) {
+            depth += uxQueueMessagesWaiting(priorityQueues[p]);
+        }
+    }
+    return depth;
+}
@@ -0,0 +1,127 @@
+// uart_breaker.cpp - dsPIC hattı devre kesicisi (kapalı/açık/yarı açık, üstel bekleme)
+#include "uart_breaker.h"
+#include "uart_protocol.h"
+#include "log_system.h"
+
+UARTBreakerStats uartBreakerStats = {0, 0, 0, 0};
+
+// Durum owner task'ta değişir; diğer task'lar sadece isUARTCircuitOpen ile okur
+static volatile UARTBreakerState breakerState = UART_BREAKER_CLOSED;
+static volatile unsigned long openUntil = 0;
+static uint8_t consecutiveFailures = 0;
+static uint8_t openStreak = 0;              // Başarılı yanıt gelmeden art arda açılma
+static unsigned long currentBackoff = 0;
+static bool probeInFlight = false;
+
+static const char* stateToString(UARTBreakerState state) {
+    switch (state) {
+        case UART_BREAKER_OPEN:      return "open";
+        case UART_BREAKER_HALF_OPEN: return "half_open";
+        default:                     return "closed";
+    }
+}
+
+static void tripBreaker() {
+    if (openStreak < 255) openStreak++;
+
+    // base * 2^(n-1), üst sınırlı; jitter birden fazla cihazın aynı anda denemesini dağıtır
+    unsigned long backoff = UART_BREAKER_BASE_BACKOFF;
+    for (uint8_t i = 1; i < openStreak && backoff < UART_BREAKER_MAX_BACKOFF; i++) {
+        backoff *= 2;
+    }
+    if (backoff > UART_BREAKER_MAX_BACKOFF) backoff = UART_BREAKER_MAX_BACKOFF;
+    long jitter = (long)(backoff * UART_BREAKER_JITTER_PERCENT / 100);
+    backoff += random(-jitter, jitter + 1);
+
+    currentBackoff = backoff;
+    openUntil = millis() + backoff;
+    breakerState = UART_BREAKER_OPEN;
+    consecutiveFailures = 0;
+    probeInFlight = false;
+    uartBreakerStats.opens++;
+    uartHealthy = false;
+
+    LOG_WARN("UART", "⛔ UART devre kesici açık - %lums istek gönderilmeyecek (#%u)", backoff, openStreak);
+
+    // Uzun süredir yanıt yok - sürücü/protokol durumu da sıfırlansın
+    if (openStreak % UART_BREAKER_REINIT_AFTER == 0) {
+        uartBreakerStats.reinits++;
+        LOG_WARN("UART", "🔄 UART yeniden başlatılıyor (devre kesici)");
+        scheduleUARTReinit();
+    }
+}
+
+bool isUARTCircuitOpen() {
+    return breakerState == UART_BREAKER_OPEN && (long)(millis() - openUntil) < 0;
+}
+
+bool uartBreakerAdmit() {
+    switch (breakerState) {
+        case UART_BREAKER_CLOSED:
+            return true;
+
+        case UART_BREAKER_OPEN:
+            if ((long)(millis() - openUntil) < 0) {
+                uartBreakerStats.rejected++;
+                return false;
+            }
+            breakerState = UART_BREAKER_HALF_OPEN;
+            probeInFlight = true;
+            uartBreakerStats.probes++;
+            LOG_DEBUG("UART", "🔌 UART devre kesici yarı açık - deneme isteği gönderiliyor");
+            return true;
+
+        default:
+            // Deneme sonuçlanana kadar başka istek hatta gitmez
+            if (probeInFlight) {
+                uartBreakerStats.rejected++;
+                return false;
+            }
+            probeInFlight = true;
+            uartBreakerStats.probes++;
+            return true;
+    }
+}
+
+void uartBreakerRecord(UARTTransactionStatus status) {
+    // NACK de canlı bir dsPIC'ten gelir
+    if (status == UART_STATUS_OK || status == UART_STATUS_NACK) {
+        if (breakerState != UART_BREAKER_CLOSED) {
+            LOG_SUCCESS("UART", "✅ UART devre kesici kapandı - dsPIC yanıt veriyor");
+        }
+        breakerState = UART_BREAKER_CLOSED;
+        consecutiveFailures = 0;
+        openStreak = 0;
+        currentBackoff = 0;
+        probeInFlight = false;
+        uartHealthy = true;
+        return;
+    }
+
+    // Hatta hiç gitmemiş istekler (süresi dolmuş, reddedilmiş) hattın durumunu göstermez
+    if (status != UART_STATUS_TIMEOUT && status != UART_STATUS_ERROR) {
+        return;
+    }
+
+    if (breakerState == UART_BREAKER_HALF_OPEN) {
+        tripBreaker();
+    } else if (breakerState == UART_BREAKER_CLOSED && ++consecutiveFailures >= UART_BREAKER_FAILURE_THRESHOLD) {
+        tripBreaker();
+    }
+}
+
+UARTBreakerState getUARTBreakerState() {
+    return breakerState;
+}
+
+void fillUARTBreakerJSON(JsonObject breaker) {
+    breaker["state"] = stateToString(breakerState);
+    breaker["consecutiveFailures"] = consecutiveFailures;
+    breaker["openStreak"] = openStreak;
+    breaker["backoffMs"] = currentBackoff;
+    breaker["retryInMs"] = isUARTCircuitOpen() ? openUntil - millis() : 0;
+    breaker["opens"] = uartBreakerStats.opens;
+    breaker["rejected"] = uartBreakerStats.rejected;
+    breaker["probes"] = uartBreakerStats.probes;
+    breaker["reinits"] = uartBreakerStats.reinits;
+}
@@ -0,0 +1,505 @@
+// uart_frame.cpp - Checksum ve akış tabanlı STX/ETX / COBS frame çözücü
+#include "uart_frame.h"
+#include <string.h>
+
+// CRC-8 (poly 0x07) tek byte için 8 adım - sadece derleme zamanında çalışır
+static constexpr uint8_t crc8Shift(uint8_t crc, int bits) {
+    return bits == 0 ? crc
+                     : crc8Shift((crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1), bits - 1);
+}
+
+#define CRC8_ENTRY(n) crc8Shift((uint8_t)(n), 8)
+#define CRC8_ROW4(n)  CRC8_ENTRY(n), CRC8_ENTRY((n) + 1), CRC8_ENTRY((n) + 2), CRC8_ENTRY((n) + 3)
+#define CRC8_ROW16(n) CRC8_ROW4(n), CRC8_ROW4((n) + 4), CRC8_ROW4((n) + 8), CRC8_ROW4((n) + 12)
+#define CRC8_ROW64(n) CRC8_ROW16(n), CRC8_ROW16((n) + 16), CRC8_ROW16((n) + 32), CRC8_ROW16((n) + 48)
+
+const uint8_t crc8Table[256] = {
+    CRC8_ROW64(0), CRC8_ROW64(64), CRC8_ROW64(128), CRC8_ROW64(192)
+};
+
+static_assert(crc8Shift(0x01, 8) == 0x07, "CRC-8 tablo üreteci hatalı");
+
+// CRC8 checksum hesaplama - tablo tabanlı, byte başına tek arama
+uint8_t calculateCRC8(const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) return 0;
+
+    uint8_t crc = 0x00;
+    for (size_t i = 0; i < length; i++) {
+        crc = crc8Update(crc, data[i]);
+    }
+    return crc;
+}
+
+// XOR checksum hesaplama (basit ve hızlı) - İYİLEŞTİRİLMİŞ
+uint8_t calculateXORChecksum(const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) return 0;
+
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < length; i++) {
+        checksum ^= data[i];
+    }
+    return checksum;
+}
+
+// Frame checksum'ı (command + length + data) - ara tampon kullanmadan
+uint8_t calculateFrameChecksum(uint8_t command, uint16_t dataLength, const uint8_t* data, FrameChecksumMode mode,
+                               int sequence) {
+    uint8_t header[4];
+    uint8_t headerLength = 0;
+    header[headerLength++] = command;
+    if (sequence >= 0) {
+        header[headerLength++] = (uint8_t)sequence;
+    }
+    header[headerLength++] = (uint8_t)((dataLength >> 8) & 0xFF);
+    header[headerLength++] = (uint8_t)(dataLength & 0xFF);
+
+    if (mode == CHECKSUM_CRC8) {
+        uint8_t crc = 0x00;
+        for (uint8_t i = 0; i < headerLength; i++) {
+            crc = crc8Update(crc, header[i]);
+        }
+        for (uint16_t i = 0; data != nullptr && i < dataLength; i++) {
+            crc = crc8Update(crc, data[i]);
+        }
+        return crc;
+    }
+
+    uint8_t checksum = calculateXORChecksum(header, headerLength);
+    if (data != nullptr && dataLength > 0) {
+        checksum ^= calculateXORChecksum(data, dataLength);
+    }
+    return checksum;
+}
+
+static inline bool needsEscape(uint8_t value) {
+    return value == FRAME_START_CHAR || value == FRAME_END_CHAR || value == FRAME_ESCAPE_CHAR;
+}
+
+static inline void putEscaped(uint8_t*& cursor, uint8_t value) {
+    if (needsEscape(value)) {
+        *cursor++ = FRAME_ESCAPE_CHAR;
+    }
+    *cursor++ = value;
+}
+
+size_t encodeFrame(uint8_t command, const uint8_t* data, uint16_t dataLength, uint8_t* out, size_t capacity,
+                   FrameChecksumMode mode, int sequence) {
+    if (out == nullptr || dataLength > MAX_FRAME_SIZE || (dataLength > 0 && data == nullptr)) {
+        return 0;
+    }
+
+    // Kapasiteyi en kötü duruma göre bir kez kontrol et, döngüde sınır kontrolü yok
+    bool sequenced = (sequence >= 0);
+    size_t worstCase = 2 + 2 * ((sequenced ? 4 : 3) + (size_t)dataLength + 1);
+    if (capacity < worstCase) {
+        return 0;
+    }
+
+    uint8_t* cursor = out;
+    uint8_t lengthHigh = (dataLength >> 8) & 0xFF;
+    uint8_t lengthLow = dataLength & 0xFF;
+    bool crcMode = (mode == CHECKSUM_CRC8);
+    uint8_t checksum = crcMode ? crc8Update(0, command) : command;
+
+    *cursor++ = FRAME_START_CHAR;
+    putEscaped(cursor, command);
+
+    if (sequenced) {
+        uint8_t sequenceByte = (uint8_t)sequence;
+        checksum = crcMode ? crc8Update(checksum, sequenceByte) : (uint8_t)(checksum ^ sequenceByte);
+        putEscaped(cursor, sequenceByte);
+    }
+
+    checksum = crcMode ? crc8Update(crc8Update(checksum, lengthHigh), lengthLow)
+                       : (uint8_t)(checksum ^ lengthHigh ^ lengthLow);
+    putEscaped(cursor, lengthHigh);
+    putEscaped(cursor, lengthLow);
+
+    for (uint16_t i = 0; i < dataLength; i++) {
+        uint8_t value = data[i];
+        checksum = crcMode ? crc8Update(checksum, value) : (uint8_t)(checksum ^ value);
+        putEscaped(cursor, value);
+    }
+
+    putEscaped(cursor, checksum);
+    *cursor++ = FRAME_END_CHAR;
+
+    return cursor - out;
+}
+
+size_t encodeFrame(const UARTFrame& frame, uint8_t* out, size_t capacity, FrameChecksumMode mode, int sequence) {
+    return encodeFrame(frame.command, frame.data, frame.dataLength, out, capacity, mode, sequence);
+}
+
+// COBS yazıcı - kod byte'ının yeri önceden ayrılır, blok bitince doldurulur
+struct COBSWriter {
+    uint8_t* cursor;
+    uint8_t* codePosition;
+    uint8_t code;
+
+    explicit COBSWriter(uint8_t* out) : cursor(out + 1), codePosition(out), code(1) {}
+
+    inline void put(uint8_t value) {
+        if (value == 0) {
+            closeBlock();
+            return;
+        }
+        *cursor++ = value;
+        if (++code == 0xFF) {
+            closeBlock();
+        }
+    }
+
+    inline void closeBlock() {
+        *codePosition = code;
+        codePosition = cursor++;
+        code = 1;
+    }
+
+    uint8_t* finish() {
+        *codePosition = code;
+        return cursor;
+    }
+};
+
+size_t encodeCOBSFrame(uint8_t command, const uint8_t* data, uint16_t dataLength, uint8_t* out, size_t capacity,
+                       FrameChecksumMode mode, int sequence) {
+    if (out == nullptr || dataLength > MAX_FRAME_SIZE || (dataLength > 0 && data == nullptr)) {
+        return 0;
+    }
+
+    bool sequenced = (sequence >= 0);
+    size_t contentLength = (sequenced ? 4 : 3) + (size_t)dataLength + 1;
+    if (capacity < COBS_MAX_ENCODED_SIZE(contentLength)) {
+        return 0;
+    }
+
+    // Baştaki ayraç hat gürültüsünden sonra alıcıyı hemen senkronize eder
+    out[0] = COBS_DELIMITER;
+    COBSWriter writer(out + 1);
+
+    uint8_t lengthHigh = (dataLength >> 8) & 0xFF;
+    uint8_t lengthLow = dataLength & 0xFF;
+    bool crcMode = (mode == CHECKSUM_CRC8);
+    uint8_t checksum = crcMode ? crc8Update(0, command) : command;
+    writer.put(command);
+
+    if (sequenced) {
+        uint8_t sequenceByte = (uint8_t)sequence;
+        checksum = crcMode ? crc8Update(checksum, sequenceByte) : (uint8_t)(checksum ^ sequenceByte);
+        writer.put(sequenceByte);
+    }
+
+    checksum = crcMode ? crc8Update(crc8Update(checksum, lengthHigh), lengthLow)
+                       : (uint8_t)(checksum ^ lengthHigh ^ lengthLow);
+    writer.put(lengthHigh);
+    writer.put(lengthLow);
+
+    for (uint16_t i = 0; i < dataLength; i++) {
+        uint8_t value = data[i];
+        checksum = crcMode ? crc8Update(checksum, value) : (uint8_t)(checksum ^ value);
+        writer.put(value);
+    }
+    writer.put(checksum);
+
+    uint8_t* cursor = writer.finish();
+    *cursor++ = COBS_DELIMITER;
+    return cursor - out;
+}
+
+// Klasik "kelimede sıfır byte var mı" testi: (w - 0x01..) & ~w & 0x80..
+size_t findCOBSDelimiter(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    // Hizalanana kadar byte byte
+    while (i < length && ((uintptr_t)(data + i) & (sizeof(uint32_t) - 1)) != 0) {
+        if (data[i] == COBS_DELIMITER) return i;
+        i++;
+    }
+
+    for (; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (((word - 0x01010101u) & ~word & 0x80808080u) != 0) {
+            break;
+        }
+    }
+
+    while (i < length && data[i] != COBS_DELIMITER) {
+        i++;
+    }
+    return i;
+}
+
+FrameDecoder::FrameDecoder(FrameHandler handler, void* context)
+    : handler(handler),
+      context(context),
+      checksumMode(CHECKSUM_XOR),
+      sequenced(false),
+      framing(FRAMING_STX_ETX),
+      state(WAIT_START),
+      escapeNext(false),
+      cobsRemaining(0),
+      cobsZeroPending(false),
+      dataIndex(0),
+      runningChecksum(0),
+      decodedCount(0),
+      checksumErrorCount(0),
+      framingErrorCount(0) {
+    frame.command = 0;
+    frame.sequence = 0;
+    frame.dataLength = 0;
+    frame.checksum = 0;
+}
+
+void FrameDecoder::setHandler(FrameHandler newHandler, void* newContext) {
+    handler = newHandler;
+    context = newContext;
+}
+
+// Mod değişince yarım kalan frame geçersiz olur
+void FrameDecoder::setChecksumMode(FrameChecksumMode mode) {
+    checksumMode = mode;
+    reset();
+}
+
+// Sıralı biçim (komuttan sonra sıra byte'ı) - mod değişince yarım frame geçersiz
+void FrameDecoder::setSequenced(bool enabled) {
+    sequenced = enabled;
+    reset();
+}
+
+// Biçim değişince yarım frame geçersiz; COBS'ta ilk ayraca kadar byte'lar atılır
+void FrameDecoder::setFraming(FrameEncoding encoding) {
+    framing = encoding;
+    reset();
+}
+
+void FrameDecoder::reset() {
+    state = WAIT_START;
+    escapeNext = false;
+    cobsRemaining = 0;
+    cobsZeroPending = false;
+    dataIndex = 0;
+    runningChecksum = 0;
+}
+
+void FrameDecoder::startFrame() {
+    state = READ_COMMAND;
+    escapeNext = false;
+    dataIndex = 0;
+    runningChecksum = 0;
+    frame.sequence = 0;
+    frame.dataLength = 0;
+}
+
+size_t FrameDecoder::push(const uint8_t* data, size_t length) {
+    if (data == nullptr) return 0;
+
+    if (framing == FRAMING_COBS) {
+        return pushCOBS(data, length);
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t value = data[i];
+
+        // Escape sonrası karakter her zaman veri olarak işlenir
+        if (escapeNext) {
+            escapeNext = false;
+            if (!processByte(value, true)) {
+                return i + 1;
+            }
+            continue;
+        }
+
+        if (value == FRAME_ESCAPE_CHAR) {
+            escapeNext = true;
+            continue;
+        }
+
+        if (!processByte(value, false)) {
+            return i + 1;
+        }
+    }
+
+    return length;
+}
+
+// false: handler durdurma istedi
+bool FrameDecoder::processByte(uint8_t value, bool escaped) {
+    if (!escaped) {
+        // Kaçışsız STX her durumda yeni frame başlatır (yeniden senkronizasyon)
+        if (value == FRAME_START_CHAR) {
+            if (state != WAIT_START) {
+                framingErrorCount++;
+            }
+            startFrame();
+            return true;
+        }
+
+        if (value == FRAME_END_CHAR) {
+            if (state != WAIT_END) {
+                if (state != WAIT_START) {
+                    framingErrorCount++;
+                }
+                state = WAIT_START;
+                return true;
+            }
+
+            return completeFrame();
+        }
+    }
+
+    switch (state) {
+        case WAIT_START:
+            // Frame dışı byte - atla
+            break;
+
+        case READ_COMMAND:
+            frame.command = value;
+            runningChecksum = 0;
+            accumulate(value);
+            state = sequenced ? READ_SEQUENCE : READ_LENGTH_HIGH;
+            break;
+
+        case READ_SEQUENCE:
+            frame.sequence = value;
+            accumulate(value);
+            state = READ_LENGTH_HIGH;
+            break;
+
+        case READ_LENGTH_HIGH:
+            frame.dataLength = (uint16_t)value << 8;
+            accumulate(value);
+            state = READ_LENGTH_LOW;
+            break;
+
+        case READ_LENGTH_LOW:
+            frame.dataLength |= value;
+            accumulate(value);
+
+            if (frame.dataLength > MAX_FRAME_SIZE) {
+                framingErrorCount++;
+                state = WAIT_START;
+            } else {
+                dataIndex = 0;
+                state = frame.dataLength > 0 ? READ_DATA : READ_CHECKSUM;
+            }
+            break;
+
+        case READ_DATA:
+            frame.data[dataIndex++] = value;
+            accumulate(value);
+            if (dataIndex >= frame.dataLength) {
+                state = READ_CHECKSUM;
+            }
+            break;
+
+        case READ_CHECKSUM:
+            frame.checksum = value;
+            state = WAIT_END;
+            break;
+
+        case WAIT_END:
+            // ETX yerine veri geldi - frame bozuk
+            framingErrorCount++;
+            state = WAIT_START;
+            break;
+    }
+
+    return true;
+}
+
+// Checksum doğrulanır ve handler çağrılır. false: handler durdurma istedi
+bool FrameDecoder::completeFrame() {
+    state = WAIT_START;
+    if (frame.checksum != runningChecksum) {
+        checksumErrorCount++;
+        return true;
+    }
+
+    decodedCount++;
+    return handler ? handler(frame, context) : true;
+}
+
+// COBS: ayraçlar kelime taramasıyla bulunur, aradaki bloklar toplu çözülür
+size_t FrameDecoder::pushCOBS(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        size_t run = findCOBSDelimiter(data + i, length - i);
+        if (state != WAIT_START) {
+            consumeCOBSRun(data + i, run);
+        }
+        i += run;
+        if (i == length) {
+            break;
+        }
+
+        // Ayraç - frame sonu ve bir sonrakinin başı
+        i++;
+        bool keepGoing = true;
+        if (state == WAIT_END) {
+            keepGoing = completeFrame();
+        } else if (state != WAIT_START && state != READ_COMMAND) {
+            framingErrorCount++;
+        }
+
+        startFrame();
+        cobsRemaining = 0;
+        cobsZeroPending = false;
+
+        if (!keepGoing) {
+            return i;
+        }
+    }
+    return length;
+}
+
+// Ayraç içermeyen kodlanmış byte'lar
+void FrameDecoder::consumeCOBSRun(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        if (cobsRemaining == 0) {
+            uint8_t code = data[i++];
+            if (cobsZeroPending) {
+                const uint8_t zero = 0;
+                feedDecoded(&zero, 1);
+            }
+            cobsRemaining = code - 1;
+            cobsZeroPending = (code != 0xFF);
+            continue;
+        }
+
+        size_t run = length - i < cobsRemaining ? length - i : cobsRemaining;
+        feedDecoded(data + i, run);
+        cobsRemaining -= run;
+        i += run;
+    }
+}
+
+// Çözülmüş byte'ları durum makinesine ver; veri alanı toplu kopyalanır
+void FrameDecoder::feedDecoded(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        if (state == READ_DATA) {
+            size_t take = frame.dataLength - dataIndex;
+            if (take > length - i) take = length - i;
+
+            memcpy(&frame.data[dataIndex], data + i, take);
+            for (size_t k = 0; k < take; k++) {
+                accumulate(data[i + k]);
+            }
+            dataIndex += take;
+            i += take;
+            if (dataIndex >= frame.dataLength) {
+                state = READ_CHECKSUM;
+            }
+            continue;
+        }
+
+        if (state == WAIT_START) {
+            return; // Bozuk frame - ayraca kadar atla
+        }
+        processByte(data[i++], true);
+    }
+}
@@ -1,5 +1,8 @@
 #include "uart_handler.h"
 #include "uart_protocol.h"
+#include "uart_link.h"
+#include "uart_arbiter.h"
+#include "uart_rate.h"
 #include "log_system.h"
 #include "settings.h"
 #include <Preferences.h>
@@ -7,33 +10,30 @@
 // UART Pin tanımlamaları - DÜZELTME
 #define UART_RX_PIN 5   // IO5 - RX2 (önceki: 4)
 #define UART_TX_PIN 17  // IO17 - TX2 (önceki: 2)
-#define UART_PORT   Serial2
 #define UART_TIMEOUT 1000
 #define MAX_RESPONSE_LENGTH 256
 
 static unsigned long lastUARTActivity = 0;
-static int uartErrorCount = 0;
 
 void initUART() {
-    // UART pinlerini başlat
-    pinMode(UART_RX_PIN, INPUT);
-    pinMode(UART_TX_PIN, OUTPUT);
-    
-    // Serial2'yi belirtilen pinlerle başlat
-    UART_PORT.begin(settings.currentBaudRate, SERIAL_8N1, UART_RX_PIN, UART_TX_PIN);
+    // IDF UART driver + RX task (alım olay tabanlı, polling yok)
+    if (!initUARTLink(settings.currentBaudRate, UART_RX_PIN, UART_TX_PIN)) {
+        uartHealthy = false;
+        return;
+    }
     
     // Buffer'ı temizle
-    while (UART_PORT.available()) {
-        UART_PORT.read();
-    }
+    uartLinkFlushInput();
     
     lastUARTActivity = millis();
-    uartErrorCount = 0;
     uartHealthy = true;
     
-    addLog("✅ UART başlatıldı - TX2: IO" + String(UART_TX_PIN) + 
-           ", RX2: IO" + String(UART_RX_PIN) + 
-           ", Baud: " + String(settings.currentBaudRate), SUCCESS, "UART");
+    // dsPIC durumu bilinmiyor - owner task protokol sürümünü ve hızı yeniden anlaşır
+    resetLinkProtocol();
+    resetLinkRate(settings.currentBaudRate);
+    
+    LOG_SUCCESS("UART", "✅ UART başlatıldı - TX2: IO%d, RX2: IO%d, Baud: %ld",
+            UART_TX_PIN, UART_RX_PIN, settings.currentBaudRate);
 }
 
 // dsPIC33EP'ye sadece baudrate KODU gönder (cihazın kendi baudrate'i değişmeyecek)
@@ -48,32 +48,24 @@ bool sendBaudRateCommand(long baudRate) {
         case 57600:  command = "br57600";  break;
         case 115200: command = "br115200"; break;
         default:
-            addLog("Geçersiz baudrate kodu: " + String(baudRate), ERROR, "UART");
+            LOG_ERROR("UART", "Geçersiz baudrate kodu: %ld", baudRate);
             return false;
     }
     
-    // Buffer'ı temizle
-    while (UART_PORT.available()) {
-        UART_PORT.read();
-    }
-    
-    // Komutu gönder
-    UART_PORT.println(command);
-    UART_PORT.flush();
-    
-    addLog("dsPIC33EP'ye baudrate kodu gönderildi: " + command, INFO, "UART");
+    LOG_INFO("UART", "dsPIC33EP'ye baudrate kodu gönderiliyor: %s", command.c_str());
     
-    // ACK bekle
-    String response = safeReadUARTResponse(2000);
+    // Gönder ve ACK bekle
+    String response;
+    sendCustomCommand(command, response, 2000, UART_PRIORITY_INTERACTIVE);
     
     if (response == "ACK" || response.indexOf("OK") >= 0) {
-        addLog("✅ Baudrate kodu dsPIC33EP tarafından alındı", SUCCESS, "UART");
+        LOG_SUCCESS("UART", "✅ Baudrate kodu dsPIC33EP tarafından alındı");
         return true;
     } else if (response.length() > 0) {
-        addLog("dsPIC33EP yanıtı: " + response, WARN, "UART");
+        LOG_WARN("UART", "dsPIC33EP yanıtı: %s", response.c_str());
         return true; // Yanıt varsa başarılı say
     } else {
-        addLog("❌ dsPIC33EP'den yanıt alınamadı", ERROR, "UART");
+        LOG_ERROR("UART", "❌ dsPIC33EP'den yanıt alınamadı");
         return false;
     }
 }
@@ -85,92 +77,81 @@ bool changeBaudRate(long baudRate) {
     return sendBaudRateCommand(baudRate);
 }
 
-// Güvenli UART okuma
-String safeReadUARTResponse(unsigned long timeout) {
-    String response = "";
+// Güvenli UART satır okuma - RX halkasından, veri beklerken task bloklanır.
+// Heap kullanmaz; satır null ile sonlanır, uzunluk döner. Sadece owner task çağırır.
+size_t readUARTLine(char* buffer, size_t capacity, unsigned long timeout) {
+    if (buffer == nullptr || capacity == 0) {
+        return 0;
+    }
+    
+    size_t limit = min(capacity, (size_t)MAX_RESPONSE_LENGTH) - 1;
+    size_t length = 0;
     unsigned long startTime = millis();
+    unsigned long elapsed;
     
-    while (millis() - startTime < timeout) {
-        if (UART_PORT.available()) {
-            char c = UART_PORT.read();
-            lastUARTActivity = millis();
-            uartHealthy = true;
-            
-            if (c == '\n' || c == '\r') {
-                if (response.length() > 0) {
-                    return response;
-                }
-            } else if (c >= 32 && c <= 126) { // Yazdırılabilir karakterler
-                response += c;
-                if (response.length() >= MAX_RESPONSE_LENGTH - 1) {
-                    return response;
-                }
+    while ((elapsed = millis() - startTime) < timeout) {
+        int value = uartLinkReadByte(timeout - elapsed);
+        if (value < 0) {
+            break; // Timeout
+        }
+        
+        char c = (char)value;
+        lastUARTActivity = millis();
+        uartHealthy = true;
+        
+        if (c == '\n' || c == '\r') {
+            if (length > 0) {
+                break;
+            }
+        } else if (c >= 32 && c <= 126) { // Yazdırılabilir karakterler
+            buffer[length++] = c;
+            if (length >= limit) {
+                break;
             }
         }
-        delay(1);
     }
     
-    return response;
+    buffer[length] = '\0';
+    return length;
 }
 
-// Arıza kayıtları için komutlar
-bool requestFirstFault() {
-    while (UART_PORT.available()) {
-        UART_PORT.read();
-    }
-    
-    String command = "12345v"; // İlk arıza komutu
-    UART_PORT.println(command);
-    UART_PORT.flush();
-    
-    addLog("Arıza sorgu komutu: " + command, DEBUG, "UART");
-    
-    lastResponse = safeReadUARTResponse(UART_TIMEOUT);
+String safeReadUARTResponse(unsigned long timeout) {
+    char line[MAX_RESPONSE_LENGTH];
+    readUARTLine(line, sizeof(line), timeout);
+    return String(line);
+}
+
+// Arıza kayıtları için komutlar - yanıt çağıranın kendi tamponuna yazılır
+bool requestFirstFault(String& record) {
+    String command = FAULT_COMMAND_FIRST; // İlk arıza komutu
+    LOG_DEBUG("UART", "Arıza sorgu komutu: %s", command.c_str());
     
-    if (lastResponse.length() > 0) {
-        addLog("Arıza kaydı alındı: " + lastResponse.substring(0, 20) + "...", DEBUG, "UART");
+    if (sendCustomCommand(command, record, FAULT_RESPONSE_TIMEOUT, UART_PRIORITY_INTERACTIVE)) {
+        LOG_DEBUG("UART", "Arıza kaydı alındı: %.20s...", record.c_str());
         return true;
     }
     
-    uartErrorCount++;
     return false;
 }
 
-bool requestNextFault() {
-    while (UART_PORT.available()) {
-        UART_PORT.read();
-    }
+bool requestNextFault(String& record) {
+    String command = FAULT_COMMAND_NEXT; // Sonraki arıza komutu
     
-    String command = "n"; // Sonraki arıza komutu
-    UART_PORT.println(command);
-    UART_PORT.flush();
-    
-    lastResponse = safeReadUARTResponse(UART_TIMEOUT);
-    
-    if (lastResponse.length() > 0) {
+    if (sendCustomCommand(command, record, FAULT_RESPONSE_TIMEOUT, UART_PRIORITY_INTERACTIVE)) {
         return true;
     }
     
-    uartErrorCount++;
     return false;
 }
 
-String getLastFaultResponse() {
-    return lastResponse;
-}
-
 // UART sağlık kontrolü
 void checkUARTHealth() {
     if (millis() - lastUARTActivity > 300000 && uartHealthy) { // 5 dakika
-        addLog("⚠️ UART 5 dakikadır sessiz", WARN, "UART");
+        LOG_WARN("UART", "⚠️ UART 5 dakikadır sessiz");
         uartHealthy = false;
     }
     
-    if (uartErrorCount > 10) {
-        addLog("🔄 UART yeniden başlatılıyor...", WARN, "UART");
-        initUART();
-        uartErrorCount = 0;
-    }
+    // Hata sayımı ve yeniden başlatma devre kesicide (uart_breaker) - gerçek istek sonuçlarıyla
 }
 
 // UART durumu
@@ -178,35 +159,48 @@ String getUARTStatus() {
     return uartHealthy ? "Aktif" : "Pasif";
 }
 
-// Özel komut gönderme (NTP ve diğer komutlar için)
-bool sendCustomCommand(const String& command, String& response, unsigned long timeout) {
+// Özel komut gönderme (NTP ve diğer komutlar için) - owner task kuyruğu üzerinden
+bool sendCustomCommand(const String& command, String& response, unsigned long timeout, UARTPriority priority) {
+    response = "";
     if (command.length() == 0 || command.length() > 100) {
         return false;
     }
     
-    while (UART_PORT.available()) {
-        UART_PORT.read();
+    UARTTransaction* pooled = acquireUARTTransaction();     // Çağıranın stack'inde değil
+    if (pooled == NULL) {
+        return false;
+    }
+    UARTTransaction& transaction = *pooled;
+    if (!prepareTextTransaction(transaction, command, timeout == 0 ? UART_TIMEOUT : timeout, priority)) {
+        releaseUARTTransaction(pooled);
+        return false;
     }
     
-    UART_PORT.println(command);
-    UART_PORT.flush();
-    
-    response = safeReadUARTResponse(timeout == 0 ? UART_TIMEOUT : timeout);
+    if (!executeUARTTransaction(transaction)) {
+        if (transaction.status == UART_STATUS_EXPIRED || transaction.status == UART_STATUS_REJECTED) {
+            LOG_WARN("UART", "⚠️ UART komutu çalıştırılamadı (%s): %s",
+                    transactionStatusToString(transaction.status), command.c_str());
+        }
+        releaseUARTTransaction(pooled);
+        return false;
+    }
     
+    response = transactionResponseString(transaction);
+    releaseUARTTransaction(pooled);
     return response.length() > 0;
 }
 
 // Test fonksiyonu
 bool testUARTConnection() {
-    addLog("UART bağlantı testi...", INFO, "UART");
+    LOG_INFO("UART", "UART bağlantı testi...");
     
     String response;
-    bool result = sendCustomCommand("TEST", response, 1000);
+    bool result = sendCustomCommand("TEST", response, 1000, UART_PRIORITY_BACKGROUND);
     
     if (result) {
-        addLog("✅ UART testi başarılı: " + response, SUCCESS, "UART");
+        LOG_SUCCESS("UART", "✅ UART testi başarılı: %s", response.c_str());
     } else {
-        addLog("❌ UART testi başarısız", ERROR, "UART");
+        LOG_ERROR("UART", "❌ UART testi başarısız");
     }
     
     return result;
@@ -0,0 +1,266 @@
+// uart_link.cpp - dsPIC UART bağlantısı: IDF event kuyruğu + RX task + lock-free halka
+#include "uart_link.h"
+#include "log_system.h"
+#include <driver/uart.h>
+#include <atomic>
+
+#define LINK_UART ((uart_port_t)UART_LINK_PORT)
+
+UARTLinkStats uartLinkStats = {0, 0, 0, 0, 0};
+
+// Tek üretici (RX task) / tek tüketici halka tamponu.
+// head ve tail serbest koşan sayaçlardır; indeks = sayaç & (boyut - 1)
+static uint8_t rxRing[UART_RX_RING_SIZE];
+static std::atomic<uint32_t> rxHead(0);
+static std::atomic<uint32_t> rxTail(0);
+
+static QueueHandle_t uartEventQueue = NULL;
+static SemaphoreHandle_t rxDataSignal = NULL;
+static TaskHandle_t uartRxTaskHandle = NULL;
+static TaskHandle_t dataNotifyTask = NULL;
+static bool linkReady = false;
+
+// Driver buffer'ındaki byte'ları doğrudan halkanın boş bölgesine oku
+static void drainDriverToRing() {
+    size_t buffered = 0;
+    if (uart_get_buffered_data_len(LINK_UART, &buffered) != ESP_OK) {
+        return;
+    }
+
+    while (buffered > 0) {
+        uint32_t head = rxHead.load(std::memory_order_relaxed);
+        uint32_t tail = rxTail.load(std::memory_order_acquire);
+        size_t freeSpace = UART_RX_RING_SIZE - (head - tail);
+
+        if (freeSpace == 0) {
+            // Tüketici yetişemiyor - yeni veriyi at, eski veri bozulmasın
+            uint8_t discard[32];
+            int dropped = uart_read_bytes(LINK_UART, discard, min(buffered, sizeof(discard)), 0);
+            if (dropped <= 0) break;
+            uartLinkStats.ringOverflows += dropped;
+            buffered -= dropped;
+            continue;
+        }
+
+        // Halkanın sonuna kadar olan bitişik boş alan
+        size_t offset = head & (UART_RX_RING_SIZE - 1);
+        size_t chunk = min(freeSpace, (size_t)(UART_RX_RING_SIZE - offset));
+        chunk = min(chunk, buffered);
+
+        int readCount = uart_read_bytes(LINK_UART, &rxRing[offset], chunk, 0);
+        if (readCount <= 0) break;
+
+        rxHead.store(head + readCount, std::memory_order_release);
+        uartLinkStats.bytesReceived += readCount;
+        buffered -= readCount;
+    }
+
+    xSemaphoreGive(rxDataSignal);
+    if (dataNotifyTask != NULL) {
+        xTaskNotifyGive(dataNotifyTask);
+    }
+}
+
+// RX task - driver olay kuyruğunu bekler, polling yok
+static void uartRxTask(void* parameter) {
+    uart_event_t event;
+
+    while (true) {
+        if (xQueueReceive(uartEventQueue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        switch (event.type) {
+            case UART_DATA:
+                drainDriverToRing();
+                break;
+
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // IDF önerisi: driver buffer'ını ve kuyruğu sıfırla
+                uartLinkStats.fifoOverflows++;
+                uart_flush_input(LINK_UART);
+                xQueueReset(uartEventQueue);
+                break;
+
+            case UART_FRAME_ERR:
+            case UART_PARITY_ERR:
+                uartLinkStats.lineErrors++;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+bool initUARTLink(long baudRate, int rxPin, int txPin) {
+    // Yeniden başlatma - driver ve task zaten var, sadece hızı ayarla ve temizle
+    if (uartRxTaskHandle != NULL) {
+        if (uart_set_baudrate(LINK_UART, baudRate) != ESP_OK) {
+            LOG_ERROR("UART", "❌ UART hızı ayarlanamadı: %ld", baudRate);
+            return false;
+        }
+        uart_flush_input(LINK_UART);
+        uartLinkFlushInput();
+        linkReady = true;
+        return true;
+    }
+
+    uart_config_t config = {};
+    config.baud_rate = baudRate;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;
+
+    if (uart_driver_install(LINK_UART, UART_DRIVER_RX_BUFFER, UART_DRIVER_TX_BUFFER, UART_DRIVER_EVENT_QUEUE, &uartEventQueue, 0) != ESP_OK ||
+        uart_param_config(LINK_UART, &config) != ESP_OK ||
+        uart_set_pin(LINK_UART, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+        LOG_ERROR("UART", "❌ UART driver kurulamadı");
+        return false;
+    }
+
+    // Byte arası boşluklarda gecikmeyi azalt: 3 karakter süresi sessizlikte olay üret
+    uart_set_rx_timeout(LINK_UART, 3);
+    uart_set_rx_full_threshold(LINK_UART, 64);
+
+    rxDataSignal = xSemaphoreCreateBinary();
+
+    xTaskCreatePinnedToCore(
+        uartRxTask,
+        "UART_RX",
+        UART_RX_TASK_STACK,
+        NULL,
+        UART_RX_TASK_PRIORITY,
+        &uartRxTaskHandle,
+        UART_RX_TASK_CORE
+    );
+
+    linkReady = (uartRxTaskHandle != NULL);
+    return linkReady;
+}
+
+bool uartLinkReady() {
+    return linkReady;
+}
+
+size_t uartLinkAvailable() {
+    return rxHead.load(std::memory_order_acquire) - rxTail.load(std::memory_order_relaxed);
+}
+
+// Veri gelene kadar task'ı bloklar (CPU harcamaz)
+bool uartLinkWaitForData(unsigned long timeoutMs) {
+    if (uartLinkAvailable() > 0) {
+        return true;
+    }
+
+    unsigned long startTime = millis();
+    while (true) {
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed >= timeoutMs) {
+            return false;
+        }
+        xSemaphoreTake(rxDataSignal, pdMS_TO_TICKS(timeoutMs - elapsed));
+        // Önceki bir bildirimden kalan sinyal olabilir - halkayı tekrar kontrol et
+        if (uartLinkAvailable() > 0) {
+            return true;
+        }
+    }
+}
+
+int uartLinkReadByte(unsigned long timeoutMs) {
+    if (!uartLinkWaitForData(timeoutMs)) {
+        return -1;
+    }
+
+    uint32_t tail = rxTail.load(std::memory_order_relaxed);
+    uint8_t value = rxRing[tail & (UART_RX_RING_SIZE - 1)];
+    rxTail.store(tail + 1, std::memory_order_release);
+    return value;
+}
+
+size_t uartLinkRead(uint8_t* buffer, size_t maxLength) {
+    uint32_t tail = rxTail.load(std::memory_order_relaxed);
+    size_t count = min(maxLength, (size_t)(rxHead.load(std::memory_order_acquire) - tail));
+
+    for (size_t copied = 0; copied < count; ) {
+        size_t offset = (tail + copied) & (UART_RX_RING_SIZE - 1);
+        size_t chunk = min(count - copied, (size_t)(UART_RX_RING_SIZE - offset));
+        memcpy(buffer + copied, &rxRing[offset], chunk);
+        copied += chunk;
+    }
+
+    rxTail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+// Kopyasız okuma: halkadaki ilk bitişik bölgeyi gösterir, uartLinkConsume ile tüketilir
+size_t uartLinkPeek(const uint8_t** data) {
+    uint32_t tail = rxTail.load(std::memory_order_relaxed);
+    size_t available = rxHead.load(std::memory_order_acquire) - tail;
+    size_t offset = tail & (UART_RX_RING_SIZE - 1);
+
+    *data = &rxRing[offset];
+    return min(available, (size_t)(UART_RX_RING_SIZE - offset));
+}
+
+void uartLinkConsume(size_t length) {
+    uint32_t tail = rxTail.load(std::memory_order_relaxed);
+    size_t available = rxHead.load(std::memory_order_acquire) - tail;
+    rxTail.store(tail + min(length, available), std::memory_order_release);
+}
+
+void uartLinkSetDataNotify(TaskHandle_t task) {
+    dataNotifyTask = task;
+}
+
+// Bekleyen tüm alınmış veriyi at (komut öncesi eski yanıtları temizlemek için)
+void uartLinkFlushInput() {
+    rxTail.store(rxHead.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+// Driver TX tamponuna kopyalar ve hemen döner (tampon doluysa yer açılana kadar bekler)
+size_t uartLinkWrite(const uint8_t* data, size_t length) {
+    if (!linkReady || data == nullptr || length == 0) {
+        return 0;
+    }
+
+    int written = uart_write_bytes(LINK_UART, data, length);
+    if (written < 0) {
+        return 0;
+    }
+    uartLinkStats.bytesSent += written;
+    return written;
+}
+
+size_t uartLinkPrintln(const String& line) {
+    size_t written = uartLinkWrite((const uint8_t*)line.c_str(), line.length());
+    written += uartLinkWrite((const uint8_t*)"\r\n", 2);
+    return written;
+}
+
+bool uartLinkSetBaudRate(long baudRate) {
+    if (!linkReady) {
+        return false;
+    }
+
+    uart_wait_tx_done(LINK_UART, pdMS_TO_TICKS(100));
+    if (uart_set_baudrate(LINK_UART, baudRate) != ESP_OK) {
+        LOG_ERROR("UART", "❌ UART hızı ayarlanamadı: %ld", baudRate);
+        return false;
+    }
+    uart_flush_input(LINK_UART);
+    uartLinkFlushInput();
+    return true;
+}
+
+bool uartLinkWaitTxDone(unsigned long timeoutMs) {
+    return uart_wait_tx_done(LINK_UART, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
+
+// Bloklamayan kontrol: son byte hattan çıktı mı?
+bool uartLinkTxIdle() {
+    return uart_wait_tx_done(LINK_UART, 0) == ESP_OK;
+}
@@ -0,0 +1,182 @@
+// uart_lzss.cpp - Akış tabanlı LZSS çözücü ve sıkıştırılmış kayıt okuyucu
+#include "uart_lzss.h"
+#include <string.h>
+
+LZSSDecoder::LZSSDecoder() {
+    reset();
+}
+
+// heatshrink ile aynı: pencere sıfırlarla başlar
+void LZSSDecoder::reset() {
+    memset(window, 0, sizeof(window));
+    windowHead = 0;
+    bitBuffer = 0;
+    bitCount = 0;
+    state = READ_TAG;
+    backrefIndex = 0;
+    stagingLength = 0;
+    inCount = 0;
+    outCount = 0;
+}
+
+bool LZSSDecoder::takeBits(uint8_t count, uint16_t& value) {
+    if (bitCount < count) {
+        return false;
+    }
+    bitCount -= count;
+    value = (uint16_t)((bitBuffer >> bitCount) & ((1u << count) - 1));
+    return true;
+}
+
+void LZSSDecoder::emit(uint8_t value, LZSSOutput output, void* context) {
+    window[windowHead] = value;
+    windowHead = (windowHead + 1) & (LZSS_WINDOW_SIZE - 1);
+    staging[stagingLength++] = value;
+    outCount++;
+    if (stagingLength == LZSS_OUTPUT_CHUNK) {
+        flush(output, context);
+    }
+}
+
+void LZSSDecoder::flush(LZSSOutput output, void* context) {
+    if (stagingLength > 0 && output) {
+        output(staging, stagingLength, context);
+    }
+    stagingLength = 0;
+}
+
+void LZSSDecoder::push(const uint8_t* data, size_t length, LZSSOutput output, void* context) {
+    if (data == nullptr) return;
+
+    for (size_t i = 0; i < length; i++) {
+        bitBuffer = (bitBuffer << 8) | data[i];
+        bitCount += 8;
+        inCount++;
+
+        // En uzun okuma 8 bit; her byte sonrası biriken bitler tüketilir
+        uint16_t value;
+        bool progress = true;
+        while (progress) {
+            switch (state) {
+                case READ_TAG:
+                    progress = takeBits(1, value);
+                    if (progress) state = value ? READ_LITERAL : READ_INDEX;
+                    break;
+
+                case READ_LITERAL:
+                    progress = takeBits(8, value);
+                    if (progress) {
+                        emit((uint8_t)value, output, context);
+                        state = READ_TAG;
+                    }
+                    break;
+
+                case READ_INDEX:
+                    progress = takeBits(LZSS_WINDOW_BITS, value);
+                    if (progress) {
+                        backrefIndex = value + 1;
+                        state = READ_COUNT;
+                    }
+                    break;
+
+                case READ_COUNT:
+                    progress = takeBits(LZSS_LOOKAHEAD_BITS, value);
+                    if (progress) {
+                        for (uint16_t n = 0; n <= value; n++) {
+                            emit(window[(windowHead - backrefIndex) & (LZSS_WINDOW_SIZE - 1)], output, context);
+                        }
+                        state = READ_TAG;
+                    }
+                    break;
+            }
+        }
+    }
+
+    // Son byte'taki dolgu bitleri (< 8) tam bir sembol oluşturamaz
+    flush(output, context);
+}
+
+CompressedFrameReader::CompressedFrameReader(FrameHandler handler, void* context) {
+    begin(handler, context);
+}
+
+void CompressedFrameReader::begin(FrameHandler newHandler, void* newContext) {
+    decoder.reset();
+    handler = newHandler;
+    context = newContext;
+    state = READ_COMMAND;
+    dataIndex = 0;
+    malformed = false;
+    stopped = false;
+    frame.command = 0;
+    frame.sequence = 0;
+    frame.dataLength = 0;
+    frame.checksum = 0;
+}
+
+bool CompressedFrameReader::pushBlock(const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) {
+        malformed = true;
+        return true;
+    }
+
+    uint8_t flags = data[0];
+    decoder.push(data + 1, length - 1, onOutput, this);
+
+    if (flags & LZSS_BLOCK_LAST) {
+        // Yarım kalan kayıt varsa akış bozuk
+        if (state != READ_COMMAND) {
+            malformed = true;
+        }
+        return true;
+    }
+    return false;
+}
+
+void CompressedFrameReader::onOutput(const uint8_t* data, size_t length, void* context) {
+    static_cast<CompressedFrameReader*>(context)->consume(data, length);
+}
+
+void CompressedFrameReader::consume(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length && !malformed) {
+        switch (state) {
+            case READ_COMMAND:
+                frame.command = data[i++];
+                state = READ_LENGTH_HIGH;
+                break;
+
+            case READ_LENGTH_HIGH:
+                frame.dataLength = (uint16_t)data[i++] << 8;
+                state = READ_LENGTH_LOW;
+                break;
+
+            case READ_LENGTH_LOW:
+                frame.dataLength |= data[i++];
+                if (frame.dataLength > MAX_FRAME_SIZE) {
+                    malformed = true;
+                    return;
+                }
+                dataIndex = 0;
+                state = READ_DATA;
+                break;
+
+            case READ_DATA: {
+                size_t take = frame.dataLength - dataIndex;
+                if (take > length - i) take = length - i;
+                memcpy(&frame.data[dataIndex], data + i, take);
+                dataIndex += take;
+                i += take;
+                break;
+            }
+        }
+
+        // Kayıt tamamlandı (boş kayıtlar dahil)
+        if (state == READ_DATA && dataIndex >= frame.dataLength) {
+            state = READ_COMMAND;
+            if (!stopped && handler && !handler(frame, context)) {
+                stopped = true;
+            }
+        }
+    }
+}
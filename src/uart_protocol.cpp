@@ -1,60 +1,32 @@
 #include "uart_protocol.h"
 #include "uart_handler.h"  // initUART() için eklendi
+#include "uart_link.h"
+#include "uart_arbiter.h"
+#include "fault_events.h"
+#include "uart_rate.h"
+#include "uart_stats.h"
+#include "uart_breaker.h"
 #include "log_system.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
 // Global değişkenler (header'da extern olarak tanımlı)
-String lastResponse = "";
 bool uartHealthy = true;
 UARTStatistics uartStats = {0, 0, 0, 0, 0, 100.0};
+UARTLinkProtocol linkProtocol = {1, 0, CHECKSUM_XOR, FRAMING_STX_ETX, false, false, 1};
 
-// Frame durumları
-enum FrameState {
-    WAIT_START,
-    READ_COMMAND,
-    READ_LENGTH_HIGH,
-    READ_LENGTH_LOW,
-    READ_DATA,
-    READ_CHECKSUM,
-    WAIT_END
-};
-
-// CRC8 checksum hesaplama - İYİLEŞTİRİLMİŞ
-uint8_t calculateCRC8(const uint8_t* data, size_t length) {
-    if (data == nullptr || length == 0) return 0;
-    
-    uint8_t crc = 0x00;
-    
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ 0x07; // CRC-8 polynomial
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    
-    return crc;
-}
+// CRC modunda art arda checksum hatası - dsPIC resetlenip v1'e dönmüş olabilir
+static uint8_t consecutiveChecksumErrors = 0;
+#define RENEGOTIATE_AFTER_CHECKSUM_ERRORS 3
 
-// XOR checksum hesaplama (basit ve hızlı) - İYİLEŞTİRİLMİŞ
-uint8_t calculateXORChecksum(const uint8_t* data, size_t length) {
-    if (data == nullptr || length == 0) return 0;
-    
-    uint8_t checksum = 0;
-    for (size_t i = 0; i < length; i++) {
-        checksum ^= data[i];
-    }
-    return checksum;
-}
+// Kalıcı frame çözücü - yarım kalan frame timeout sonrası da korunur,
+// sonraki STX ile yeniden senkronize olur
+static FrameDecoder rxDecoder;
 
 // Frame oluşturma - İYİLEŞTİRİLMİŞ
 bool createFrame(UARTFrame& frame, uint8_t command, const uint8_t* data, uint16_t dataLength) {
     if (dataLength > MAX_FRAME_SIZE) {
-        addLog("❌ Frame verisi çok büyük: " + String(dataLength) + "/" + String(MAX_FRAME_SIZE), ERROR, "UART");
+        LOG_ERROR("UART", "❌ Frame verisi çok büyük: %u/%d", dataLength, MAX_FRAME_SIZE);
         return false;
     }
     
@@ -66,287 +38,334 @@ bool createFrame(UARTFrame& frame, uint8_t command, const uint8_t* data, uint16_
         memcpy(frame.data, data, dataLength);
     }
     
-    // Checksum hesapla (command + length + data)
-    uint8_t checksumData[MAX_FRAME_SIZE + 3];
-    checksumData[0] = command;
-    checksumData[1] = (dataLength >> 8) & 0xFF;  // High byte
-    checksumData[2] = dataLength & 0xFF;         // Low byte
-    
-    if (dataLength > 0 && data != nullptr) {
-        memcpy(&checksumData[3], data, dataLength);
-    }
-    
-    frame.checksum = calculateXORChecksum(checksumData, dataLength + 3);
+    // Checksum hesapla (command + length + data) - kopya tampon olmadan
+    frame.checksum = calculateFrameChecksum(command, dataLength, frame.data, linkProtocol.checksumMode);
     
-    addLog("📦 Frame oluşturuldu - Cmd: 0x" + String(command, HEX) + 
-           ", Len: " + String(dataLength) + 
-           ", Checksum: 0x" + String(frame.checksum, HEX), DEBUG, "UART");
+    LOG_DEBUG("UART", "📦 Frame oluşturuldu - Cmd: 0x%X, Len: %u, Checksum: 0x%X", command, dataLength, frame.checksum);
     
     return true;
 }
 
-// Frame gönderme (escape karakterleri ile) - İYİLEŞTİRİLMİŞ
-bool sendFrame(const UARTFrame& frame) {
-    if (!Serial2) {
-        addLog("❌ UART portu açık değil", ERROR, "UART");
+// TX tamponu - frame tek parça halinde kodlanıp driver'a tek yazma ile verilir
+static uint8_t txBuffer[MAX_ENCODED_FRAME_SIZE];
+
+// Sıralı modda gönderilen son sıra - dur-bekle yanıtı bununla eşleşmeli
+static uint8_t txSequence = 0;
+static uint8_t expectedSequence = 0;
+
+uint8_t nextFrameSequence() {
+    return txSequence++;
+}
+
+static bool transmitFrame(uint8_t command, int sequence, const uint8_t* data, uint16_t dataLength, bool flushInput) {
+    if (!uartLinkReady()) {
+        LOG_ERROR("UART", "❌ UART portu açık değil");
         return false;
     }
     
-    // Buffer temizle
-    while (Serial2.available()) {
-        Serial2.read();
+    size_t encodedLength = linkProtocol.framing == FRAMING_COBS
+        ? encodeCOBSFrame(command, data, dataLength, txBuffer, sizeof(txBuffer), linkProtocol.checksumMode, sequence)
+        : encodeFrame(command, data, dataLength, txBuffer, sizeof(txBuffer), linkProtocol.checksumMode, sequence);
+    if (encodedLength == 0) {
+        LOG_ERROR("UART", "❌ Frame kodlanamadı - Len: %u", dataLength);
+        return false;
     }
     
-    // Frame başlangıcı
-    Serial2.write(FRAME_START_CHAR);
+    // Buffer temizle (boru hattında önceki isteklerin yanıtları bekleniyor - temizlenmez)
+    if (flushInput) {
+        flushLinkInput();
+    }
     
-    // Command gönder (escape kontrolü ile)
-    if (frame.command == FRAME_START_CHAR || frame.command == FRAME_END_CHAR || frame.command == FRAME_ESCAPE_CHAR) {
-        Serial2.write(FRAME_ESCAPE_CHAR);
+    // Tek yazma - driver TX tamponuna kopyalanır, gönderim arka planda sürer.
+    // Hattın boşalması gerekiyorsa çağıran uartLinkWaitTxDone/uartLinkTxIdle kullanır.
+    if (uartLinkWrite(txBuffer, encodedLength) != encodedLength) {
+        LOG_ERROR("UART", "❌ Frame UART driver'a yazılamadı");
+        return false;
     }
-    Serial2.write(frame.command);
     
-    // Length gönder (2 byte, big-endian)
-    uint8_t lengthHigh = (frame.dataLength >> 8) & 0xFF;
-    uint8_t lengthLow = frame.dataLength & 0xFF;
+    // İstatistik güncelle
+    uartStats.totalFramesSent++;
     
-    if (lengthHigh == FRAME_START_CHAR || lengthHigh == FRAME_END_CHAR || lengthHigh == FRAME_ESCAPE_CHAR) {
-        Serial2.write(FRAME_ESCAPE_CHAR);
-    }
-    Serial2.write(lengthHigh);
+    LOG_DEBUG("UART", "📤 Frame gönderildi - Cmd: 0x%X, Len: %u, Wire: %u, Total: %lu",
+            command, dataLength, (unsigned)encodedLength, uartStats.totalFramesSent);
     
-    if (lengthLow == FRAME_START_CHAR || lengthLow == FRAME_END_CHAR || lengthLow == FRAME_ESCAPE_CHAR) {
-        Serial2.write(FRAME_ESCAPE_CHAR);
-    }
-    Serial2.write(lengthLow);
+    return true;
+}
+
+// Komut + veriyi doğrudan kodlayıp gönder (UARTFrame kopyası gerekmez)
+bool sendCommandFrame(uint8_t command, const uint8_t* data, uint16_t dataLength) {
+    int sequence = FRAME_NO_SEQUENCE;
+    if (linkProtocol.sequenced) {
+        expectedSequence = nextFrameSequence();
+        sequence = expectedSequence;
+    }
+    return transmitFrame(command, sequence, data, dataLength, true);
+}
+
+bool sendSequencedFrame(uint8_t command, uint8_t sequence, const uint8_t* data, uint16_t dataLength) {
+    return transmitFrame(command, sequence, data, dataLength, false);
+}
+
+// Frame gönderme (escape karakterleri ile) - İYİLEŞTİRİLMİŞ
+bool sendFrame(const UARTFrame& frame) {
+    return sendCommandFrame(frame.command, frame.data, frame.dataLength);
+}
+
+// receiveFrame için yakalama bağlamı
+struct FrameCapture {
+    UARTFrame* target;
+    bool received;
+};
+
+static bool captureFrame(const UARTFrame& frame, void* context) {
+    FrameCapture* capture = static_cast<FrameCapture*>(context);
     
-    // Data gönder (escape kontrolü ile)
-    for (uint16_t i = 0; i < frame.dataLength; i++) {
-        if (frame.data[i] == FRAME_START_CHAR || frame.data[i] == FRAME_END_CHAR || frame.data[i] == FRAME_ESCAPE_CHAR) {
-            Serial2.write(FRAME_ESCAPE_CHAR);
-        }
-        Serial2.write(frame.data[i]);
+    // Kendiliğinden gelen olay - yanıt beklemeye devam
+    if (frame.command == CMD_FAULT_EVENT) {
+        handleFaultEventFrame(frame);
+        return true;
     }
     
-    // Checksum gönder (escape kontrolü ile)
-    if (frame.checksum == FRAME_START_CHAR || frame.checksum == FRAME_END_CHAR || frame.checksum == FRAME_ESCAPE_CHAR) {
-        Serial2.write(FRAME_ESCAPE_CHAR);
+    // Önceki (iptal edilmiş) bir isteğin geç gelen yanıtı - atla
+    if (linkProtocol.sequenced && frame.sequence != expectedSequence) {
+        return true;
     }
-    Serial2.write(frame.checksum);
     
-    // Frame sonu
-    Serial2.write(FRAME_END_CHAR);
-    
-    // Flush ile gönderimi garanti et
-    Serial2.flush();
-    
-    // İstatistik güncelle
-    uartStats.totalFramesSent++;
-    
-    addLog("📤 Frame gönderildi - Cmd: 0x" + String(frame.command, HEX) + 
-           ", Len: " + String(frame.dataLength) + 
-           ", Total: " + String(uartStats.totalFramesSent), DEBUG, "UART");
-    
-    return true;
+    capture->target->command = frame.command;
+    capture->target->sequence = frame.sequence;
+    capture->target->dataLength = frame.dataLength;
+    capture->target->checksum = frame.checksum;
+    memcpy(capture->target->data, frame.data, frame.dataLength);
+    capture->received = true;
+    return false; // İlk frame'de dur, kalan byte'lar halkada kalsın
 }
 
-// Frame okuma (state machine ile) - İYİLEŞTİRİLMİŞ
+// Frame okuma (akış tabanlı çözücü ile) - İYİLEŞTİRİLMİŞ
 bool receiveFrame(UARTFrame& frame, unsigned long timeout) {
-    if (!Serial2) {
-        addLog("❌ UART portu açık değil", ERROR, "UART");
+    if (!uartLinkReady()) {
+        LOG_ERROR("UART", "❌ UART portu açık değil");
         updateUARTStatistics(false, false, true);
         return false;
     }
     
-    FrameState state = WAIT_START;
-    unsigned long startTime = millis();
-    uint16_t dataIndex = 0;
-    bool escapeNext = false;
-    uint8_t checksumData[MAX_FRAME_SIZE + 3];
-    uint16_t checksumIndex = 0;
-    
-    // Frame değişkenlerini temizle
-    memset(&frame, 0, sizeof(UARTFrame));
+    FrameCapture capture = {&frame, false};
+    rxDecoder.setHandler(captureFrame, &capture);
+    uint32_t checksumErrorsBefore = rxDecoder.checksumErrors();
     
-    while (millis() - startTime < timeout) {
-        if (Serial2.available()) {
-            uint8_t byte = Serial2.read();
-            
-            // Escape karakteri kontrolü
-            if (byte == FRAME_ESCAPE_CHAR && !escapeNext) {
-                escapeNext = true;
-                continue;
-            }
+    unsigned long startTime = millis();
+    unsigned long elapsed;
+    while ((elapsed = millis() - startTime) < timeout) {
+        // Veri yoksa task bloklanır (delay/polling yok)
+        if (!uartLinkWaitForData(timeout - elapsed)) {
+            break;
+        }
+        
+        // Halkadaki bitişik bölgeyi kopyalamadan çözücüye ver
+        const uint8_t* span;
+        size_t available = uartLinkPeek(&span);
+        uartLinkConsume(rxDecoder.push(span, available));
+        
+        if (capture.received) {
+            consecutiveChecksumErrors = 0;
+            uartStats.totalFramesReceived++;
+            updateUARTStatistics(true, false, false);
             
-            // Escape sonrası karakter
-            if (escapeNext) {
-                escapeNext = false;
-                // Byte'ı normal olarak işle
-            } else {
-                // Start/End karakterlerini kontrol et
-                if (byte == FRAME_START_CHAR) {
-                    state = READ_COMMAND;
-                    dataIndex = 0;
-                    checksumIndex = 0;
-                    memset(&frame, 0, sizeof(UARTFrame));
-                    continue;
-                } else if (byte == FRAME_END_CHAR && state == READ_CHECKSUM) {
-                    // Frame tamamlandı, checksum kontrolü yap
-                    uint8_t calculatedChecksum = calculateXORChecksum(checksumData, checksumIndex);
-                    
-                    if (calculatedChecksum == frame.checksum) {
-                        uartStats.totalFramesReceived++;
-                        updateUARTStatistics(true, false, false);
-                        
-                        addLog("✅ Frame alındı - Cmd: 0x" + String(frame.command, HEX) + 
-                               ", Len: " + String(frame.dataLength) + 
-                               ", Checksum: OK", DEBUG, "UART");
-                        return true;
-                    } else {
-                        uartStats.checksumErrors++;
-                        updateUARTStatistics(false, true, false);
-                        
-                        addLog("❌ Checksum hatası! Beklenen: 0x" + String(calculatedChecksum, HEX) + 
-                               ", Alınan: 0x" + String(frame.checksum, HEX), ERROR, "UART");
-                        return false;
-                    }
-                }
-            }
+            LOG_DEBUG("UART", "✅ Frame alındı - Cmd: 0x%X, Len: %u, Checksum: OK", frame.command, frame.dataLength);
+            return true;
+        }
+        
+        if (rxDecoder.checksumErrors() != checksumErrorsBefore) {
+            updateUARTStatistics(false, true, false);
+            LOG_ERROR("UART", "❌ Checksum hatası! Frame atıldı");
             
-            // State machine
-            switch (state) {
-                case WAIT_START:
-                    // Start karakteri bekleniyor
-                    break;
-                    
-                case READ_COMMAND:
-                    frame.command = byte;
-                    if (checksumIndex < sizeof(checksumData)) {
-                        checksumData[checksumIndex++] = byte;
-                    }
-                    state = READ_LENGTH_HIGH;
-                    break;
-                    
-                case READ_LENGTH_HIGH:
-                    frame.dataLength = (byte << 8);
-                    if (checksumIndex < sizeof(checksumData)) {
-                        checksumData[checksumIndex++] = byte;
-                    }
-                    state = READ_LENGTH_LOW;
-                    break;
-                    
-                case READ_LENGTH_LOW:
-                    frame.dataLength |= byte;
-                    if (checksumIndex < sizeof(checksumData)) {
-                        checksumData[checksumIndex++] = byte;
-                    }
-                    
-                    if (frame.dataLength > MAX_FRAME_SIZE) {
-                        addLog("❌ Frame verisi çok büyük: " + String(frame.dataLength), ERROR, "UART");
-                        updateUARTStatistics(false, false, false);
-                        return false;
-                    }
-                    
-                    if (frame.dataLength > 0) {
-                        state = READ_DATA;
-                        dataIndex = 0;
-                    } else {
-                        state = READ_CHECKSUM;
-                    }
-                    break;
-                    
-                case READ_DATA:
-                    frame.data[dataIndex] = byte;
-                    if (checksumIndex < sizeof(checksumData)) {
-                        checksumData[checksumIndex++] = byte;
-                    }
-                    dataIndex++;
-                    
-                    if (dataIndex >= frame.dataLength) {
-                        state = READ_CHECKSUM;
-                    }
-                    break;
-                    
-                case READ_CHECKSUM:
-                    frame.checksum = byte;
-                    state = WAIT_END;
-                    break;
-                    
-                case WAIT_END:
-                    // End karakteri bekleniyor (yukarıda kontrol ediliyor)
-                    break;
+            if (linkProtocol.checksumMode == CHECKSUM_CRC8 &&
+                ++consecutiveChecksumErrors >= RENEGOTIATE_AFTER_CHECKSUM_ERRORS) {
+                LOG_WARN("UART", "⚠️ Art arda CRC hatası - protokol yeniden anlaşılacak");
+                resetLinkProtocol();
             }
+            return false;
         }
-        
-        delay(1);
     }
     
     // Timeout
-    uartStats.timeoutErrors++;
     updateUARTStatistics(false, false, true);
     
-    addLog("⏱️ Frame okuma timeout (" + String(timeout) + "ms)", WARN, "UART");
+    LOG_WARN("UART", "⏱️ Frame okuma timeout (%lums)", timeout);
     return false;
 }
 
-// Komut gönder ve yanıt al (yeni protokol ile) - İYİLEŞTİRİLMİŞ
-bool sendCommandWithProtocol(uint8_t command, const String& data, String& response, unsigned long timeout) {
-    UARTFrame txFrame, rxFrame;
+// Komut gönder ve yanıt al (yeni protokol ile) - owner task kuyruğu üzerinden
+bool sendCommandWithProtocol(uint8_t command, const String& data, String& response, unsigned long timeout,
+                             UARTPriority priority, bool compressReply) {
+    response = "";
     
-    // Timeout varsayılan değer kontrolü
-    if (timeout == 0) {
-        timeout = FRAME_TIMEOUT;
+    // ~800 byte'lık transaction 4096 byte'lık uartTask stack'inde değil, statik havuzda
+    UARTTransaction* pooled = acquireUARTTransaction();
+    if (pooled == NULL) {
+        return false;
     }
-    
-    // TX frame oluştur
-    if (!createFrame(txFrame, command, (uint8_t*)data.c_str(), data.length())) {
-        addLog("❌ TX frame oluşturulamadı", ERROR, "UART");
+    UARTTransaction& transaction = *pooled;
+    if (!prepareFrameTransaction(transaction, command, (const uint8_t*)data.c_str(), data.length(), timeout, priority)) {
+        releaseUARTTransaction(pooled);
         return false;
     }
-    
-    // Frame gönder
-    if (!sendFrame(txFrame)) {
-        addLog("❌ Frame gönderilemedi", ERROR, "UART");
+    transaction.compressReply = compressReply;
+    
+    if (!executeUARTTransaction(transaction)) {
+        switch (transaction.status) {
+            case UART_STATUS_NACK:
+                LOG_ERROR("UART", "❌ Backend NACK yanıtı gönderdi");
+                response = "NACK";
+                break;
+            case UART_STATUS_TIMEOUT:
+                LOG_ERROR("UART", "❌ Yanıt frame'i alınamadı");
+                break;
+            default:
+                LOG_ERROR("UART", "❌ Frame gönderilemedi (%s)", transactionStatusToString(transaction.status));
+                break;
+        }
+        releaseUARTTransaction(pooled);
         return false;
     }
     
-    // Yanıt bekle
-    if (!receiveFrame(rxFrame, timeout)) {
-        addLog("❌ Yanıt frame'i alınamadı", ERROR, "UART");
-        return false;
+    response = transactionResponseString(transaction);
+    releaseUARTTransaction(pooled);
+    
+    LOG_DEBUG("UART", "✅ Komut başarılı - Yanıt: %.20s%s", response.c_str(), response.length() > 20 ? "..." : "");
+    
+    return true;
+}
+
+// pumpReceivedFrames hedefi - olaylar burada ayıklanır
+struct PumpTarget {
+    FrameHandler handler;
+    void* context;
+};
+
+static bool demuxFrame(const UARTFrame& frame, void* context) {
+    if (frame.command == CMD_FAULT_EVENT) {
+        handleFaultEventFrame(frame);
+        return true;
+    }
+    PumpTarget* target = static_cast<PumpTarget*>(context);
+    return target->handler ? target->handler(frame, target->context) : true;
+}
+
+// Halkada biriken byte'ları bloklamadan çözücüye ver - boru hattı yanıtları için
+uint32_t pumpReceivedFrames(FrameHandler handler, void* context) {
+    PumpTarget target = {handler, context};
+    rxDecoder.setHandler(demuxFrame, &target);
+    uint32_t checksumErrorsBefore = rxDecoder.checksumErrors();
+    uint32_t framesBefore = rxDecoder.framesDecoded();
+    
+    const uint8_t* span;
+    size_t available;
+    while ((available = uartLinkPeek(&span)) > 0) {
+        uartLinkConsume(rxDecoder.push(span, available));
+    }
+    
+    uint32_t frames = rxDecoder.framesDecoded() - framesBefore;
+    uint32_t checksumErrors = rxDecoder.checksumErrors() - checksumErrorsBefore;
+    
+    uartStats.totalFramesReceived += frames;
+    if (frames > 0) {
+        consecutiveChecksumErrors = 0;
     }
     
-    // Yanıt komutunu kontrol et
-    if (rxFrame.command == CMD_NACK) {
-        addLog("❌ Backend NACK yanıtı gönderdi", ERROR, "UART");
-        response = "NACK";
+    for (uint32_t i = 0; i < checksumErrors; i++) {
+        updateUARTStatistics(false, true, false);
+    }
+    if (checksumErrors > 0 && linkProtocol.checksumMode == CHECKSUM_CRC8) {
+        consecutiveChecksumErrors += checksumErrors;
+        if (consecutiveChecksumErrors >= RENEGOTIATE_AFTER_CHECKSUM_ERRORS) {
+            LOG_WARN("UART", "⚠️ Art arda CRC hatası - protokol yeniden anlaşılacak");
+            resetLinkProtocol();
+        }
+    }
+    
+    return checksumErrors;
+}
+
+void flushLinkInput() {
+    if (peerSupports(CAP_FAULT_EVENT)) {
+        pumpReceivedFrames(NULL, NULL);
+    }
+    uartLinkFlushInput();
+}
+
+// Bağlantıyı v1 (XOR) varsayılanına döndür; owner task bir sonraki boş anda el sıkışır
+void resetLinkProtocol() {
+    linkProtocol.peerVersion = 1;
+    linkProtocol.capabilities = 0;
+    linkProtocol.checksumMode = CHECKSUM_XOR;
+    linkProtocol.framing = FRAMING_STX_ETX;
+    linkProtocol.negotiated = false;
+    linkProtocol.sequenced = false;
+    linkProtocol.window = 1;
+    consecutiveChecksumErrors = 0;
+    rxDecoder.setChecksumMode(CHECKSUM_XOR);
+    rxDecoder.setSequenced(false);
+    rxDecoder.setFraming(FRAMING_STX_ETX);
+}
+
+// Sürüm el sıkışması. İstek her zaman XOR + STX/ETX ile gönderilir; dsPIC (v2+) yanıtını
+// da aynı biçimde verir ve yanıttan sonra anlaşılan moda geçer. dsPIC, CMD_GET_VERSION'ı
+// hangi modda olursa olsun kabul etmelidir (ESP32 tarafı resetlenmiş olabilir).
+// İstek/yanıt verisi: [sürüm, yetenekler, pencere]; eski v2 yanıtında pencere yoktur.
+// Sadece owner task çağırır (hattı doğrudan kullanır).
+bool negotiateProtocolVersion() {
+    resetLinkProtocol();
+    linkProtocol.negotiated = true; // Deneme yapıldı - başarısızsa v1 ile devam
+    
+    uint8_t offer[3] = {UART_PROTOCOL_VERSION, UART_LOCAL_CAPABILITIES, UART_PIPELINE_WINDOW};
+    UARTFrame reply;
+    
+    if (!sendCommandFrame(CMD_GET_VERSION, offer, sizeof(offer)) ||
+        !receiveFrame(reply, VERSION_TIMEOUT) ||
+        reply.command == CMD_NACK || reply.dataLength < 2) {
+        LOG_INFO("UART", "ℹ️ dsPIC sürüm el sıkışması yok - protokol v1 (XOR)");
         return false;
     }
     
-    // Yanıtı string'e çevir
-    response = "";
-    for (uint16_t i = 0; i < rxFrame.dataLength; i++) {
-        response += (char)rxFrame.data[i];
+    linkProtocol.peerVersion = reply.data[0];
+    linkProtocol.capabilities = reply.data[1] & UART_LOCAL_CAPABILITIES;
+    
+    if (linkProtocol.capabilities & CAP_CRC8) {
+        linkProtocol.checksumMode = CHECKSUM_CRC8;
+        rxDecoder.setChecksumMode(CHECKSUM_CRC8);
     }
     
-    addLog("✅ Komut başarılı - Yanıt: " + response.substring(0, 20) + 
-           (response.length() > 20 ? "..." : ""), DEBUG, "UART");
+    if (linkProtocol.capabilities & CAP_SEQUENCE) {
+        uint8_t peerWindow = reply.dataLength >= 3 ? reply.data[2] : 1;
+        if (peerWindow == 0) peerWindow = 1;
+        linkProtocol.sequenced = true;
+        linkProtocol.window = peerWindow < UART_PIPELINE_WINDOW ? peerWindow : UART_PIPELINE_WINDOW;
+        rxDecoder.setSequenced(true);
+    }
     
+    if (linkProtocol.capabilities & CAP_COBS) {
+        linkProtocol.framing = FRAMING_COBS;
+        rxDecoder.setFraming(FRAMING_COBS);
+    }
+    
+    LOG_SUCCESS("UART", "✅ Protokol anlaşıldı - dsPIC v%u, Checksum: %s, Pencere: %u, Biçim: %s",
+            linkProtocol.peerVersion, linkProtocol.checksumMode == CHECKSUM_CRC8 ? "CRC-8" : "XOR",
+            linkProtocol.window, linkProtocol.framing == FRAMING_COBS ? "COBS" : "STX/ETX");
     return true;
 }
 
 // Gelişmiş komut gönderme fonksiyonları - İYİLEŞTİRİLMİŞ
 
-bool requestTimeWithProtocol() {
+bool requestTimeWithProtocol(String& timeResponse) {
     String response;
-    if (sendCommandWithProtocol(CMD_GET_TIME, "", response, 3000)) {
+    if (sendCommandWithProtocol(CMD_GET_TIME, "", response, 3000, UART_PRIORITY_BACKGROUND)) {
         // Response formatları: "DDMMYYHHMMSS" veya "DATE:DDMMYY,TIME:HHMMSS"
         if (response.length() >= 12) {
-            addLog("✅ Zaman bilgisi alındı: " + response, SUCCESS, "UART");
-            lastResponse = response;
+            LOG_SUCCESS("UART", "✅ Zaman bilgisi alındı: %s", response.c_str());
+            timeResponse = response;
             return true;
         } else {
-            addLog("❌ Geçersiz zaman formatı: " + response, ERROR, "UART");
+            LOG_ERROR("UART", "❌ Geçersiz zaman formatı: %s", response.c_str());
         }
     }
     return false;
@@ -358,98 +377,61 @@ bool sendNTPConfigWithProtocol(const String& server1, const String& server2) {
     
     if (sendCommandWithProtocol(CMD_SET_NTP, data, response, 3000)) {
         if (response == "ACK" || response.indexOf("OK") >= 0) {
-            addLog("✅ NTP config başarıyla gönderildi", SUCCESS, "UART");
+            LOG_SUCCESS("UART", "✅ NTP config başarıyla gönderildi");
             return true;
         } else {
-            addLog("⚠️ NTP config yanıtı: " + response, WARN, "UART");
+            LOG_WARN("UART", "⚠️ NTP config yanıtı: %s", response.c_str());
             return true; // Yanıt varsa başarılı say
         }
     }
-    addLog("❌ NTP config gönderilemedi", ERROR, "UART");
+    LOG_ERROR("UART", "❌ NTP config gönderilemedi");
     return false;
 }
 
-bool requestFirstFaultWithProtocol() {
+bool requestFirstFaultWithProtocol(String& record) {
     String response;
-    if (sendCommandWithProtocol(CMD_GET_FIRST_FAULT, "", response, 5000)) {
+    if (sendCommandWithProtocol(CMD_GET_FIRST_FAULT, "", response, 5000, UART_PRIORITY_INTERACTIVE)) {
         if (response.length() > 0) {
-            addLog("✅ İlk arıza kaydı alındı (" + String(response.length()) + " byte)", SUCCESS, "UART");
-            lastResponse = response;
+            LOG_SUCCESS("UART", "✅ İlk arıza kaydı alındı (%u byte)", response.length());
+            record = response;
             return true;
         }
     }
-    addLog("❌ İlk arıza kaydı alınamadı", ERROR, "UART");
+    LOG_ERROR("UART", "❌ İlk arıza kaydı alınamadı");
     return false;
 }
 
-bool requestNextFaultWithProtocol() {
+bool requestNextFaultWithProtocol(String& record) {
     String response;
-    if (sendCommandWithProtocol(CMD_GET_NEXT_FAULT, "", response, 5000)) {
+    if (sendCommandWithProtocol(CMD_GET_NEXT_FAULT, "", response, 5000, UART_PRIORITY_INTERACTIVE)) {
         if (response.length() > 0) {
-            addLog("✅ Sonraki arıza kaydı alındı (" + String(response.length()) + " byte)", SUCCESS, "UART");
-            lastResponse = response;
+            LOG_SUCCESS("UART", "✅ Sonraki arıza kaydı alındı (%u byte)", response.length());
+            record = response;
             return true;
         } else {
-            addLog("ℹ️ Daha fazla arıza kaydı yok", INFO, "UART");
-            lastResponse = "EOL"; // End of List
+            LOG_INFO("UART", "ℹ️ Daha fazla arıza kaydı yok");
+            record = "EOL"; // End of List
             return true;
         }
     }
-    addLog("❌ Sonraki arıza kaydı alınamadı", ERROR, "UART");
+    LOG_ERROR("UART", "❌ Sonraki arıza kaydı alınamadı");
     return false;
 }
 
 // Ping komutu - bağlantı testi - İYİLEŞTİRİLMİŞ
 bool pingBackend() {
     String response;
-    if (sendCommandWithProtocol(CMD_PING, "PING", response, 2000)) {
+    if (sendCommandWithProtocol(CMD_PING, "PING", response, 2000, UART_PRIORITY_BACKGROUND)) {
         if (response == "PONG" || response == "ACK" || response.indexOf("OK") >= 0) {
             return true;
         } else {
-            addLog("🏓 Ping yanıtı: " + response, DEBUG, "UART");
+            LOG_DEBUG("UART", "🏓 Ping yanıtı: %s", response.c_str());
             return true; // Herhangi bir yanıt varsa backend canlı
         }
     }
     return false;
 }
 
-// UART sağlık kontrolü - DÜZELTİLMİŞ VERSİYON
-void checkUARTHealthWithProtocol() {
-    static unsigned long lastPing = 0;
-    static int consecutiveFailures = 0;
-    const unsigned long PING_INTERVAL = 30000; // 30 saniye
-    
-    if (millis() - lastPing > PING_INTERVAL) {
-        lastPing = millis();
-        
-        if (pingBackend()) {
-            consecutiveFailures = 0;
-            if (!uartHealthy) {
-                uartHealthy = true;
-                addLog("✅ UART bağlantısı düzeldi", SUCCESS, "UART");
-            }
-        } else {
-            consecutiveFailures++;
-            addLog("⚠️ UART ping başarısız (#" + String(consecutiveFailures) + ")", WARN, "UART");
-            
-            if (consecutiveFailures >= 3) {
-                uartHealthy = false;
-                addLog("❌ UART bağlantısı kayıp", ERROR, "UART");
-                
-                // UART'ı yeniden başlat - DÜZELTİLMİŞ
-                if (consecutiveFailures >= 5) {
-                    addLog("🔄 UART yeniden başlatılıyor...", WARN, "UART");
-                    initUART(); // uart_handler.h'den import edildi
-                    consecutiveFailures = 0;
-                    
-                    // İstatistikleri sıfırla
-                    uartStats.frameErrors++;
-                }
-            }
-        }
-    }
-}
-
 // İstatistikleri güncelle - İYİLEŞTİRİLMİŞ
 void updateUARTStatistics(bool success, bool checksumError, bool timeoutError) {
     if (success) {
@@ -498,7 +480,23 @@ String getUARTStatisticsJSON() {
     doc["frameErrors"] = uartStats.frameErrors;
     doc["successRate"] = round(uartStats.successRate * 100) / 100.0;
     doc["healthy"] = uartHealthy;
-    doc["lastResponse"] = lastResponse.length() > 50 ? lastResponse.substring(0, 47) + "..." : lastResponse;
+    fillUARTBreakerJSON(doc["breaker"].to<JsonObject>());
+    doc["protocolVersion"] = linkProtocol.peerVersion;
+    doc["checksumMode"] = linkProtocol.checksumMode == CHECKSUM_CRC8 ? "CRC-8" : "XOR";
+    doc["window"] = linkProtocol.window;
+    doc["framing"] = linkProtocol.framing == FRAMING_COBS ? "COBS" : "STX/ETX";
+    doc["linkRate"] = linkRate.currentRate;
+    doc["linkRateFallbacks"] = linkRate.fallbacks;
+    doc["linkRateCeiling"] = linkRate.ceilingRate;
+    doc["retransmits"] = uartArbiterStats.retransmits;
+    doc["staleResponses"] = uartArbiterStats.staleResponses;
+    doc["peakInflight"] = uartArbiterStats.peakInflight;
+    doc["lzssIn"] = uartArbiterStats.compressedBytes;
+    doc["lzssOut"] = uartArbiterStats.inflatedBytes;
+    doc["queueDepth"] = getUARTQueueDepth();
+    doc["queueExpired"] = uartArbiterStats.expired;
+    doc["queueRejected"] = uartArbiterStats.rejected;
+    doc["maxQueueWaitMs"] = uartArbiterStats.maxQueueWaitMs;
     doc["timestamp"] = millis();
     
     // Ek bilgiler
@@ -506,6 +504,9 @@ String getUARTStatisticsJSON() {
     doc["totalErrors"] = totalErrors;
     doc["uptime"] = millis() / 1000;
     
+    // Komut başına gecikme dağılımı ve son 1/5/60 dakikanın hata oranı
+    fillUARTStatsJSON(doc);
+    
     String output;
     serializeJson(doc, output);
     return output;
@@ -519,10 +520,10 @@ bool setBaudRateWithProtocol(long baudRate) {
     
     if (sendCommandWithProtocol(CMD_SET_BAUDRATE, data, response, 3000)) {
         if (response == "ACK" || response.indexOf("OK") >= 0) {
-            addLog("✅ BaudRate ayarı gönderildi: " + String(baudRate), SUCCESS, "UART");
+            LOG_SUCCESS("UART", "✅ BaudRate ayarı gönderildi: %ld", baudRate);
             return true;
         } else {
-            addLog("⚠️ BaudRate yanıtı: " + response, WARN, "UART");
+            LOG_WARN("UART", "⚠️ BaudRate yanıtı: %s", response.c_str());
         }
     }
     return false;
@@ -531,7 +532,7 @@ bool setBaudRateWithProtocol(long baudRate) {
 bool getStatusWithProtocol(String& statusData) {
     if (sendCommandWithProtocol(CMD_GET_STATUS, "", statusData, 3000)) {
         if (statusData.length() > 0) {
-            addLog("✅ Backend status alındı", SUCCESS, "UART");
+            LOG_SUCCESS("UART", "✅ Backend status alındı");
             return true;
         }
     }
@@ -542,7 +543,7 @@ bool resetBackendWithProtocol() {
     String response;
     if (sendCommandWithProtocol(CMD_RESET, "RESET", response, 5000)) {
         if (response == "ACK" || response.indexOf("OK") >= 0) {
-            addLog("✅ Backend reset komutu gönderildi", SUCCESS, "UART");
+            LOG_SUCCESS("UART", "✅ Backend reset komutu gönderildi");
             return true;
         }
     }
@@ -553,7 +554,7 @@ bool clearFaultsWithProtocol() {
     String response;
     if (sendCommandWithProtocol(CMD_CLEAR_FAULTS, "", response, 3000)) {
         if (response == "ACK" || response.indexOf("OK") >= 0) {
-            addLog("✅ Arıza kayıtları temizlendi", SUCCESS, "UART");
+            LOG_SUCCESS("UART", "✅ Arıza kayıtları temizlendi");
             return true;
         }
     }
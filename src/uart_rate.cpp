@@ -0,0 +1,231 @@
+// uart_rate.cpp - dsPIC bağlantı hızı anlaşması ve hata oranına göre geri düşme
+#include "uart_rate.h"
+#include "uart_protocol.h"
+#include "uart_link.h"
+#include "log_system.h"
+#include <Preferences.h>
+
+LinkRateState linkRate = {115200, 115200, 0, false, 0, 0, 0, 0};
+static bool storedStateLoaded = false;
+
+// Denenecek hızlar - yüksekten düşüğe
+static const long linkRates[] = {921600, 460800, 230400};
+static const int LINK_RATE_COUNT = sizeof(linkRates) / sizeof(linkRates[0]);
+
+// Çalışma sırasında hata oranı örneklemesi
+static unsigned long sampleFrames = 0;
+static unsigned long sampleErrors = 0;
+
+static UARTFrame rateReply;
+
+static unsigned long linkErrorCount() {
+    return uartStats.checksumErrors + uartStats.timeoutErrors + uartStats.frameErrors;
+}
+
+static void restartErrorSample() {
+    sampleFrames = uartStats.totalFramesSent;
+    sampleErrors = linkErrorCount();
+}
+
+static void loadStoredState() {
+    Preferences prefs;
+    prefs.begin(LINK_RATE_NVS_NAMESPACE, true);
+    linkRate.storedRate = prefs.getLong("rate", 0);
+    linkRate.ceilingRate = prefs.getLong("ceiling", 0);
+    linkRate.ceilingLeft = prefs.getUChar("ceilLeft", 0);
+    prefs.end();
+}
+
+static void storeRate(long rate) {
+    if (rate == linkRate.storedRate) {
+        return;
+    }
+    Preferences prefs;
+    prefs.begin(LINK_RATE_NVS_NAMESPACE, false);
+    prefs.putLong("rate", rate);
+    prefs.end();
+    linkRate.storedRate = rate;
+}
+
+static void storeCeiling(long rate, uint8_t left) {
+    Preferences prefs;
+    prefs.begin(LINK_RATE_NVS_NAMESPACE, false);
+    prefs.putLong("ceiling", rate);
+    prefs.putUChar("ceilLeft", left);
+    prefs.end();
+    linkRate.ceilingRate = rate;
+    linkRate.ceilingLeft = left;
+}
+
+void resetLinkRate(long baseRate) {
+    linkRate.baseRate = baseRate;
+    linkRate.currentRate = baseRate;
+    linkRate.negotiated = false;
+}
+
+static bool exchangeFrame(uint8_t command, const uint8_t* data, uint16_t length, unsigned long timeout) {
+    return sendCommandFrame(command, data, length) &&
+           receiveFrame(rateReply, timeout) &&
+           rateReply.command != CMD_NACK;
+}
+
+// Yeni hızda ping grubu - en fazla LINK_RATE_MAX_BURST_ERRORS kayıp kabul edilir
+static bool verifyWithPingBurst() {
+    int failures = 0;
+    for (int i = 0; i < LINK_RATE_PING_BURST; i++) {
+        if (!exchangeFrame(CMD_PING, (const uint8_t*)"PING", 4, LINK_RATE_PING_TIMEOUT)) {
+            if (++failures > LINK_RATE_MAX_BURST_ERRORS) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// İki tarafı birlikte yeni hıza geçir; doğrulama başarısızsa önceki hıza dön
+static bool switchLinkRate(long rate) {
+    long previousRate = linkRate.currentRate;
+    uint8_t request[4] = {
+        (uint8_t)(rate >> 24), (uint8_t)(rate >> 16), (uint8_t)(rate >> 8), (uint8_t)rate
+    };
+
+    if (!exchangeFrame(CMD_SET_LINK_RATE, request, sizeof(request), VERSION_TIMEOUT) ||
+        rateReply.command != CMD_ACK) {
+        return false; // dsPIC bu hızı desteklemiyor
+    }
+
+    // dsPIC ACK'in son byte'ını gönderdikten sonra hızını değiştirir
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_SETTLE_MS));
+    if (!uartLinkSetBaudRate(rate)) {
+        return false;
+    }
+
+    if (verifyWithPingBurst() &&
+        exchangeFrame(CMD_COMMIT_LINK_RATE, nullptr, 0, VERSION_TIMEOUT) && rateReply.command == CMD_ACK) {
+        linkRate.currentRate = rate;
+        restartErrorSample();
+        return true;
+    }
+
+    // Commit yok - dsPIC LINK_RATE_REVERT_MS sonunda önceki hıza döner
+    LOG_WARN("UART", "⚠️ %ld baud doğrulanamadı, %ld baud'a dönülüyor", rate, previousRate);
+    uartLinkSetBaudRate(previousRate);
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_REVERT_MS));
+    uartLinkFlushInput();
+    return false;
+}
+
+// Geri düşme sınırı geçerliyse bir anlaşma hakkı düşülür ve sınır döner; hak bittiyse
+// sınır silinir, expired işaretlenir (0: sınır yok)
+static long takeCeiling(bool& expired) {
+    expired = false;
+    if (linkRate.ceilingRate == 0) {
+        return 0;
+    }
+    if (linkRate.ceilingLeft == 0) {
+        LOG_INFO("UART", "🔼 Bağlantı hızı sınırı (%ld baud) süresi doldu - yüksek hızlar deneniyor", linkRate.ceilingRate);
+        storeCeiling(0, 0);
+        expired = true;
+        return 0;
+    }
+    long ceiling = linkRate.ceilingRate;
+    storeCeiling(ceiling, linkRate.ceilingLeft - 1);
+    return ceiling;
+}
+
+// Kayıtlı hız önce denenir (tek geçiş), yoksa en yüksekten aşağı doğru taranır.
+// Sadece şu anki hızdan yüksek ve (varsa) geri düşme sınırını aşmayan hızlar denenir;
+// sınırın süresi yeni dolduysa kayıtlı hız atlanır ve tarama en yüksekten başlar.
+bool negotiateLinkRate() {
+    linkRate.negotiated = true;
+    linkRate.negotiatedAt = millis();
+    if (!peerSupports(CAP_LINK_RATE)) {
+        return false;
+    }
+
+    if (!storedStateLoaded) {
+        loadStoredState();
+        storedStateLoaded = true;
+    }
+    bool expired;
+    long ceiling = takeCeiling(expired);
+
+    bool switched = false;
+    bool tryStored = !expired && linkRate.storedRate > linkRate.currentRate &&
+                     (ceiling == 0 || linkRate.storedRate <= ceiling);
+    if (tryStored) {
+        switched = switchLinkRate(linkRate.storedRate);
+    }
+
+    for (int i = 0; i < LINK_RATE_COUNT && !switched; i++) {
+        if (linkRates[i] <= linkRate.currentRate || (tryStored && linkRates[i] == linkRate.storedRate)) {
+            continue;
+        }
+        if (ceiling > 0 && linkRates[i] > ceiling) {
+            continue;
+        }
+        switched = switchLinkRate(linkRates[i]);
+    }
+
+    if (!switched) {
+        LOG_INFO("UART", "ℹ️ Bağlantı hızı %ld baud'da kaldı", linkRate.currentRate);
+        return false;
+    }
+
+    storeRate(linkRate.currentRate);
+    LOG_SUCCESS("UART", "✅ Bağlantı hızı %ld baud", linkRate.currentRate);
+    return true;
+}
+
+// Yüksek hızda hata oranı eşiği aşılırsa bir alt hıza in. Geçiş yapılamazsa
+// temel hıza dönülür; dsPIC sessizlik süresi sonunda aynısını yapar.
+void checkLinkRateHealth() {
+    if (!linkRate.negotiated) {
+        return;
+    }
+
+    // Sınır altında uzun süre çalışılıyorsa yeniden anlaşma - her biri sınırdan bir hak düşer
+    if (linkRate.ceilingRate > 0 && millis() - linkRate.negotiatedAt >= LINK_RATE_REPROBE_MS) {
+        linkRate.negotiated = false;
+        return;
+    }
+
+    if (linkRate.currentRate <= linkRate.baseRate) {
+        return;
+    }
+
+    unsigned long frames = uartStats.totalFramesSent - sampleFrames;
+    if (frames < LINK_RATE_ERROR_WINDOW) {
+        return;
+    }
+
+    unsigned long errors = linkErrorCount() - sampleErrors;
+    restartErrorSample();
+    if (errors * 100 <= frames * LINK_RATE_MAX_ERROR_PERCENT) {
+        return;
+    }
+
+    linkRate.fallbacks++;
+    LOG_WARN("UART", "⚠️ Hata oranı yüksek (%lu/%lu) - bağlantı hızı düşürülüyor", errors, frames);
+
+    long lowerRate = linkRate.baseRate;
+    for (int i = 0; i < LINK_RATE_COUNT; i++) {
+        if (linkRates[i] < linkRate.currentRate && linkRates[i] > linkRate.baseRate) {
+            lowerRate = linkRates[i];
+            break;
+        }
+    }
+
+    if (lowerRate == linkRate.baseRate || !switchLinkRate(lowerRate)) {
+        uartLinkSetBaudRate(linkRate.baseRate);
+        linkRate.currentRate = linkRate.baseRate;
+        vTaskDelay(pdMS_TO_TICKS(LINK_RATE_SILENCE_MS));
+        uartLinkFlushInput();
+        resetLinkProtocol();
+    }
+
+    // Sonraki LINK_RATE_CAP_NEGOTIATIONS anlaşmada (açılış ya da periyodik) bu hızın üstü
+    // denenmez; sonra sınır kalkar. Tek bir hata patlaması hızı kalıcı olarak düşürmez.
+    storeCeiling(lowerRate, LINK_RATE_CAP_NEGOTIATIONS);
+    linkRate.negotiatedAt = millis();
+}
@@ -0,0 +1,207 @@
+// uart_stats.cpp - UART işlem gecikme histogramları ve kayan pencere hata oranları
+#include "uart_stats.h"
+#include "uart_link.h"
+
+static UARTCommandStats commandStats[UART_STATS_MAX_COMMANDS];
+static uint8_t commandCount = 0;
+static uint8_t commandIndex[256];           // Komut kodu -> tablo satırı + 1 (0: atanmamış)
+
+// Kuyrukta bekleme - hat mı yoksa sıra mı yavaş ayırt etmek için
+static UARTLatencyHistogram queueWait;
+
+// Kayan pencere: UART_STATS_SLOT_MS'lik dilimler halinde başarılı/hatalı işlem
+struct ErrorSlot {
+    uint16_t ok;
+    uint16_t errors;
+};
+
+static ErrorSlot errorSlots[UART_STATS_SLOTS];
+static uint32_t currentEpoch = 0;           // En son yazılan dilim (millis / SLOT_MS)
+
+static uint8_t bucketFor(uint32_t ms) {
+    if (ms == 0) return 0;
+    uint8_t bucket = 32 - __builtin_clz(ms);  // 1 -> 1, 2-3 -> 2, 4-7 -> 3 ...
+    return bucket < UART_STATS_BUCKETS ? bucket : UART_STATS_BUCKETS - 1;
+}
+
+static void addSample(UARTLatencyHistogram& histogram, uint32_t ms) {
+    histogram.buckets[bucketFor(ms)]++;
+    histogram.count++;
+    histogram.totalMs += ms;
+    if (ms > histogram.maxMs) histogram.maxMs = ms;
+}
+
+static UARTCommandStats& statsFor(uint8_t command) {
+    uint8_t slot = commandIndex[command];
+    if (slot != 0) {
+        return commandStats[slot - 1];
+    }
+
+    // Tablo dolduysa son satır tüm kalan komutları toplar
+    if (commandCount >= UART_STATS_MAX_COMMANDS - 1) {
+        UARTCommandStats& other = commandStats[UART_STATS_MAX_COMMANDS - 1];
+        other.command = UART_STATS_OTHER_COMMAND;
+        return other;
+    }
+
+    UARTCommandStats& entry = commandStats[commandCount];
+    entry.command = command;
+    commandIndex[command] = ++commandCount;
+    return entry;
+}
+
+// Dilimi ilerlet - aradaki boş dilimler temizlenir (en fazla UART_STATS_SLOTS adım)
+static ErrorSlot& currentSlot(unsigned long now) {
+    uint32_t epoch = now / UART_STATS_SLOT_MS;
+    if (epoch != currentEpoch) {
+        uint32_t steps = epoch - currentEpoch;
+        if (steps > UART_STATS_SLOTS) steps = UART_STATS_SLOTS;
+        for (uint32_t i = 1; i <= steps; i++) {
+            ErrorSlot& slot = errorSlots[(currentEpoch + i) % UART_STATS_SLOTS];
+            slot.ok = 0;
+            slot.errors = 0;
+        }
+        currentEpoch = epoch;
+    }
+    return errorSlots[epoch % UART_STATS_SLOTS];
+}
+
+void recordUARTTransaction(const UARTTransaction& transaction) {
+    uint8_t command = transaction.kind == UART_TRANSACTION_TEXT ? UART_STATS_TEXT_COMMAND : transaction.command;
+    UARTCommandStats& stats = statsFor(command);
+
+    if (transaction.status == UART_STATUS_EXPIRED || transaction.status == UART_STATUS_REJECTED ||
+        transaction.status == UART_STATUS_CIRCUIT_OPEN) {
+        stats.expired++;
+        return;
+    }
+
+    addSample(queueWait, transaction.startedAt - transaction.queuedAt);
+    addSample(stats.latency, transaction.completedAt - transaction.startedAt);
+    stats.retries += transaction.retries;
+    stats.bytesOut += (uint32_t)transaction.requestLength * (1 + transaction.retries);
+    stats.bytesIn += transaction.responseLength + transaction.streamBytes;
+
+    ErrorSlot& slot = currentSlot(transaction.completedAt);
+    if (transaction.status == UART_STATUS_OK) {
+        stats.ok++;
+        if (slot.ok < UINT16_MAX) slot.ok++;
+    } else {
+        stats.errors++;
+        if (transaction.status == UART_STATUS_TIMEOUT) stats.timeouts++;
+        if (slot.errors < UINT16_MAX) slot.errors++;
+    }
+}
+
+// Kova içinde doğrusal ara değer - log2 kovalarda hata kova genişliğinin yarısı kadar
+static uint32_t percentile(const UARTLatencyHistogram& histogram, uint8_t percent) {
+    if (histogram.count == 0) return 0;
+
+    uint32_t target = ((uint64_t)histogram.count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < UART_STATS_BUCKETS; i++) {
+        uint32_t inBucket = histogram.buckets[i];
+        if (inBucket == 0 || seen + inBucket < target) {
+            seen += inBucket;
+            continue;
+        }
+
+        uint32_t low = i == 0 ? 0 : (1UL << (i - 1));
+        uint32_t high = i == 0 ? 0 : (1UL << i) - 1;
+        uint32_t value = low + (uint64_t)(high - low) * (target - seen) / inBucket;
+        return value < histogram.maxMs ? value : histogram.maxMs;
+    }
+    return histogram.maxMs;
+}
+
+static void fillHistogram(JsonObject object, const UARTLatencyHistogram& histogram) {
+    object["count"] = histogram.count;
+    object["avg"] = histogram.count ? histogram.totalMs / histogram.count : 0;
+    object["p50"] = percentile(histogram, 50);
+    object["p95"] = percentile(histogram, 95);
+    object["p99"] = percentile(histogram, 99);
+    object["max"] = histogram.maxMs;
+
+    // Sondaki boş kovalar gönderilmez
+    int last = UART_STATS_BUCKETS - 1;
+    while (last >= 0 && histogram.buckets[last] == 0) last--;
+    JsonArray buckets = object["buckets"].to<JsonArray>();
+    for (int i = 0; i <= last; i++) {
+        buckets.add(histogram.buckets[i]);
+    }
+}
+
+// Son 'minutes' dakikadaki hata oranı (%); işlem yoksa -1
+static void fillErrorWindow(JsonObject object, unsigned long now, uint16_t minutes) {
+    uint32_t slots = (uint32_t)minutes * 60000UL / UART_STATS_SLOT_MS;
+    uint32_t idle = now / UART_STATS_SLOT_MS - currentEpoch;   // Yazılmayan son dilimler
+    uint32_t ok = 0;
+    uint32_t errors = 0;
+
+    for (uint32_t i = idle; i < slots; i++) {
+        const ErrorSlot& slot = errorSlots[(currentEpoch + UART_STATS_SLOTS - (i - idle)) % UART_STATS_SLOTS];
+        ok += slot.ok;
+        errors += slot.errors;
+    }
+
+    object["transactions"] = ok + errors;
+    object["errors"] = errors;
+    object["errorRate"] = (ok + errors) ? round(errors * 10000.0 / (ok + errors)) / 100.0 : -1;
+}
+
+static const char* commandName(uint8_t command) {
+    switch (command) {
+        case UART_STATS_TEXT_COMMAND:  return "text";
+        case UART_STATS_OTHER_COMMAND: return "other";
+        case CMD_GET_TIME:             return "getTime";
+        case CMD_SET_NTP:              return "setNtp";
+        case CMD_GET_NTP:              return "getNtp";
+        case CMD_GET_FIRST_FAULT:      return "firstFault";
+        case CMD_GET_NEXT_FAULT:       return "nextFault";
+        case CMD_CLEAR_FAULTS:         return "clearFaults";
+        case CMD_GET_FAULT_RANGE:      return "faultRange";
+        case CMD_SET_BAUDRATE:         return "setBaudrate";
+        case CMD_SET_LINK_RATE:        return "setLinkRate";
+        case CMD_COMMIT_LINK_RATE:     return "commitLinkRate";
+        case CMD_PING:                 return "ping";
+        case CMD_GET_VERSION:          return "version";
+        case CMD_RESET:                return "reset";
+        case CMD_GET_STATUS:           return "status";
+        default:                       return NULL;
+    }
+}
+
+void fillUARTStatsJSON(JsonDocument& doc) {
+    unsigned long now = millis();
+
+    doc["bytesIn"] = uartLinkStats.bytesReceived;
+    doc["bytesOut"] = uartLinkStats.bytesSent;
+    doc["lineErrors"] = uartLinkStats.lineErrors;
+    doc["overflows"] = uartLinkStats.ringOverflows + uartLinkStats.fifoOverflows;
+
+    JsonObject windows = doc["errorWindows"].to<JsonObject>();
+    fillErrorWindow(windows["1m"].to<JsonObject>(), now, 1);
+    fillErrorWindow(windows["5m"].to<JsonObject>(), now, 5);
+    fillErrorWindow(windows["60m"].to<JsonObject>(), now, 60);
+
+    fillHistogram(doc["queueWait"].to<JsonObject>(), queueWait);
+
+    JsonArray commands = doc["commands"].to<JsonArray>();
+    for (uint8_t i = 0; i < UART_STATS_MAX_COMMANDS; i++) {
+        const UARTCommandStats& stats = commandStats[i];
+        if (stats.ok + stats.errors + stats.expired == 0) continue;
+
+        JsonObject entry = commands.add<JsonObject>();
+        entry["code"] = stats.command;
+        const char* name = commandName(stats.command);
+        if (name) entry["name"] = name;
+        entry["ok"] = stats.ok;
+        entry["errors"] = stats.errors;
+        entry["timeouts"] = stats.timeouts;
+        entry["expired"] = stats.expired;
+        entry["retries"] = stats.retries;
+        entry["bytesOut"] = stats.bytesOut;
+        entry["bytesIn"] = stats.bytesIn;
+        fillHistogram(entry["latency"].to<JsonObject>(), stats.latency);
+    }
+}
@@ -3,7 +3,14 @@
 #include "settings.h"
 #include "ntp_handler.h"
 #include "uart_handler.h"
+#include "fault_jobs.h"
+#include "fault_events.h"
+#include "fault_store.h"
+#include "fault_export.h"
+#include "uart_rate.h"
+#include "uart_protocol.h"
 #include "log_system.h"
+#include "log_store.h"
 #include "backup_restore.h"      // Yeni eklenen
 #include "password_policy.h"     // Yeni eklenen
 #include <LittleFS.h>
@@ -158,14 +165,227 @@ void handleFaultRequest(bool isFirst) {
         return;
     }
     
-    bool success = isFirst ? requestFirstFault() : requestNextFault();
+    // Web task UART yanıtını beklemez: iş kuyruğa alınır, sonuç WebSocket ile
+    // isteyen client'a gider (clientId yoksa herkese), /api/faults/job ile de sorgulanabilir
+    int clientId = server.hasArg("clientId") ? server.arg("clientId").toInt() : -1;
+    uint32_t jobId = createFaultJob(isFirst, clientId);
     
-    if (success) {
-        String response = getLastFaultResponse();
-        server.send(200, "text/plain", response);
+    if (jobId == 0) {
+        server.sendHeader("Retry-After", "1");
+        server.send(503, "application/json", "{\"error\":\"busy\"}");
+        return;
+    }
+    
+    char json[96];
+    snprintf(json, sizeof(json), "{\"jobId\":%lu,\"status\":\"queued\",\"poll\":\"/api/faults/job?id=%lu\"}",
+             (unsigned long)jobId, (unsigned long)jobId);
+    server.send(202, "application/json", json);
+}
+
+// Toplu arıza aktarımı: start/count ile tek istekte en fazla FAULT_RANGE_JOB_RECORDS kayıt
+void handleFaultRangeRequest() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    if (!faultRangeSupported()) {
+        server.send(501, "application/json", "{\"error\":\"range not supported by dsPIC firmware\"}");
+        return;
+    }
+    
+    long start = server.hasArg("start") ? server.arg("start").toInt() : 0;
+    long count = server.hasArg("count") ? server.arg("count").toInt() : FAULT_RANGE_JOB_RECORDS;
+    if (start < 0 || start > 0xFFFF || count < 1) {
+        server.send(400, "application/json", "{\"error\":\"invalid range\"}");
+        return;
+    }
+    
+    int clientId = server.hasArg("clientId") ? server.arg("clientId").toInt() : -1;
+    uint32_t jobId = createFaultRangeJob((uint16_t)start, (uint16_t)min(count, (long)FAULT_RANGE_JOB_RECORDS), clientId);
+    
+    if (jobId == 0) {
+        server.sendHeader("Retry-After", "2");
+        server.send(503, "application/json", "{\"error\":\"busy\"}");
+        return;
+    }
+    
+    char json[96];
+    snprintf(json, sizeof(json), "{\"jobId\":%lu,\"status\":\"queued\",\"poll\":\"/api/faults/job?id=%lu\"}",
+             (unsigned long)jobId, (unsigned long)jobId);
+    server.send(202, "application/json", json);
+}
+
+void handleFaultJobAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    String json = getFaultJobJSON(strtoul(server.arg("id").c_str(), NULL, 10));
+    if (json.length() == 0) {
+        server.send(404, "application/json", "{\"error\":\"unknown job\"}");
+        return;
+    }
+    
+    server.send(200, "application/json", json);
+}
+
+// Kendiliğinden gelen arıza olayları - teslim gecikmesi istatistikleri
+void handleFaultEventStatsAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    server.send(200, "application/json", getFaultEventStatsJSON());
+}
+
+// Yerel arıza deposu sayfası - UART'a gitmez. from yoksa en yeni sayfa döner.
+// Kayıtlar küçük parçalar halinde okunup chunked gönderilir (tüm sayfa bellekte tutulmaz).
+void handleStoredFaultsAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    uint32_t first = getFaultStoreFirstId();
+    uint32_t next = getFaultStoreNextId();
+    long count = server.hasArg("count") ? server.arg("count").toInt() : 20;
+    if (count < 1 || count > FAULT_STORE_PAGE_MAX) {
+        count = FAULT_STORE_PAGE_MAX;
+    }
+    
+    uint32_t from;
+    if (server.hasArg("from")) {
+        from = strtoul(server.arg("from").c_str(), NULL, 10);
     } else {
-        server.send(500, "text/plain", "Error");
+        from = next - first > (uint32_t)count ? next - count : first;
+    }
+    if (from < first) from = first;
+    uint32_t end = min(next, from + (uint32_t)count);
+    if (end < from) end = from;
+    
+    char chunk[768];
+    int length = snprintf(chunk, sizeof(chunk),
+        "{\"first\":%lu,\"next\":%lu,\"from\":%lu,\"count\":%lu,\"records\":[",
+        (unsigned long)first, (unsigned long)next, (unsigned long)from, (unsigned long)(end - from));
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    server.sendContent(chunk, length);
+    
+    StoredFault entries[8];
+    char recordJson[FAULT_RECORD_JSON_MAX];
+    bool firstRecord = true;
+    uint32_t id = from;
+    while (id < end) {
+        size_t read = readStoredFaults(id, entries, min((uint32_t)8, end - id));
+        if (read == 0) break;
+        
+        length = 0;
+        for (size_t i = 0; i < read; i++) {
+            if (faultRecordToJSON(entries[i].record, recordJson, sizeof(recordJson)) == 0) continue;
+            length += snprintf(chunk + length, sizeof(chunk) - length, "%s{\"id\":%lu,\"dspicIndex\":%u,\"record\":%s}",
+                               firstRecord ? "" : ",", (unsigned long)entries[i].id, entries[i].dspicIndex, recordJson);
+            firstRecord = false;
+            
+            // Parça doluysa gönder
+            if (length > (int)(sizeof(chunk) - FAULT_RECORD_JSON_MAX - 64)) {
+                server.sendContent(chunk, length);
+                length = 0;
+            }
+        }
+        if (length > 0) server.sendContent(chunk, length);
+        id += read;
+    }
+    
+    server.sendContent("]}");
+    server.sendContent("");
+}
+
+// Zaman aralığı sorgusu - yerel depodan, UART'a gitmez. Sonuç 'limit'te kesilirse
+// yanıttaki 'after' ile aynı sorgu devam ettirilir.
+void handleFaultQueryAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
     }
+    
+    unsigned long startedAt = millis();
+    FaultQuery query;
+    if (!readFaultQueryArgs(query)) {
+        server.send(400, "application/json", "{\"error\":\"invalid time\"}");
+        return;
+    }
+    
+    long limit = server.hasArg("limit") ? server.arg("limit").toInt() : 100;
+    if (limit < 1 || limit > FAULT_STORE_QUERY_MAX) {
+        limit = FAULT_STORE_QUERY_MAX;
+    }
+    
+    beginFaultQuery(query);
+    if (server.hasArg("after")) {
+        uint32_t after = strtoul(server.arg("after").c_str(), NULL, 10) + 1;
+        if (after > query.cursor) query.cursor = after;
+    }
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    server.sendContent("{\"records\":[");
+    
+    StoredFault entries[8];
+    char recordJson[FAULT_RECORD_JSON_MAX];
+    char chunk[768];
+    long returned = 0;
+    uint32_t lastId = 0;
+    while (returned < limit) {
+        size_t found = continueFaultQuery(query, entries, min((long)8, limit - returned));
+        if (found == 0) break;
+        
+        int length = 0;
+        for (size_t i = 0; i < found; i++) {
+            if (faultRecordToJSON(entries[i].record, recordJson, sizeof(recordJson)) == 0) continue;
+            length += snprintf(chunk + length, sizeof(chunk) - length, "%s{\"id\":%lu,\"record\":%s}",
+                               returned ? "," : "", (unsigned long)entries[i].id, recordJson);
+            lastId = entries[i].id;
+            returned++;
+            
+            if (length > (int)(sizeof(chunk) - FAULT_RECORD_JSON_MAX - 64)) {
+                server.sendContent(chunk, length);
+                length = 0;
+            }
+        }
+        if (length > 0) server.sendContent(chunk, length);
+    }
+    
+    // Limit dolduysa aralıkta kayıt kalmış olabilir
+    bool more = returned == limit && query.cursor < query.end;
+    int length = snprintf(chunk, sizeof(chunk),
+        "],\"count\":%ld,\"scanned\":%lu,\"more\":%s,\"after\":%lu,\"elapsedMs\":%lu}",
+        returned, (unsigned long)query.scanned, more ? "true" : "false",
+        (unsigned long)lastId, millis() - startedAt);
+    server.sendContent(chunk, length);
+    server.sendContent("");
+}
+
+void handleFaultStoreStatsAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    server.send(200, "application/json", getFaultStoreStatsJSON());
+}
+
+// Hat istatistikleri - komut başına gecikme histogramları ve kayan pencere hata oranları
+void handleUARTStatsAPI() {
+    if (!checkSession()) {
+        server.send(401, "text/plain", "Unauthorized");
+        return;
+    }
+    
+    server.send(200, "application/json", getUARTStatisticsJSON());
 }
 
 void handleGetNtpAPI() {
@@ -210,8 +430,8 @@ void handleGetBaudRateAPI() {
         return;
     }
     
-    char json[64];
-    snprintf(json, sizeof(json), "{\"baudRate\":%ld}", settings.currentBaudRate);
+    char json[96];
+    snprintf(json, sizeof(json), "{\"baudRate\":%ld,\"linkRate\":%ld}", settings.currentBaudRate, linkRate.currentRate);
     server.send(200, "application/json", json);
 }
 
@@ -237,21 +457,27 @@ void handleGetLogsAPI() {
         return;
     }
     
-    String json = "[";
-    int count = min(15, totalLogs);
-    
-    for (int i = 0; i < count; i++) {
-        int idx = (logIndex - 1 - i + 50) % 50;
-        if (logs[idx].message.length() > 0) {
-            if (i > 0) json += ",";
-            json += "{\"t\":\"" + logs[idx].timestamp + "\",";
-            json += "\"m\":\"" + logs[idx].message + "\",";
-            json += "\"l\":\"" + logLevelToString(logs[idx].level) + "\",";
-            json += "\"s\":\"" + logs[idx].source + "\"}";
-        }
+    // Son 15 log, en yeni önce
+    JsonDocument doc;
+    JsonArray entries = doc.to<JsonArray>();
+    uint32_t tail = getLogTail();
+    LogEntry entry;
+    char timestamp[32];
+    char message[LOG_MESSAGE_MAX];
+    for (uint32_t sequence = getLogHead(); sequence != tail && entries.size() < 15; ) {
+        sequence--;
+        if (!readLogEntry(sequence, entry)) continue;
+        formatLogTimestamp(entry, timestamp, sizeof(timestamp));
+        formatLogMessage(entry, message, sizeof(message));
+        JsonObject item = entries.add<JsonObject>();
+        item["t"] = timestamp;
+        item["m"] = message;
+        item["l"] = logLevelName(entry.level);
+        item["s"] = logSourceName(entry.sourceId);
     }
-    json += "]";
     
+    String json;
+    serializeJson(doc, json);
     server.send(200, "application/json", json);
 }
 
@@ -265,6 +491,69 @@ void handleClearLogsAPI() {
     server.send(200, "text/plain", "OK");
 }
 
+// Seri konsol log çıktısı - GET durum, POST enabled=0|1 ile aç/kapat
+void handleLogConsoleAPI() {
+    if (!checkSession()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    if (server.method() == HTTP_POST) {
+        if (!server.hasArg("enabled")) {
+            server.send(400, "application/json", "{\"error\":\"enabled gerekli\"}");
+            return;
+        }
+        String value = server.arg("enabled");
+        setLogConsoleEnabled(value == "1" || value == "true");
+    }
+    
+    JsonDocument doc;
+    doc["enabled"] = isLogConsoleEnabled();
+    doc["consoleDropped"] = getConsoleDroppedCount();
+    doc["ringDropped"] = getDroppedLogCount();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// Kaynak başına log seviye maskesi - GET liste, POST source=<ad>&mask=<bitler>
+// mask biti (1 << seviye): ERROR 1, WARN 2, INFO 4, DEBUG 8, SUCCESS 16
+void handleLogLevelsAPI() {
+    if (!checkSession()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    if (server.method() == HTTP_POST) {
+        if (!server.hasArg("source") || !server.hasArg("mask")) {
+            server.send(400, "application/json", "{\"error\":\"source ve mask gerekli\"}");
+            return;
+        }
+        String source = server.arg("source");
+        uint8_t mask = (uint8_t)server.arg("mask").toInt();
+        if (!setLogSourceMask(source.c_str(), mask)) {
+            server.send(400, "application/json", "{\"error\":\"Kaynak tablosu dolu\"}");
+            return;
+        }
+        LOG_INFO("SYSTEM", "Log maskesi güncellendi: %s = 0x%02X", source.c_str(), mask & LOG_MASK_ALL);
+    }
+    
+    JsonDocument doc;
+    doc["compileLevel"] = LOG_COMPILE_LEVEL;
+    JsonArray sources = doc["sources"].to<JsonArray>();
+    uint8_t count = getLogSourceCount();
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject item = sources.add<JsonObject>();
+        item["name"] = logSourceName(i);
+        item["mask"] = getLogSourceMask(i);
+    }
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
 // UART Test API Handler
 void handleUARTTestAPI() {
     if (!checkSession()) {
@@ -387,18 +676,33 @@ void setupWebRoutes() {
     server.on("/api/faults/first", HTTP_POST, []() { handleFaultRequest(true); });
     server.on("/api/faults/next", HTTP_POST, []() { handleFaultRequest(false); });
     server.on("/api/faults/refresh", HTTP_POST, []() { handleFaultRequest(false); });
+    server.on("/api/faults/range", HTTP_POST, handleFaultRangeRequest);
+    server.on("/api/faults/job", HTTP_GET, handleFaultJobAPI);
+    server.on("/api/faults/events", HTTP_GET, handleFaultEventStatsAPI);
+    server.on("/api/faults", HTTP_GET, handleStoredFaultsAPI);
+    server.on("/api/faults/store", HTTP_GET, handleFaultStoreStatsAPI);
+    server.on("/api/faults/query", HTTP_GET, handleFaultQueryAPI);
+    server.on("/api/faults/export", HTTP_GET, handleFaultExportAPI);
+    server.on("/api/faults/comtrade", HTTP_GET, handleFaultComtradeAPI);
     server.on("/api/ntp", HTTP_GET, handleGetNtpAPI);
     server.on("/api/ntp", HTTP_POST, handlePostNtpAPI);
     server.on("/api/baudrate", HTTP_GET, handleGetBaudRateAPI);
     server.on("/api/baudrate", HTTP_POST, handlePostBaudRateAPI);
     server.on("/api/logs", HTTP_GET, handleGetLogsAPI);
     server.on("/api/logs/clear", HTTP_POST, handleClearLogsAPI);
+    server.on("/api/logs/console", HTTP_GET, handleLogConsoleAPI);
+    server.on("/api/logs/console", HTTP_POST, handleLogConsoleAPI);
+    server.on("/api/logs/levels", HTTP_GET, handleLogLevelsAPI);
+    server.on("/api/logs/levels", HTTP_POST, handleLogLevelsAPI);
+    server.on("/api/logs/persistent", HTTP_GET, handlePersistentLogAPI);
+    server.on("/api/logs/persistent/stats", HTTP_GET, handlePersistentLogStatsAPI);
     
     // Yeni API endpoints
     server.on("/api/backup/download", HTTP_GET, handleBackupDownload);
     server.on("/api/backup/upload", HTTP_POST, handleBackupUpload);
     server.on("/api/change-password", HTTP_POST, handlePasswordChangeAPI);
     server.on("/api/uart/test", HTTP_POST, handleUARTTestAPI);
+    server.on("/api/uart/stats", HTTP_GET, handleUARTStatsAPI);
     
     // 404
     server.onNotFound([]() {
@@ -409,7 +713,11 @@ void setupWebRoutes() {
     server.enableCORS(false);  // CORS kapat
     server.enableDelay(false); // Delay kapat
     
+    // Dışa aktarımın devam ettirilmesi için (WebServer sadece listelenen başlıkları saklar)
+    const char* headerKeys[] = {"Range", "If-Range"};
+    server.collectHeaders(headerKeys, 2);
+    
     server.begin();
     
-    addLog("✅ Web sunucu başlatıldı", SUCCESS, "WEB");
+    LOG_SUCCESS("WEB", "✅ Web sunucu başlatıldı");
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "log_system.h"
 #include "settings.h"
 #include "auth_system.h"
+#include "uart_protocol.h"
+#include "uart_stats.h"
 #include <WebSocketsServer.h>
 #include <ArduinoJson.h>
 
@@ -23,6 +25,7 @@ struct WSClient {
     IPAddress clientIP;
     unsigned long connectTime;
     String userAgent;
+    bool uartStatsTopic;        // "uart_stats" konusuna abone
 };
 
 WSClient wsClients[MAX_WS_CLIENTS];
@@ -51,16 +54,16 @@ void initWebSocket() {
         wsClients[i].clientIP = IPAddress(0,0,0,0);
         wsClients[i].connectTime = 0;
         wsClients[i].userAgent = "";
+        wsClients[i].uartStatsTopic = false;
     }
     
-    addLog("✅ WebSocket server başlatıldı (Port " + String(WEBSOCKET_PORT) + 
-           ", Max Clients: " + String(MAX_WS_CLIENTS) + ")", SUCCESS, "WS");
+    LOG_SUCCESS("WS", "✅ WebSocket server başlatıldı (Port %d, Max Clients: %d)", WEBSOCKET_PORT, MAX_WS_CLIENTS);
 }
 
 // WebSocket event handler
 void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
     if (!isValidClientIndex(num)) {
-        addLog("❌ WebSocket client ID geçersiz: " + String(num) + "/" + String(MAX_WS_CLIENTS), ERROR, "WS");
+        LOG_ERROR("WS", "❌ WebSocket client ID geçersiz: %u/%d", num, MAX_WS_CLIENTS);
         return;
     }
     
@@ -71,8 +74,9 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
             wsClients[num].clientIP = IPAddress(0,0,0,0);
             wsClients[num].connectTime = 0;
             wsClients[num].userAgent = "";
+            wsClients[num].uartStatsTopic = false;
             
-            addLog("📤 WebSocket client #" + String(num) + " bağlantısı kesildi", INFO, "WS");
+            LOG_INFO("WS", "📤 WebSocket client #%u bağlantısı kesildi", num);
             break;
         }
         
@@ -82,8 +86,9 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
             wsClients[num].lastPing = millis();
             wsClients[num].connectTime = millis();
             wsClients[num].authenticated = false;
+            wsClients[num].uartStatsTopic = false;
             
-            addLog("📥 WebSocket client #" + String(num) + " bağlandı: " + ip.toString(), INFO, "WS");
+            LOG_INFO("WS", "📥 WebSocket client #%u bağlandı: %s", num, ip.toString().c_str());
             
             // İlk bağlantıda authentication isteği gönder - YENİ JSON SYNTAX
             JsonDocument doc;  // StaticJsonDocument yerine JsonDocument
@@ -102,7 +107,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
         
         case WStype_TEXT: {
             if (length > 1024) {
-                addLog("❌ WebSocket mesajı çok büyük: " + String(length) + " bytes", ERROR, "WS");
+                LOG_ERROR("WS", "❌ WebSocket mesajı çok büyük: %u bytes", (unsigned)length);
                 webSocket.sendTXT(num, "{\"type\":\"error\",\"message\":\"Message too large\"}");
                 return;
             }
@@ -118,7 +123,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
             delete[] message;
             
             if (error) {
-                addLog("❌ WebSocket JSON parse hatası: " + String(error.c_str()), ERROR, "WS");
+                LOG_ERROR("WS", "❌ WebSocket JSON parse hatası: %s", error.c_str());
                 JsonDocument errorDoc;  // StaticJsonDocument yerine JsonDocument
                 errorDoc["type"] = "error";
                 errorDoc["message"] = "Invalid JSON format";
@@ -133,7 +138,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
             String cmd = doc["cmd"] | "";
             
             if (cmd.length() > 50) {
-                addLog("❌ WebSocket komut çok uzun: " + String(cmd.length()), ERROR, "WS");
+                LOG_ERROR("WS", "❌ WebSocket komut çok uzun: %u", cmd.length());
                 return;
             }
             
@@ -160,7 +165,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
                     serializeJson(response, output);
                     webSocket.sendTXT(num, output);
                     
-                    addLog("✅ WebSocket client #" + String(num) + " kimlik doğrulaması başarılı", SUCCESS, "WS");
+                    LOG_SUCCESS("WS", "✅ WebSocket client #%u kimlik doğrulaması başarılı", num);
                     
                     delay(500);
                     sendInitialDataToClient(num);
@@ -176,7 +181,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
                     serializeJson(response, output);
                     webSocket.sendTXT(num, output);
                     
-                    addLog("❌ WebSocket client #" + String(num) + " kimlik doğrulaması başarısız", WARN, "WS");
+                    LOG_WARN("WS", "❌ WebSocket client #%u kimlik doğrulaması başarısız", num);
                     
                     delay(2000);
                     webSocket.disconnect(num);
@@ -219,11 +224,36 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
                     serializeJson(response, output);
                     webSocket.sendTXT(num, output);
                 }
+                else if (cmd == "subscribe" || cmd == "unsubscribe") {
+                    String topic = doc["topic"] | "";
+                    bool subscribe = cmd == "subscribe";
+                    
+                    JsonDocument response;
+                    response["type"] = "subscription";
+                    response["topic"] = topic;
+                    
+                    if (topic == "uart_stats") {
+                        wsClients[num].uartStatsTopic = subscribe;
+                        response["subscribed"] = subscribe;
+                    } else {
+                        response["error"] = "Unknown topic";
+                    }
+                    
+                    String output;
+                    serializeJson(response, output);
+                    webSocket.sendTXT(num, output);
+                    
+                    // Abone olan ilk veriyi beklemesin
+                    if (subscribe && wsClients[num].uartStatsTopic) {
+                        String stats = "{\"type\":\"uart_stats\",\"stats\":" + getUARTStatisticsJSON() + "}";
+                        webSocket.sendTXT(num, stats);
+                    }
+                }
                 else {
                     JsonDocument response;  // StaticJsonDocument yerine JsonDocument
                     response["type"] = "error";
                     response["message"] = "Unknown command: " + cmd;
-                    response["availableCommands"] = "ping, get_status, get_logs, get_info";
+                    response["availableCommands"] = "ping, get_status, get_logs, get_info, subscribe, unsubscribe";
                     response["timestamp"] = millis();
                     
                     String output;
@@ -246,14 +276,14 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
         }
         
         case WStype_BIN:
-            addLog("⚠️ WebSocket binary veri alındı (desteklenmiyor) - Client #" + String(num), WARN, "WS");
+            LOG_WARN("WS", "⚠️ WebSocket binary veri alındı (desteklenmiyor) - Client #%u", num);
             break;
             
         case WStype_ERROR:
             if (isValidClientIndex(num)) {
                 wsClients[num].authenticated = false;
             }
-            addLog("❌ WebSocket hatası - Client #" + String(num), ERROR, "WS");
+            LOG_ERROR("WS", "❌ WebSocket hatası - Client #%u", num);
             break;
             
         case WStype_PING:
@@ -269,7 +299,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
             break;
             
         default:
-            addLog("🔍 WebSocket bilinmeyen event türü: " + String(type) + " - Client #" + String(num), DEBUG, "WS");
+            LOG_DEBUG("WS", "🔍 WebSocket bilinmeyen event türü: %d - Client #%u", (int)type, num);
             break;
     }
 }
@@ -280,13 +310,13 @@ void sendInitialDataToClient(uint8_t clientNum) {
         return;
     }
     
-    addLog("📊 Client #" + String(clientNum) + " için initial data gönderiliyor", DEBUG, "WS");
+    LOG_DEBUG("WS", "📊 Client #%d için initial data gönderiliyor", clientNum);
     
     sendStatusToClient(clientNum);
     delay(100);
     sendLogsToClient(clientNum);
     
-    addLog("✅ Client #" + String(clientNum) + " initial data gönderildi", DEBUG, "WS");
+    LOG_DEBUG("WS", "✅ Client #%d initial data gönderildi", clientNum);
 }
 
 // Belirli cliente durum gönder
@@ -308,7 +338,7 @@ void sendStatusToClient(uint8_t clientNum) {
     doc["timeSynced"] = isTimeSynced();
     doc["freeHeap"] = ESP.getFreeHeap();
     doc["wsClients"] = getWebSocketClientCount();
-    doc["totalLogs"] = totalLogs;
+    doc["totalLogs"] = getLogCount();
     doc["sessionActive"] = settings.isLoggedIn;
     doc["timestamp"] = millis();
     
@@ -331,27 +361,35 @@ void sendLogsToClient(uint8_t clientNum) {
         return;
     }
     
-    // Son 15 logu gönder
-    int logCount = min(15, totalLogs);
-    
-    for (int i = 0; i < logCount; i++) {
-        int idx = (logIndex - 1 - i + 50) % 50;
-        if (logs[idx].message.length() > 0) {
-            JsonDocument logDoc;  // StaticJsonDocument yerine JsonDocument
-            logDoc["type"] = "log";
-            logDoc["timestamp"] = logs[idx].timestamp;
-            logDoc["message"] = logs[idx].message;
-            logDoc["level"] = logLevelToString(logs[idx].level);
-            logDoc["source"] = logs[idx].source;
-            logDoc["millis"] = logs[idx].millis_time;
-            logDoc["sequence"] = logCount - i;
-            
-            String output;
-            serializeJson(logDoc, output);
-            webSocket.sendTXT(clientNum, output);
-            
-            delay(20);
-        }
+    // Son 15 logu gönder (eskiden yeniye)
+    uint32_t head = getLogHead();
+    uint32_t first = getLogTail();
+    if (head - first > 15) first = head - 15;
+    int logCount = 0;
+    
+    LogEntry entry;
+    char timestamp[32];
+    char message[LOG_MESSAGE_MAX];
+    for (uint32_t sequence = first; sequence != head; sequence++) {
+        if (!readLogEntry(sequence, entry)) continue;
+        formatLogTimestamp(entry, timestamp, sizeof(timestamp));
+        formatLogMessage(entry, message, sizeof(message));
+        
+        JsonDocument logDoc;  // StaticJsonDocument yerine JsonDocument
+        logDoc["type"] = "log";
+        logDoc["timestamp"] = timestamp;
+        logDoc["message"] = message;
+        logDoc["level"] = logLevelName(entry.level);
+        logDoc["source"] = logSourceName(entry.sourceId);
+        logDoc["millis"] = (uint64_t)entry.timestamp * 1000 + entry.millis;
+        logDoc["sequence"] = entry.sequence;
+        
+        String output;
+        serializeJson(logDoc, output);
+        webSocket.sendTXT(clientNum, output);
+        logCount++;
+        
+        delay(20);
     }
     
     // Log gönderimi tamamlandı sinyali
@@ -380,9 +418,8 @@ void handleWebSocket() {
         for (int i = 0; i < MAX_WS_CLIENTS; i++) {
             if (wsClients[i].authenticated && wsClients[i].lastPing > 0) {
                 if (now - wsClients[i].lastPing > 120000) { // 2 dakika timeout
-                    addLog("⏰ WebSocket client #" + String(i) + " timeout (" + 
-                           wsClients[i].clientIP.toString() + ") - " + 
-                           String((now - wsClients[i].lastPing) / 1000) + "s", WARN, "WS");
+                    LOG_WARN("WS", "⏰ WebSocket client #%d timeout (%s) - %lus",
+                            i, wsClients[i].clientIP.toString().c_str(), (now - wsClients[i].lastPing) / 1000);
                     
                     webSocket.disconnect(i);
                     wsClients[i].authenticated = false;
@@ -393,7 +430,7 @@ void handleWebSocket() {
         }
         
         if (timeoutCount > 0) {
-            addLog("🧹 " + String(timeoutCount) + " WebSocket client timeout ile temizlendi", INFO, "WS");
+            LOG_INFO("WS", "🧹 %d WebSocket client timeout ile temizlendi", timeoutCount);
         }
     }
 }
@@ -467,18 +504,56 @@ void broadcastStatus() {
     }
 }
 
+// "uart_stats" konusu - sadece abone olan client'lara, UART_STATS_BROADCAST_MS aralıkla
+void broadcastUARTStats() {
+    static unsigned long lastStatsBroadcast = 0;
+    if (millis() - lastStatsBroadcast < UART_STATS_BROADCAST_MS) {
+        return;
+    }
+    lastStatsBroadcast = millis();
+    
+    bool anySubscriber = false;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (wsClients[i].authenticated && wsClients[i].uartStatsTopic) {
+            anySubscriber = true;
+            break;
+        }
+    }
+    if (!anySubscriber) {
+        return;
+    }
+    
+    String output = "{\"type\":\"uart_stats\",\"stats\":" + getUARTStatisticsJSON() + "}";
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (wsClients[i].authenticated && wsClients[i].uartStatsTopic) {
+            webSocket.sendTXT(i, output);
+        }
+    }
+}
+
 // Arıza verisi broadcast
-void broadcastFault(const String& faultData) {
-    if (faultData.length() == 0) {
+void broadcastFault(const String& faultData, int eventId, unsigned long latencyMs, const char* recordJson) {
+    // İkili kayıtlarda ham metin yok, sadece çözülmüş kayıt gönderilir
+    if (faultData.length() == 0 && recordJson == NULL) {
         return;
     }
     
     JsonDocument doc;  // StaticJsonDocument yerine JsonDocument
     doc["type"] = "fault";
     doc["timestamp"] = getFormattedTimestamp();
-    doc["data"] = faultData.length() > 200 ? faultData.substring(0, 197) + "..." : faultData;
-    doc["fullLength"] = faultData.length();
+    if (faultData.length() > 0) {
+        doc["data"] = faultData.length() > 200 ? faultData.substring(0, 197) + "..." : faultData;
+        doc["fullLength"] = faultData.length();
+    }
     doc["millis"] = millis();
+    if (eventId >= 0) {
+        doc["event"] = true;
+        doc["eventId"] = eventId;
+        doc["latency"] = latencyMs;
+    }
+    if (recordJson) {
+        doc["record"] = serialized(recordJson);
+    }
     
     String output;
     serializeJson(doc, output);
@@ -492,7 +567,41 @@ void broadcastFault(const String& faultData) {
     }
     
     if (sentCount > 0) {
-        addLog("📡 Arıza verisi " + String(sentCount) + " client'a broadcast edildi", DEBUG, "WS");
+        LOG_DEBUG("WS", "📡 Arıza verisi %d client'a broadcast edildi", sentCount);
+    }
+}
+
+// Asenkron arıza sorgusunun sonucu - isteyen client'a, o yoksa tüm client'lara
+void sendFaultResult(int clientNum, uint32_t jobId, const char* status, const String& faultData,
+                     const char* recordJson) {
+    JsonDocument doc;
+    doc["type"] = "fault";
+    doc["jobId"] = jobId;
+    doc["status"] = status;
+    doc["timestamp"] = getFormattedTimestamp();
+    doc["data"] = faultData;
+    doc["fullLength"] = faultData.length();
+    doc["millis"] = millis();
+    if (recordJson) {
+        doc["record"] = serialized(recordJson);
+    }
+    
+    String output;
+    serializeJson(doc, output);
+    sendJobResult(clientNum, output);
+}
+
+// İş sonucunu isteyen client'a, o bağlantısını kaybetmişse sayfası açık olan herkese gönder
+void sendJobResult(int clientNum, String& message) {
+    if (clientNum >= 0 && isValidClientIndex(clientNum) && wsClients[clientNum].authenticated) {
+        webSocket.sendTXT(clientNum, message);
+        return;
+    }
+    
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (wsClients[i].authenticated) {
+            webSocket.sendTXT(i, message);
+        }
     }
 }
 
@@ -503,7 +612,7 @@ void sendToClient(uint8_t clientNum, const String& message) {
     }
     
     if (message.length() > 1024) {
-        addLog("⚠️ Client #" + String(clientNum) + " için mesaj çok büyük: " + String(message.length()), WARN, "WS");
+        LOG_WARN("WS", "⚠️ Client #%d için mesaj çok büyük: %u", clientNum, message.length());
         return;
     }
     
@@ -515,7 +624,7 @@ void sendToClient(uint8_t clientNum, const String& message) {
 // Tüm clientlara mesaj gönder - STRING REFERENCE SORUNU DÜZELTİLDİ
 void sendToAllClients(const String& message) {
     if (message.length() > 1024) {
-        addLog("⚠️ Broadcast mesajı çok büyük: " + String(message.length()), WARN, "WS");
+        LOG_WARN("WS", "⚠️ Broadcast mesajı çok büyük: %u", message.length());
         return;
     }
     
@@ -531,7 +640,7 @@ void sendToAllClients(const String& message) {
     }
     
     if (sentCount > 0) {
-        addLog("📢 Mesaj " + String(sentCount) + " client'a gönderildi", DEBUG, "WS");
+        LOG_DEBUG("WS", "📢 Mesaj %d client'a gönderildi", sentCount);
     }
 }
 
@@ -620,13 +729,13 @@ void cleanupWebSocketClients() {
     }
     
     if (cleanedCount > 0) {
-        addLog("🧹 " + String(cleanedCount) + " eski WebSocket client temizlendi", INFO, "WS");
+        LOG_INFO("WS", "🧹 %d eski WebSocket client temizlendi", cleanedCount);
     }
 }
 
 // Acil durum - Tüm clientları kes
 void disconnectAllWebSocketClients() {
-    addLog("🚨 Tüm WebSocket clientları kesiliyor", WARN, "WS");
+    LOG_WARN("WS", "🚨 Tüm WebSocket clientları kesiliyor");
     
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
         if (wsClients[i].clientIP != IPAddress(0,0,0,0)) {
@@ -640,5 +749,5 @@ void disconnectAllWebSocketClients() {
         }
     }
     
-    addLog("✅ Tüm WebSocket clientları kesildi", INFO, "WS");
+    LOG_INFO("WS", "✅ Tüm WebSocket clientları kesildi");
 }
\ No newline at end of file
@@ -0,0 +1,519 @@
+#!/usr/bin/env python3
+"""
+TEİAŞ EKLİM - dsPIC33EP UART Simülatörü
+Fiziksel dsPIC olmadan UART protokolünü denemek için bir pty üzerinde
+dsPIC33EP gibi davranır. İki lehçeyi de konuşur:
+
+  * Metin komutları: "12345v", "n", "GETTIME", "getNTP", "setNTP:...", "br115200", "TEST"
+  * Frame protokolü: STX/ETX veya COBS, XOR veya CRC-8, sıra numarası (boru hattı),
+    toplu arıza aktarımı, LZSS sıkıştırma, arıza olayları, hız anlaşması
+
+Kullanım:
+    python tools/dspic_sim.py --faults 500 --latency 5
+    python tools/dspic_sim.py --byte-error 0.0005 --drop-every 50 --link /tmp/dspic
+    python tools/dspic_sim.py --caps 0x01 --no-text      # sadece CRC-8 bilen eski firmware
+    python tools/dspic_sim.py --baud 9600 --link /tmp/dspic  # düşük hızlı saha hattı
+
+Yazdırılan /dev/pts/N yolu tools/uart_bench ile ya da bir USB-seri köprü
+üzerinden ESP32'ye bağlanarak kullanılır.
+"""
+
+import argparse
+import os
+import pty
+import random
+import select
+import sys
+import termios
+import time
+import tty
+
+# ==================== PROTOKOL SABİTLERİ (include/uart_*.h ile aynı) ====================
+
+STX, ETX, ESC = 0x02, 0x03, 0x1B
+MAX_FRAME_SIZE = 512
+
+CMD_GET_TIME = 0x10
+CMD_SET_NTP = 0x11
+CMD_GET_NTP = 0x12
+CMD_GET_FIRST_FAULT = 0x20
+CMD_GET_NEXT_FAULT = 0x21
+CMD_CLEAR_FAULTS = 0x22
+CMD_GET_FAULT_RANGE = 0x23
+CMD_FAULT_RECORD = 0x24
+CMD_FAULT_RANGE_END = 0x25
+CMD_FAULT_EVENT = 0x26
+CMD_SET_BAUDRATE = 0x30
+CMD_SET_LINK_RATE = 0x31
+CMD_COMMIT_LINK_RATE = 0x32
+CMD_PING = 0x40
+CMD_GET_VERSION = 0x41
+CMD_RESET = 0x50
+CMD_GET_STATUS = 0x60
+CMD_LZSS_BLOCK = 0x70
+CMD_ACK = 0xA0
+CMD_NACK = 0xA1
+
+CMD_FLAG_COMPRESS = 0x80
+LZSS_BLOCK_LAST = 0x01
+NACK_REASON_CHECKSUM = 0x01
+NACK_REASON_UNKNOWN = 0x02
+
+CAP_CRC8 = 0x01
+CAP_FAULT_RANGE = 0x02
+CAP_SEQUENCE = 0x04
+CAP_FAULT_EVENT = 0x08
+CAP_LINK_RATE = 0x10
+CAP_COBS = 0x20
+CAP_LZSS = 0x40
+ALL_CAPS = 0x7F
+
+PROTOCOL_VERSION = 3
+
+
+def _crc8_table():
+    table = []
+    for n in range(256):
+        crc = n
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+        table.append(crc)
+    return table
+
+
+CRC8_TABLE = _crc8_table()
+
+
+def checksum(content, crc):
+    """Frame checksum'ı (komut, [sıra], uzunluk, veri)"""
+    value = 0
+    if crc:
+        for b in content:
+            value = CRC8_TABLE[value ^ b]
+    else:
+        for b in content:
+            value ^= b
+    return value
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+            continue
+        out.append(b)
+        code += 1
+        if code == 0xFF:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+    out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0:
+            return None
+        block = data[i + 1:i + code]
+        if len(block) != code - 1:
+            return None
+        out += block
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value, count):
+        for i in range(count - 1, -1, -1):
+            self.acc = (self.acc << 1) | ((value >> i) & 1)
+            self.bits += 1
+            if self.bits == 8:
+                self.out.append(self.acc)
+                self.acc, self.bits = 0, 0
+
+    def finish(self):
+        if self.bits:
+            self.out.append((self.acc << (8 - self.bits)) & 0xFF)
+        return bytes(self.out)
+
+
+def lzss_compress(data, window_bits=8, lookahead_bits=4):
+    """heatshrink uyumlu LZSS (açgözlü arama) - uart_lzss.cpp çözücüsü ile aynı biçim"""
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    writer = BitWriter()
+    i = 0
+    while i < len(data):
+        best_len, best_off = 0, 0
+        for off in range(1, min(window, i) + 1):
+            length = 0
+            while length < max_len and i + length < len(data) and data[i + length] == data[i - off + length]:
+                length += 1
+            if length > best_len:
+                best_len, best_off = length, off
+                if length == max_len:
+                    break
+        if best_len >= 2:
+            writer.put(0, 1)
+            writer.put(best_off - 1, window_bits)
+            writer.put(best_len - 1, lookahead_bits)
+            i += best_len
+        else:
+            writer.put(1, 1)
+            writer.put(data[i], 8)
+            i += 1
+    return writer.finish()
+
+
+# ==================== SİMÜLATÖR ====================
+
+class Link:
+    """Anlaşılan bağlantı durumu - ESP32 tarafındaki UARTLinkProtocol karşılığı"""
+
+    def __init__(self):
+        self.reset()
+
+    def reset(self):
+        self.caps = 0
+        self.crc = False
+        self.sequenced = False
+        self.cobs = False
+        self.window = 1
+
+
+class Simulator:
+    def __init__(self, args):
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.link = Link()
+        self.records = [self._make_record(i) for i in range(args.faults)]
+        self.text_cursor = 0
+        self.frame_cursor = 0
+        self.reply_cache = {}          # sıra -> kodlanmış yanıt (tekrar gelen istekler için)
+        self.responses = 0
+        self.event_id = 0
+        self.next_event = time.monotonic() + args.event_interval if args.event_interval else None
+        self.stats = {"text": 0, "frames": 0, "bad": 0, "dropped": 0, "replayed": 0, "events": 0}
+
+    def _make_record(self, index):
+        """include/fault_record.h metin biçimi: sıra,DDMMYYHHMMSS.mmm,kanal,tip,değerler..."""
+        stamp = "%02d%02d24%02d%02d%02d.%03d" % (1 + index % 28, 1 + index % 12, index % 24, index % 60,
+                                                (index * 7) % 60, index % 1000)
+        values = [200 + self.rng.randint(0, 4000) + self.rng.randint(0, 99) / 100.0 for _ in range(3)]
+        values.append(20 + index % 80)
+        return ("%04d,%s,%d,%d,%s" % ((index + 1) & 0xFFFF, stamp, 1 + index % 8, 1 + index % 6,
+                                     ",".join("%.2f" % v for v in values))).encode()
+
+    # ---------- gönderim ----------
+
+    def _write(self, fd, payload):
+        self.responses += 1
+        if self.args.drop_every and self.responses % self.args.drop_every == 0:
+            self.stats["dropped"] += 1
+            return
+        if self.args.latency or self.args.jitter:
+            time.sleep((self.args.latency + self.rng.uniform(0, self.args.jitter)) / 1000.0)
+        if self.args.byte_error > 0:
+            payload = bytearray(payload)
+            for i in range(len(payload)):
+                if self.rng.random() < self.args.byte_error:
+                    payload[i] ^= 1 << self.rng.randint(0, 7)
+        if self.args.baud:
+            # Hat hızı: 8N1'de byte başına 10 bit; byte'lar hattan çıktıkça 64'lük parçalarla verilir
+            for start in range(0, len(payload), 64):
+                chunk = bytes(payload[start:start + 64])
+                time.sleep(len(chunk) * 10.0 / self.args.baud)
+                os.write(fd, chunk)
+            return
+        os.write(fd, bytes(payload))
+
+    def encode(self, command, data=b"", sequence=None, legacy=False):
+        """Yanıt frame'i - legacy: el sıkışma yanıtı (XOR, STX/ETX, sırasız)"""
+        header = bytearray([command])
+        if sequence is not None and not legacy and self.link.sequenced:
+            header.append(sequence)
+        header += bytes([(len(data) >> 8) & 0xFF, len(data) & 0xFF])
+        content = bytes(header) + bytes(data)
+        content += bytes([checksum(content, self.link.crc and not legacy)])
+
+        if self.link.cobs and not legacy:
+            return b"\x00" + cobs_encode(content) + b"\x00"
+
+        out = bytearray([STX])
+        for b in content:
+            if b in (STX, ETX, ESC):
+                out.append(ESC)
+            out.append(b)
+        out.append(ETX)
+        return bytes(out)
+
+    # ---------- metin lehçesi ----------
+
+    def handle_text(self, fd, line):
+        self.stats["text"] += 1
+        command = line.decode(errors="replace").strip()
+        if command == "12345v":
+            self.text_cursor = 0
+            reply = self.records[0] if self.records else b"END"
+        elif command == "n":
+            self.text_cursor += 1
+            reply = self.records[self.text_cursor] if self.text_cursor < len(self.records) else b"END"
+        elif command in ("GETTIME", "TIME", "DT", "DATETIME"):
+            reply = time.strftime("%d%m%y%H%M%S").encode()
+        elif command == "getNTP":
+            reply = b"NTP:pool.ntp.org,time.google.com"
+        elif command.startswith("setNTP:") or command.startswith("br"):
+            reply = b"ACK"
+        elif command == "TEST":
+            reply = b"OK"
+        else:
+            reply = b"ERR"
+        self._write(fd, reply + b"\r\n")
+
+    # ---------- frame lehçesi ----------
+
+    def parse(self, content, crc, sequenced):
+        header = 4 if sequenced else 3
+        if len(content) < header + 1:
+            return None
+        length = (content[header - 2] << 8) | content[header - 1]
+        if len(content) != header + length + 1 or checksum(content[:-1], crc) != content[-1]:
+            return None
+        return content[0], (content[1] if sequenced else None), content[header:header + length]
+
+    def handle_content(self, fd, content):
+        frame = self.parse(content, self.link.crc, self.link.sequenced)
+        if frame is None:
+            # ESP32 resetlenmiş olabilir - el sıkışma her modda kabul edilir
+            legacy = self.parse(content, False, False)
+            if legacy is not None and legacy[0] == CMD_GET_VERSION:
+                self.negotiate(fd, legacy[2])
+                return
+            self.stats["bad"] += 1
+            if self.link.sequenced and len(content) > 1:
+                self._write(fd, self.encode(CMD_NACK, bytes([NACK_REASON_CHECKSUM]), content[1]))
+            return
+
+        command, sequence, data = frame
+        self.stats["frames"] += 1
+        if command == CMD_GET_VERSION:
+            self.negotiate(fd, data)
+            return
+
+        # Tekrar gelen sıra numarası: komutu yeniden çalıştırma, yanıtı tekrarla
+        if sequence is not None and sequence in self.reply_cache:
+            cached_command, reply = self.reply_cache[sequence]
+            if cached_command == command:
+                self.stats["replayed"] += 1
+                self._write(fd, reply)
+                return
+
+        reply = self.execute(command, sequence, data)
+        if sequence is not None:
+            self.reply_cache[sequence] = (command, reply)
+            self.reply_cache.pop((sequence - 32) & 0xFF, None)
+        self._write(fd, reply)
+
+    def negotiate(self, fd, offer):
+        self.link.reset()
+        self.reply_cache.clear()
+        caps = self.args.caps & (offer[1] if len(offer) > 1 else 0)
+        window = min(offer[2], self.args.window) if len(offer) > 2 else 1
+        self._write(fd, self.encode(CMD_GET_VERSION, bytes([PROTOCOL_VERSION, self.args.caps, self.args.window]),
+                                    legacy=True))
+        # Yanıt gönderildikten sonra anlaşılan moda geç
+        self.link.caps = caps
+        self.link.crc = bool(caps & CAP_CRC8)
+        self.link.sequenced = bool(caps & CAP_SEQUENCE)
+        self.link.cobs = bool(caps & CAP_COBS)
+        self.link.window = max(1, window)
+        print("🤝 El sıkışma: yetenekler=0x%02X pencere=%d" % (caps, self.link.window))
+
+    def compressed(self, inner, sequence, plain_size):
+        """İç kayıtları LZSS bloklarına böl - hatta düz frame'lerden (plain_size byte) kısa değilse None"""
+        packed = lzss_compress(inner)
+        chunk = MAX_FRAME_SIZE - 1
+        frames = bytearray()
+        for start in range(0, len(packed), chunk):
+            last = start + chunk >= len(packed)
+            block = bytes([LZSS_BLOCK_LAST if last else 0]) + packed[start:start + chunk]
+            frames += self.encode(CMD_LZSS_BLOCK, block, sequence)
+        return bytes(frames) if len(frames) < plain_size else None
+
+    def single(self, command, data, sequence, compress):
+        plain = self.encode(command, data, sequence)
+        if compress:
+            inner = bytes([command, len(data) >> 8, len(data) & 0xFF]) + data
+            packed = self.compressed(inner, sequence, len(plain))
+            if packed is not None:
+                return packed
+        return plain
+
+    def execute(self, wire_command, sequence, data):
+        command = wire_command & ~CMD_FLAG_COMPRESS
+        compress = bool(wire_command & CMD_FLAG_COMPRESS) and bool(self.link.caps & CAP_LZSS)
+
+        if command == CMD_PING:
+            return self.encode(CMD_PING, b"PONG", sequence)
+        if command == CMD_GET_TIME:
+            return self.encode(CMD_GET_TIME, time.strftime("%d%m%y%H%M%S").encode(), sequence)
+        if command == CMD_GET_NTP:
+            return self.encode(CMD_GET_NTP, b"pool.ntp.org,time.google.com", sequence)
+        if command in (CMD_GET_FIRST_FAULT, CMD_GET_NEXT_FAULT):
+            self.frame_cursor = 0 if command == CMD_GET_FIRST_FAULT else self.frame_cursor + 1
+            if self.frame_cursor >= len(self.records):
+                return self.encode(CMD_NACK, bytes([0x03]), sequence)
+            return self.single(command, self.records[self.frame_cursor], sequence, compress)
+        if command == CMD_GET_FAULT_RANGE and len(data) >= 4:
+            return self.fault_range(data, sequence, compress)
+        if command == CMD_GET_STATUS:
+            return self.encode(CMD_GET_STATUS, b"OK", sequence)
+        if command in (CMD_SET_NTP, CMD_SET_BAUDRATE, CMD_CLEAR_FAULTS, CMD_RESET,
+                       CMD_SET_LINK_RATE, CMD_COMMIT_LINK_RATE):
+            # pty'de hız yok - hız anlaşması her zaman başarılı görünür
+            return self.encode(CMD_ACK, b"ACK", sequence)
+        return self.encode(CMD_NACK, bytes([NACK_REASON_UNKNOWN]), sequence)
+
+    def fault_range(self, data, sequence, compress):
+        start = (data[0] << 8) | data[1]
+        count = (data[2] << 8) | data[3]
+        selected = self.records[start:start + count]
+
+        inner = bytearray()
+        plain = bytearray()
+        for offset, record in enumerate(selected):
+            index = start + offset
+            payload = bytes([index >> 8, index & 0xFF]) + record
+            inner += bytes([CMD_FAULT_RECORD, len(payload) >> 8, len(payload) & 0xFF]) + payload
+            plain += self.encode(CMD_FAULT_RECORD, payload, sequence)
+
+        end = self.encode(CMD_FAULT_RANGE_END, bytes([len(selected) >> 8, len(selected) & 0xFF,
+                                                      len(self.records) >> 8, len(self.records) & 0xFF]), sequence)
+        packed = self.compressed(bytes(inner), sequence, len(plain)) if compress and inner else None
+        return (packed if packed is not None else bytes(plain)) + end
+
+    def maybe_event(self, fd):
+        if self.next_event is None or time.monotonic() < self.next_event:
+            return
+        self.next_event = time.monotonic() + self.args.event_interval
+        if not self.link.caps & CAP_FAULT_EVENT:
+            return
+        record = self._make_record(len(self.records))
+        self.records.append(record)
+        self.event_id = (self.event_id + 1) & 0xFFFF
+        age = self.rng.randint(1, 20)
+        payload = bytes([self.event_id >> 8, self.event_id & 0xFF, age >> 8, age & 0xFF]) + record
+        self.stats["events"] += 1
+        self._write(fd, self.encode(CMD_FAULT_EVENT, payload, 0))
+
+
+def run(args):
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+    attrs = termios.tcgetattr(slave)
+    attrs[3] &= ~termios.ECHO
+    termios.tcsetattr(slave, termios.TCSANOW, attrs)
+
+    slave_path = os.ttyname(slave)
+    if args.link:
+        if os.path.islink(args.link):
+            os.unlink(args.link)
+        os.symlink(slave_path, args.link)
+
+    sim = Simulator(args)
+    print("🔌 dsPIC simülatörü hazır: %s%s" % (slave_path, (" -> " + args.link) if args.link else ""))
+    print("   Kayıt: %d, gecikme: %dms (+%dms), byte hatası: %g, düşürme: %s, hat: %s" % (
+        args.faults, args.latency, args.jitter, args.byte_error, args.drop_every or "yok",
+        "%d baud" % args.baud if args.baud else "pty"))
+    sys.stdout.flush()
+
+    mode, buffer, escaped = "idle", bytearray(), False
+    try:
+        while True:
+            ready, _, _ = select.select([master], [], [], 0.05)
+            sim.maybe_event(master)
+            if not ready:
+                continue
+            try:
+                chunk = os.read(master, 4096)
+            except OSError:
+                time.sleep(0.05)   # Karşı taraf pty'yi henüz açmadı
+                continue
+
+            for b in chunk:
+                if mode == "stx":
+                    if escaped:
+                        buffer.append(b)
+                        escaped = False
+                    elif b == ESC:
+                        escaped = True
+                    elif b == STX:
+                        buffer = bytearray()
+                    elif b == ETX:
+                        sim.handle_content(master, bytes(buffer))
+                        mode, buffer = "idle", bytearray()
+                    else:
+                        buffer.append(b)
+                elif mode == "cobs":
+                    if b == 0:
+                        if buffer:
+                            content = cobs_decode(bytes(buffer))
+                            if content is not None:
+                                sim.handle_content(master, content)
+                            else:
+                                sim.stats["bad"] += 1
+                            mode = "idle"
+                        buffer = bytearray()
+                    else:
+                        buffer.append(b)
+                elif b == STX:
+                    mode, buffer, escaped = "stx", bytearray(), False
+                elif b == 0:
+                    mode, buffer = "cobs", bytearray()
+                elif b in (0x0A, 0x0D):
+                    if buffer and not args.no_text:
+                        sim.handle_text(master, bytes(buffer))
+                    buffer = bytearray()
+                elif 32 <= b <= 126:
+                    buffer.append(b)
+    except KeyboardInterrupt:
+        print("\n📊 %s" % ", ".join("%s=%d" % item for item in sim.stats.items()))
+    finally:
+        if args.link and os.path.islink(args.link):
+            os.unlink(args.link)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="dsPIC33EP UART simülatörü (pty)")
+    parser.add_argument("--faults", type=int, default=200, help="arıza kaydı sayısı")
+    parser.add_argument("--latency", type=int, default=2, help="yanıt gecikmesi (ms)")
+    parser.add_argument("--jitter", type=int, default=0, help="ek rastgele gecikme üst sınırı (ms)")
+    parser.add_argument("--byte-error", type=float, default=0.0, help="gönderilen byte başına bit hatası olasılığı")
+    parser.add_argument("--drop-every", type=int, default=0, help="her N. yanıtı gönderme (0: kapalı)")
+    parser.add_argument("--baud", type=int, default=0, help="yanıtları bu hat hızında gönder (0: pty hızı)")
+    parser.add_argument("--caps", type=lambda v: int(v, 0), default=ALL_CAPS, help="desteklenen yetenek bitleri")
+    parser.add_argument("--window", type=int, default=4, help="dsPIC'in kabul ettiği boru hattı penceresi")
+    parser.add_argument("--event-interval", type=float, default=0.0, help="arıza olayı aralığı (s, 0: kapalı)")
+    parser.add_argument("--no-text", action="store_true", help="metin komutlarını yanıtlama")
+    parser.add_argument("--link", help="pty için sabit sembolik bağlantı yolu")
+    parser.add_argument("--seed", type=int, default=1)
+    run(parser.parse_args())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,125 @@
+// fault_record_test.cpp - src/fault_record.cpp için host testi
+//
+// Ayrıştırıcıyı masaüstünde derler; hatalı girişlerin reddedildiğini, sınır değerlerin
+// ve ms alanının doğru ölçeklendiğini, serileştirme turunun kayıpsız olduğunu kontrol eder.
+//
+// Derleme ve çalıştırma (hata olursa çıkış kodu 1):
+//   g++ -std=gnu++11 -O1 -g -Wall -Wextra -fsanitize=address,undefined -fno-sanitize-recover=all
+//       -Iinclude tools/fault_record_test.cpp src/fault_record.cpp -o fault_record_test
+//   ./fault_record_test
+#include <stdio.h>
+#include <string.h>
+#include "fault_record.h"
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    } \
+} while (0)
+
+static bool parseLine(const char* text, FaultRecord& record) {
+    return parseFaultRecordText(text, strlen(text), record);
+}
+
+static void testValues() {
+    FaultRecord record;
+
+    CHECK(parseLine("1,010124120000,2,3,-12.5,7,0.05,+3.1", record));
+    CHECK(record.valueCount == 4);
+    CHECK(record.values[0] == -1250);
+    CHECK(record.values[1] == 700);
+    CHECK(record.values[2] == 5);
+    CHECK(record.values[3] == 310);
+
+    // Üçüncü ve sonraki ondalık haneler kesilir
+    CHECK(parseLine("1,010124120000,2,3,1.239", record));
+    CHECK(record.values[0] == 123);
+
+    // INT32 sınırı: kesirli kısım dahil
+    CHECK(parseLine("1,010124120000,2,3,21474836.47,-21474836.47", record));
+    CHECK(record.values[0] == 2147483647);
+    CHECK(record.values[1] == -2147483647);
+    CHECK(!parseLine("1,010124120000,2,3,21474836.48", record));
+    CHECK(!parseLine("1,010124120000,2,3,21474836.99", record));
+    CHECK(!parseLine("1,010124120000,2,3,21474837", record));
+    CHECK(!parseLine("1,010124120000,2,3,99999999999999999999", record));
+
+    CHECK(!parseLine("1,010124120000,2,3,1.2.3", record));
+    CHECK(!parseLine("1,010124120000,2,3,.", record));
+    CHECK(!parseLine("1,010124120000,2,3,-", record));
+}
+
+static void testMillis() {
+    FaultRecord record;
+
+    CHECK(parseLine("1,010124120000,2,3", record));
+    CHECK(!(record.flags & FAULT_RECORD_HAS_MILLIS));
+
+    CHECK(parseLine("1,010124120000.5,2,3", record));
+    CHECK(record.millis == 500);
+    CHECK(record.flags & FAULT_RECORD_HAS_MILLIS);
+    CHECK(parseLine("1,010124120000.05,2,3", record));
+    CHECK(record.millis == 50);
+    CHECK(parseLine("1,010124120000.005,2,3", record));
+    CHECK(record.millis == 5);
+    CHECK(parseLine("1,010124120000.999,2,3", record));
+    CHECK(record.millis == 999);
+
+    CHECK(!parseLine("1,010124120000.,2,3", record));
+    CHECK(!parseLine("1,010124120000.1234,2,3", record));
+    CHECK(!parseLine("1,010124120000x5,2,3", record));
+}
+
+static void testTimestamp() {
+    FaultRecord record;
+
+    CHECK(parseLine("7,311299235959,1,1", record));
+    char digits[13];
+    faultTimestampToDigits(record.timestamp, digits);
+    CHECK(strcmp(digits, "311299235959") == 0);
+
+    CHECK(!parseLine("7,320124120000,1,1", record));
+    CHECK(!parseLine("7,010124250000,1,1", record));
+    CHECK(!parseLine("7,0101241200,1,1", record));
+}
+
+static void testBinaryRoundTrip() {
+    FaultRecord record;
+    CHECK(parseLine("65535,150624083015.250,9,200,-21474836.47,0,1.5", record));
+
+    uint8_t binary[FAULT_RECORD_BINARY_HEADER + 4 * FAULT_RECORD_MAX_VALUES];
+    size_t length = faultRecordToBinary(record, binary, sizeof(binary));
+    CHECK(length == FAULT_RECORD_BINARY_HEADER + 4 * 3);
+
+    FaultRecord decoded;
+    CHECK(parseFaultRecord(binary, length, decoded));
+    CHECK(decoded.sequence == 65535);
+    CHECK(decoded.timestamp == record.timestamp);
+    CHECK(decoded.millis == 250);
+    CHECK(decoded.channel == 9);
+    CHECK(decoded.typeCode == 200);
+    CHECK(decoded.valueCount == 3);
+    CHECK(memcmp(decoded.values, record.values, 3 * sizeof(int32_t)) == 0);
+
+    // Kesik ikili kayıt reddedilir
+    for (size_t cut = 0; cut < length; cut++) {
+        CHECK(!parseFaultRecordBinary(binary, cut, decoded));
+    }
+}
+
+int main() {
+    testValues();
+    testMillis();
+    testTimestamp();
+    testBinaryRoundTrip();
+
+    if (failures) {
+        printf("%d kontrol başarısız\n", failures);
+        return 1;
+    }
+    printf("fault_record: tüm kontroller geçti\n");
+    return 0;
+}
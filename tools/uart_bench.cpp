@@ -0,0 +1,1098 @@
+// uart_bench.cpp - dsPIC UART protokolü için host ölçüm aracı
+//
+// Firmware ile aynı frame ve LZSS modüllerini (src/uart_frame.cpp, src/uart_lzss.cpp)
+// masaüstünde derler; bir seri porta ya da tools/dspic_sim.py pty'sine bağlanır.
+// Owner task'ın kayan pencere/yeniden gönderim mantığı burada sade haliyle tekrarlanır
+// (arbiter FreeRTOS'a bağlı olduğundan host'ta derlenmez).
+//
+// Derleme:
+//   g++ -std=gnu++11 -O2 -Iinclude tools/uart_bench.cpp src/uart_frame.cpp src/uart_lzss.cpp
+//       src/fault_record.cpp -o uart_bench
+//
+// Kullanım:
+//   python3 tools/dspic_sim.py --latency 2 --byte-error 0.0005 --link /tmp/dspic &
+//   ./uart_bench /tmp/dspic --mode ping --count 2000 --window 4
+//   ./uart_bench /tmp/dspic --mode fault --count 500 --caps 0x05
+//   ./uart_bench /tmp/dspic --mode range --count 20 --range 100
+//   (kayıt/s hat hızına bağlıdır: simülatörü --baud 9600 / 115200 ile başlatın)
+//   ./uart_bench /tmp/dspic --mode text --count 200
+//
+// Çevrimdışı ölçümler port gerektirmez. Kayıt kümesi --input ile verilen dosyadan
+// (satır başına bir arıza kaydı metni, örn. "n" komutu yakalaması) okunur, verilmezse
+// dspic_sim.py ile aynı biçimde --count kayıt üretilir:
+//   ./uart_bench --mode decode --input kayitlar.txt
+//   ./uart_bench --mode encode
+//   ./uart_bench --mode crc
+//   ./uart_bench --mode cobs --input kayitlar.txt
+//   ./uart_bench --mode lzss --input kayitlar.txt
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+#include "fault_record.h"
+#include "uart_frame.h"
+#include "uart_lzss.h"
+
+// include/uart_protocol.h ile aynı değerler (o başlık Arduino'ya bağlı)
+#define PROTOCOL_VERSION        3
+#define CAP_CRC8                0x01
+#define CAP_SEQUENCE            0x04
+#define CAP_COBS                0x20
+#define CAP_LZSS                0x40
+#define NACK_REASON_CHECKSUM    0x01
+
+#define BENCH_MAX_WINDOW        16
+#define BENCH_MAX_ATTEMPTS      6
+#define BENCH_MIN_RUN_MS        200     // Çevrimdışı ölçümde her satır için en az süre
+#define LINE_BYTES_PER_S        11520.0 // 115200 baud, 8N1
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+struct Options {
+    const char* port;
+    std::string mode;
+    int count;
+    int window;
+    int timeoutMs;
+    int rangeCount;
+    int caps;
+    const char* input;              // Çevrimdışı ölçüm kayıt dosyası
+};
+
+struct Slot {
+    bool busy;
+    uint8_t sequence;
+    uint8_t command;
+    int attempts;
+    bool failing;                   // En az bir deneme başarısız oldu
+    Clock::time_point started;      // İlk gönderim
+    Clock::time_point sent;         // Son gönderim
+    Clock::time_point failedAt;     // İlk hata tespiti
+};
+
+struct Results {
+    std::vector<double> latencies;
+    std::vector<double> recoveries; // Hata tespitinden başarılı yanıta kadar geçen süre
+    unsigned long completed;
+    unsigned long failed;
+    unsigned long retransmits;
+    unsigned long timeouts;
+    unsigned long nacks;
+    unsigned long stale;
+    unsigned long records;
+};
+
+static int portFd = -1;
+static FrameDecoder decoder;
+static CompressedFrameReader lzssReader;
+static FrameChecksumMode checksumMode = CHECKSUM_XOR;
+static FrameEncoding framing = FRAMING_STX_ETX;
+static bool sequenced = false;
+static int window = 1;
+static uint8_t peerCaps = 0;
+static uint8_t nextSequence = 0;
+static uint32_t wireBytes = 0;
+
+static Slot slots[BENCH_MAX_WINDOW];
+static Results results;
+static std::vector<UARTFrame> inbox;  // Çözücünün teslim ettiği frame'ler
+
+static bool collectFrame(const UARTFrame& frame, void* /* context */) {
+    inbox.push_back(frame);
+    return true;
+}
+
+static bool openPort(const char* path) {
+    portFd = open(path, O_RDWR | O_NOCTTY);
+    if (portFd < 0) {
+        perror(path);
+        return false;
+    }
+
+    struct termios tio;
+    if (tcgetattr(portFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tcsetattr(portFd, TCSANOW, &tio);
+    }
+    tcflush(portFd, TCIOFLUSH);
+    return true;
+}
+
+static void writeAll(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(portFd, data, length);
+        if (written <= 0) {
+            perror("write");
+            exit(1);
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+static void sendFrame(uint8_t command, const uint8_t* data, uint16_t length, int sequence) {
+    static uint8_t encoded[MAX_ENCODED_FRAME_SIZE];
+    size_t size = (framing == FRAMING_COBS)
+        ? encodeCOBSFrame(command, data, length, encoded, sizeof(encoded), checksumMode, sequence)
+        : encodeFrame(command, data, length, encoded, sizeof(encoded), checksumMode, sequence);
+    writeAll(encoded, size);
+}
+
+// En fazla waitMs bekler, gelen byte'ları çözücüye verir
+static void pump(int waitMs) {
+    struct pollfd pfd = { portFd, POLLIN, 0 };
+    if (poll(&pfd, 1, waitMs) <= 0) {
+        return;
+    }
+
+    uint8_t buffer[1024];
+    ssize_t received = read(portFd, buffer, sizeof(buffer));
+    if (received > 0) {
+        wireBytes += received;
+        decoder.push(buffer, received);
+    }
+}
+
+static bool negotiate(const Options& options) {
+    uint8_t offer[3] = { PROTOCOL_VERSION, (uint8_t)options.caps, (uint8_t)options.window };
+    sendFrame(CMD_GET_VERSION, offer, sizeof(offer), FRAME_NO_SEQUENCE);
+
+    Clock::time_point start = Clock::now();
+    while (elapsedMs(start, Clock::now()) < 1000) {
+        pump(50);
+        for (size_t i = 0; i < inbox.size(); i++) {
+            const UARTFrame& frame = inbox[i];
+            if (frame.command != CMD_GET_VERSION || frame.dataLength < 2) {
+                continue;
+            }
+            peerCaps = frame.data[1] & options.caps;
+            window = (frame.dataLength >= 3) ? std::min<int>(frame.data[2], options.window) : 1;
+            if (window < 1 || !(peerCaps & CAP_SEQUENCE)) window = 1;
+
+            checksumMode = (peerCaps & CAP_CRC8) ? CHECKSUM_CRC8 : CHECKSUM_XOR;
+            framing = (peerCaps & CAP_COBS) ? FRAMING_COBS : FRAMING_STX_ETX;
+            sequenced = (peerCaps & CAP_SEQUENCE) != 0;
+            decoder.setChecksumMode(checksumMode);
+            decoder.setFraming(framing);
+            decoder.setSequenced(sequenced);
+            inbox.clear();
+
+            printf("Protokol v%u, yetenekler 0x%02X, pencere %d, %s/%s\n", frame.data[0], peerCaps, window,
+                   framing == FRAMING_COBS ? "COBS" : "STX-ETX", checksumMode == CHECKSUM_CRC8 ? "CRC-8" : "XOR");
+            return true;
+        }
+        inbox.clear();
+    }
+
+    printf("El sıkışma yanıtı yok - dsPIC protokol v1 kabul edildi\n");
+    return false;
+}
+
+// ==================== PIPELINED FRAME MODU ====================
+
+// Tek kayıtlık yanıtlar firmware'de olduğu gibi sıkıştırma istemez (--mode lzss: kazanç yok)
+static void transmitSlot(Slot& slot) {
+    slot.sent = Clock::now();
+    slot.attempts++;
+    sendFrame(slot.command, NULL, 0, sequenced ? slot.sequence : FRAME_NO_SEQUENCE);
+}
+
+static void markFailure(Slot& slot) {
+    if (!slot.failing) {
+        slot.failing = true;
+        slot.failedAt = Clock::now();
+    }
+    if (slot.attempts >= BENCH_MAX_ATTEMPTS) {
+        results.failed++;
+        slot.busy = false;
+        return;
+    }
+    results.retransmits++;
+    transmitSlot(slot);
+}
+
+static void completeSlot(Slot& slot) {
+    Clock::time_point now = Clock::now();
+    results.latencies.push_back(elapsedMs(slot.started, now));
+    if (slot.failing) {
+        results.recoveries.push_back(elapsedMs(slot.failedAt, now));
+    }
+    results.completed++;
+    slot.busy = false;
+}
+
+static Slot* findSlot(const UARTFrame& frame) {
+    for (int i = 0; i < window; i++) {
+        if (slots[i].busy && (!sequenced || slots[i].sequence == frame.sequence)) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void handleWindowFrame(const UARTFrame& frame) {
+    if (frame.command == CMD_FAULT_EVENT) {
+        return;                         // İstek dışı olay - ölçüme dahil değil
+    }
+
+    Slot* slot = findSlot(frame);
+    if (slot == NULL) {
+        results.stale++;
+        return;
+    }
+
+    if (frame.command == CMD_NACK) {
+        results.nacks++;
+        if (frame.dataLength >= 1 && frame.data[0] == NACK_REASON_CHECKSUM) {
+            markFailure(*slot);
+        } else {
+            results.failed++;           // Kayıt sonu vb. - hat hatası değil
+            slot->busy = false;
+        }
+        return;
+    }
+
+    completeSlot(*slot);
+}
+
+static void runPipelined(const Options& options, uint8_t command) {
+    int issued = 0;
+    while (issued < options.count || std::any_of(slots, slots + window, [](const Slot& s) { return s.busy; })) {
+        for (int i = 0; i < window && issued < options.count; i++) {
+            Slot& slot = slots[i];
+            if (slot.busy) continue;
+            slot.busy = true;
+            slot.sequence = nextSequence++;
+            slot.command = (command == CMD_GET_FIRST_FAULT && issued > 0) ? (uint8_t)CMD_GET_NEXT_FAULT : command;
+            slot.attempts = 0;
+            slot.failing = false;
+            slot.started = Clock::now();
+            transmitSlot(slot);
+            issued++;
+        }
+
+        pump(5);
+        for (size_t i = 0; i < inbox.size(); i++) {
+            handleWindowFrame(inbox[i]);
+        }
+        inbox.clear();
+
+        Clock::time_point now = Clock::now();
+        for (int i = 0; i < window; i++) {
+            if (slots[i].busy && elapsedMs(slots[i].sent, now) > options.timeoutMs) {
+                results.timeouts++;
+                markFailure(slots[i]);
+            }
+        }
+    }
+}
+
+// ==================== TOPLU AKTARIM MODU ====================
+
+static bool countRangeRecord(const UARTFrame& frame, void* /* context */) {
+    if (frame.command == CMD_FAULT_RECORD) {
+        results.records++;
+    }
+    return true;
+}
+
+static void runRange(const Options& options) {
+    uint8_t request[4] = { 0, 0, (uint8_t)(options.rangeCount >> 8), (uint8_t)(options.rangeCount & 0xFF) };
+    uint8_t wire = CMD_GET_FAULT_RANGE | ((peerCaps & CAP_LZSS) ? CMD_FLAG_COMPRESS : 0);
+
+    for (int run = 0; run < options.count; run++) {
+        uint8_t sequence = nextSequence++;
+        Clock::time_point start = Clock::now();
+        Clock::time_point lastFrame = start;
+        bool done = false;
+        bool failing = false;
+        lzssReader.begin(countRangeRecord, NULL);
+        sendFrame(wire, request, sizeof(request), sequenced ? sequence : FRAME_NO_SEQUENCE);
+
+        while (!done) {
+            pump(5);
+            for (size_t i = 0; i < inbox.size() && !done; i++) {
+                const UARTFrame& frame = inbox[i];
+                if (sequenced && frame.sequence != sequence) continue;
+                lastFrame = Clock::now();
+                if (frame.command == CMD_FAULT_RECORD) {
+                    results.records++;
+                } else if (frame.command == CMD_LZSS_BLOCK) {
+                    lzssReader.pushBlock(frame.data, frame.dataLength);
+                    failing = failing || lzssReader.failed();
+                } else if (frame.command == CMD_FAULT_RANGE_END || frame.command == CMD_NACK) {
+                    done = true;
+                }
+            }
+            inbox.clear();
+
+            if (!done && elapsedMs(lastFrame, Clock::now()) > options.timeoutMs) {
+                results.timeouts++;
+                failing = true;
+                break;
+            }
+        }
+
+        if (failing) {
+            results.failed++;
+        } else {
+            results.completed++;
+            results.latencies.push_back(elapsedMs(start, Clock::now()));
+        }
+    }
+}
+
+// ==================== METİN MODU ====================
+
+static bool readLine(std::string& line, int timeoutMs) {
+    line.clear();
+    Clock::time_point start = Clock::now();
+    while (elapsedMs(start, Clock::now()) < timeoutMs) {
+        struct pollfd pfd = { portFd, POLLIN, 0 };
+        if (poll(&pfd, 1, 5) <= 0) continue;
+
+        char c;
+        while (read(portFd, &c, 1) == 1) {
+            wireBytes++;
+            if (c == '\n') {
+                if (!line.empty()) return true;
+            } else if (c != '\r') {
+                line += c;
+            }
+            if (poll(&pfd, 1, 0) <= 0) break;
+        }
+    }
+    return false;
+}
+
+static void runText(const Options& options) {
+    std::string line;
+    for (int i = 0; i < options.count; i++) {
+        const char* command = (i == 0) ? "12345v\r\n" : "n\r\n";
+        Clock::time_point start = Clock::now();
+        bool failing = false;
+        Clock::time_point failedAt;
+
+        for (int attempt = 0; attempt < BENCH_MAX_ATTEMPTS; attempt++) {
+            writeAll((const uint8_t*)command, strlen(command));
+            if (readLine(line, options.timeoutMs)) {
+                Clock::time_point now = Clock::now();
+                results.latencies.push_back(elapsedMs(start, now));
+                if (failing) results.recoveries.push_back(elapsedMs(failedAt, now));
+                results.completed++;
+                break;
+            }
+            results.timeouts++;
+            if (!failing) {
+                failing = true;
+                failedAt = Clock::now();
+            }
+            if (attempt + 1 == BENCH_MAX_ATTEMPTS) {
+                results.failed++;
+            } else {
+                results.retransmits++;
+            }
+        }
+    }
+}
+
+// ==================== ÇEVRİMDIŞI ÖLÇÜMLER ====================
+
+typedef std::vector<std::vector<uint8_t> > PayloadSet;
+
+static std::vector<std::string> corpus;     // Arıza kaydı metinleri
+static volatile uint32_t benchSink;         // Ölçülen işin derleyici tarafından atılmasını önler
+static unsigned long decodedFrames;
+
+static bool loadCorpus(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    char line[MAX_FRAME_SIZE];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        if (length > 0 && length <= MAX_FRAME_SIZE - 2) {
+            corpus.push_back(std::string(line, length));
+        }
+    }
+    fclose(file);
+    return !corpus.empty();
+}
+
+// tools/dspic_sim.py _make_record() ile aynı biçim: sıra,DDMMYYHHMMSS.mmm,kanal,tip,3 analog,sıcaklık
+static void generateCorpus(int count) {
+    uint32_t seed = 1;
+    for (int i = 0; i < count; i++) {
+        char line[128];
+        int length = snprintf(line, sizeof(line), "%04d,%02d%02d24%02d%02d%02d.%03d,%d,%d",
+                              (i + 1) & 0xFFFF, 1 + i % 28, 1 + i % 12, i % 24, i % 60, (i * 7) % 60,
+                              i % 1000, 1 + i % 8, 1 + i % 6);
+        for (int v = 0; v < 3; v++) {
+            seed = seed * 1103515245U + 12345U;
+            unsigned whole = 200 + (seed >> 8) % 4001;
+            seed = seed * 1103515245U + 12345U;
+            length += snprintf(line + length, sizeof(line) - length, ",%u.%02u", whole, (seed >> 8) % 100);
+        }
+        snprintf(line + length, sizeof(line) - length, ",%d.00", 20 + i % 80);
+        corpus.push_back(line);
+    }
+}
+
+// CMD_FAULT_RECORD verisi: [indeks(2), kayıt metni]
+static size_t recordPayload(size_t index, uint8_t* out) {
+    const std::string& text = corpus[index];
+    out[0] = (uint8_t)(index >> 8);
+    out[1] = (uint8_t)(index & 0xFF);
+    memcpy(out + 2, text.data(), text.size());
+    return text.size() + 2;
+}
+
+static PayloadSet textPayloads() {
+    PayloadSet payloads;
+    uint8_t payload[MAX_FRAME_SIZE];
+    for (size_t i = 0; i < corpus.size(); i++) {
+        size_t length = recordPayload(i, payload);
+        payloads.push_back(std::vector<uint8_t>(payload, payload + length));
+    }
+    return payloads;
+}
+
+// Aynı kayıtlar ikili biçimde (fault_record.h): [indeks(2), ikili kayıt]. Ayrıştırılamayan satır atlanır.
+static PayloadSet binaryPayloads() {
+    PayloadSet payloads;
+    uint8_t payload[2 + FAULT_RECORD_BINARY_HEADER + 4 * FAULT_RECORD_MAX_VALUES];
+    for (size_t i = 0; i < corpus.size(); i++) {
+        FaultRecord record;
+        if (!parseFaultRecordText(corpus[i].data(), corpus[i].size(), record)) continue;
+        payload[0] = (uint8_t)(i >> 8);
+        payload[1] = (uint8_t)(i & 0xFF);
+        size_t length = faultRecordToBinary(record, payload + 2, sizeof(payload) - 2);
+        payloads.push_back(std::vector<uint8_t>(payload, payload + 2 + length));
+    }
+    return payloads;
+}
+
+static size_t encodeRecordFrame(FrameEncoding encoding, const std::vector<uint8_t>& payload, int sequence,
+                                uint8_t* out, size_t capacity) {
+    return (encoding == FRAMING_COBS)
+        ? encodeCOBSFrame(CMD_FAULT_RECORD, payload.data(), payload.size(), out, capacity, CHECKSUM_CRC8, sequence)
+        : encodeFrame(CMD_FAULT_RECORD, payload.data(), payload.size(), out, capacity, CHECKSUM_CRC8, sequence);
+}
+
+// Tüm kayıtları dsPIC'in toplu yanıtı gibi arka arkaya frame'ler
+static std::vector<uint8_t> encodePayloads(const PayloadSet& payloads, FrameEncoding encoding) {
+    std::vector<uint8_t> stream;
+    uint8_t encoded[MAX_ENCODED_FRAME_SIZE];
+    for (size_t i = 0; i < payloads.size(); i++) {
+        size_t size = encodeRecordFrame(encoding, payloads[i], i & 0xFF, encoded, sizeof(encoded));
+        stream.insert(stream.end(), encoded, encoded + size);
+    }
+    return stream;
+}
+
+// body'yi en az BENCH_MIN_RUN_MS boyunca tekrarlar, çağrı başına ns döndürür
+template <typename Body>
+static double measureNs(Body body) {
+    body();                             // Isınma
+    unsigned long runs = 0;
+    double elapsed;
+    Clock::time_point start = Clock::now();
+    do {
+        body();
+        runs++;
+        elapsed = elapsedMs(start, Clock::now());
+    } while (elapsed < BENCH_MIN_RUN_MS);
+    return elapsed * 1e6 / runs;
+}
+
+static bool countDecodedFrame(const UARTFrame& frame, void* /* context */) {
+    decodedFrames++;
+    benchSink = benchSink + frame.checksum;
+    return true;
+}
+
+// UART task'ı halkadan bitişik parçaları push() ile verir; parça boyu byte byte okumadan
+// (1) tam halka okumasına (1024) kadar denenir.
+static bool benchDecoder(const char* label, FrameEncoding encoding, const PayloadSet& payloads) {
+    static const size_t chunkSizes[] = { 1, 64, 1024 };
+    std::vector<uint8_t> stream = encodePayloads(payloads, encoding);
+    FrameDecoder bench(countDecodedFrame, NULL);
+    bench.setChecksumMode(CHECKSUM_CRC8);
+    bench.setSequenced(true);
+    bench.setFraming(encoding);
+
+    for (size_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); c++) {
+        size_t chunk = chunkSizes[c];
+        decodedFrames = 0;
+        double ns = measureNs([&]() {
+            for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+                bench.push(&stream[offset], std::min(chunk, stream.size() - offset));
+            }
+        });
+        if (decodedFrames % payloads.size() != 0 || bench.checksumErrors() || bench.framingErrors()) {
+            printf("%s: çözücü %lu frame verdi, %u checksum, %u çerçeve hatası\n", label, decodedFrames,
+                   bench.checksumErrors(), bench.framingErrors());
+            return false;
+        }
+        double bytesPerS = stream.size() * 1e9 / ns;
+        printf("%-8s %4zu byte parça : %7.1f MB/s  %6.2f Mframe/s  (115200 baud hattın %.0f katı)\n",
+               label, chunk, bytesPerS / 1e6, payloads.size() * 1e3 / ns, bytesPerS / LINE_BYTES_PER_S);
+    }
+    return true;
+}
+
+static bool runDecodeBench() {
+    printf("FrameDecoder, CRC-8 + sıra no, %zu kayıt\n", corpus.size());
+    return benchDecoder("STX-ETX", FRAMING_STX_ETX, textPayloads());
+}
+
+// Arduino HardwareSerial karşılığı: write(uint8_t) sanal, her byte ayrı çağrı.
+// Byte'lar sürücünün TX halkası gibi 2 KB'lık bir halkaya yazılır.
+class SerialSink {
+public:
+    SerialSink() : head(0) {}
+    virtual ~SerialSink() {}
+
+    virtual size_t write(uint8_t value) {
+        ring[head++ & (sizeof(ring) - 1)] = value;
+        return 1;
+    }
+
+    virtual size_t write(const uint8_t* data, size_t length) {
+        size_t offset = head & (sizeof(ring) - 1);
+        size_t first = std::min(length, sizeof(ring) - offset);
+        memcpy(ring + offset, data, first);
+        memcpy(ring, data + first, length - first);
+        head += length;
+        return length;
+    }
+
+    uint32_t head;
+    uint8_t ring[2048];
+};
+
+static SerialSink serialSink;
+static SerialSink* volatile txPort = &serialSink;  // Sanal çağrının satır içine alınmasını önler
+
+static inline bool needsEscape(uint8_t value) {
+    return value == FRAME_START_CHAR || value == FRAME_END_CHAR || value == FRAME_ESCAPE_CHAR;
+}
+
+// Eski yol: createFrame() kopyası + checksumData gölge tamponu, ardından sendFrame()'in
+// alan alan escape kontrolü ve byte başına Serial2.write()
+static void legacySendFrame(uint8_t command, const uint8_t* data, uint16_t length) {
+    static UARTFrame frame;
+    uint8_t checksumData[MAX_FRAME_SIZE + 3];
+    frame.command = command;
+    frame.dataLength = length;
+    memcpy(frame.data, data, length);
+    checksumData[0] = command;
+    checksumData[1] = (length >> 8) & 0xFF;
+    checksumData[2] = length & 0xFF;
+    memcpy(checksumData + 3, data, length);
+    frame.checksum = calculateXORChecksum(checksumData, length + 3);
+
+    SerialSink* port = txPort;
+    uint8_t header[3] = { frame.command, (uint8_t)(length >> 8), (uint8_t)(length & 0xFF) };
+    port->write(FRAME_START_CHAR);
+    for (int i = 0; i < 3; i++) {
+        if (needsEscape(header[i])) port->write(FRAME_ESCAPE_CHAR);
+        port->write(header[i]);
+    }
+    for (uint16_t i = 0; i < frame.dataLength; i++) {
+        if (needsEscape(frame.data[i])) port->write(FRAME_ESCAPE_CHAR);
+        port->write(frame.data[i]);
+    }
+    if (needsEscape(frame.checksum)) port->write(FRAME_ESCAPE_CHAR);
+    port->write(frame.checksum);
+    port->write(FRAME_END_CHAR);
+}
+
+// Yeni yol: encodeFrame() tek tampona yazar, sürücüye tek write()
+static size_t singleWriteFrame(uint8_t command, const uint8_t* data, uint16_t length) {
+    static uint8_t encoded[MAX_ENCODED_FRAME_SIZE];
+    size_t size = encodeFrame(command, data, length, encoded, sizeof(encoded), CHECKSUM_XOR);
+    txPort->write(encoded, size);
+    return size;
+}
+
+static void benchEncoderSet(const char* label, const PayloadSet& payloads) {
+    size_t frameBytes = 0;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        frameBytes += singleWriteFrame(CMD_FAULT_RECORD, payloads[i].data(), payloads[i].size());
+    }
+
+    double legacyNs = measureNs([&]() {
+        for (size_t i = 0; i < payloads.size(); i++) {
+            legacySendFrame(CMD_FAULT_RECORD, payloads[i].data(), payloads[i].size());
+        }
+    }) / payloads.size();
+    double singleNs = measureNs([&]() {
+        for (size_t i = 0; i < payloads.size(); i++) {
+            singleWriteFrame(CMD_FAULT_RECORD, payloads[i].data(), payloads[i].size());
+        }
+    }) / payloads.size();
+
+    printf("%-14s (ort %4.0f byte frame): byte byte %6.0f ns  tek write %6.0f ns  (%.1fx)\n", label,
+           (double)frameBytes / payloads.size(), legacyNs, singleNs, legacyNs / singleNs);
+}
+
+static bool runEncodeBench() {
+    PayloadSet records = textPayloads();
+
+    // Kayıt metinleri birleştirilerek tam MAX_FRAME_SIZE'lık frame'ler
+    PayloadSet fullFrames;
+    std::vector<uint8_t> current;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        for (size_t j = 0; j < corpus[i].size(); j++) {
+            current.push_back((uint8_t)corpus[i][j]);
+            if (current.size() == MAX_FRAME_SIZE) {
+                fullFrames.push_back(current);
+                current.clear();
+            }
+        }
+    }
+
+    printf("Frame kodlama, CPU süresi (host)\n");
+    benchEncoderSet("Kayıt frame'i", records);
+    if (!fullFrames.empty()) {
+        benchEncoderSet("512 byte veri", fullFrames);
+    }
+
+    // Eski yol Serial2.flush() ile son bit hattan çıkana kadar bekliyordu; yeni yolda
+    // write() frame'i UART_DRIVER_TX_BUFFER'a (2 KB) kopyalayıp hemen döner.
+    static const uint8_t fill[MAX_FRAME_SIZE] = { 0 };
+    size_t largest = singleWriteFrame(CMD_FAULT_RECORD, fill, sizeof(fill));
+    printf("\nÇağıranın bloklandığı süre, %zu byte frame (flush ile):\n", largest);
+    static const long bauds[] = { 9600, 115200 };
+    for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+        printf("  %6ld baud : %6.1f ms  (tek write + TX halkası: ~0 ms)\n", bauds[b], largest * 10000.0 / bauds[b]);
+    }
+    return true;
+}
+
+// Tablodan önceki calculateCRC8(): byte başına 8 kaydırma/XOR adımı
+static uint8_t bitwiseCRC8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0x00;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+typedef uint8_t (*ChecksumFunction)(const uint8_t* data, size_t length);
+
+// Hatalı kaydın fark edilmeme oranı: komşu byte takası ve aynı bit konumunda çift bit hatası
+static void countMissed(ChecksumFunction checksum, unsigned long& swapMissed, unsigned long& doubleMissed,
+                        unsigned long& trials) {
+    uint32_t seed = 7;
+    uint8_t payload[MAX_FRAME_SIZE];
+    swapMissed = doubleMissed = trials = 0;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        size_t length = recordPayload(i, payload);
+        uint8_t good = checksum(payload, length);
+        for (int t = 0; t < 16; t++) {
+            seed = seed * 1103515245U + 12345U;
+            size_t a = (seed >> 8) % (length - 1);
+            if (payload[a] == payload[a + 1]) continue;
+            trials++;
+
+            std::swap(payload[a], payload[a + 1]);
+            if (checksum(payload, length) == good) swapMissed++;
+            std::swap(payload[a], payload[a + 1]);
+
+            seed = seed * 1103515245U + 12345U;
+            size_t b = (a + 1 + (seed >> 8) % (length - 1)) % length;
+            uint8_t bit = (uint8_t)(1 << ((seed >> 20) & 7));
+            payload[a] ^= bit;
+            payload[b] ^= bit;
+            if (checksum(payload, length) == good) doubleMissed++;
+            payload[a] ^= bit;
+            payload[b] ^= bit;
+        }
+    }
+}
+
+static bool runChecksumBench() {
+    // Kayıt metinleri birleştirilerek 1 KB'lık blok
+    uint8_t block[1024];
+    size_t filled = 0;
+    for (size_t i = 0; filled < sizeof(block); i = (i + 1) % corpus.size()) {
+        size_t take = std::min(corpus[i].size(), sizeof(block) - filled);
+        memcpy(block + filled, corpus[i].data(), take);
+        filled += take;
+    }
+    if (bitwiseCRC8(block, sizeof(block)) != calculateCRC8(block, sizeof(block))) {
+        printf("Tablo CRC-8 bit bit CRC-8 ile aynı sonucu vermiyor\n");
+        return false;
+    }
+
+    struct Candidate {
+        const char* name;
+        ChecksumFunction function;
+    };
+    static const Candidate candidates[] = {
+        { "CRC-8 bit bit", bitwiseCRC8 },
+        { "CRC-8 tablo", calculateCRC8 },
+        { "XOR", calculateXORChecksum }
+    };
+
+    printf("Checksum, 1 KB kayıt metni başına (host)\n");
+    for (size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); c++) {
+        ChecksumFunction function = candidates[c].function;
+        double ns = measureNs([&]() { benchSink = benchSink + function(block, sizeof(block)); });
+
+        unsigned long swapMissed, doubleMissed, trials;
+        countMissed(function, swapMissed, doubleMissed, trials);
+        printf("  %-14s : %7.0f ns/KB   kaçırılan: byte takası %lu/%lu, çift bit %lu/%lu\n",
+               candidates[c].name, ns, swapMissed, trials, doubleMissed, trials);
+    }
+    return true;
+}
+
+// Frame ek yükü: hat byte'ları - veri byte'ları (başlık, sıra no, checksum, ayraç ve kaçışlar dahil)
+static void reportOverhead(const char* label, const PayloadSet& payloads) {
+    uint8_t encoded[MAX_ENCODED_FRAME_SIZE];
+    static const FrameEncoding encodings[] = { FRAMING_STX_ETX, FRAMING_COBS };
+    size_t dataBytes = 0;
+    for (size_t i = 0; i < payloads.size(); i++) dataBytes += payloads[i].size();
+
+    printf("%s: %zu frame, ort %.1f byte veri\n", label, payloads.size(), (double)dataBytes / payloads.size());
+    for (int e = 0; e < 2; e++) {
+        size_t wire = 0, worst = 0;
+        for (size_t i = 0; i < payloads.size(); i++) {
+            size_t size = encodeRecordFrame(encodings[e], payloads[i], i & 0xFF, encoded, sizeof(encoded));
+            wire += size;
+            worst = std::max(worst, size - payloads[i].size());
+        }
+        printf("  %-8s : ort %5.2f byte/frame ek yük (%%%4.1f), en kötü %zu, 115200 baud'da %.0f kayıt/s\n",
+               encodings[e] == FRAMING_COBS ? "COBS" : "STX-ETX", (double)(wire - dataBytes) / payloads.size(),
+               100.0 * (wire - dataBytes) / dataBytes, worst, LINE_BYTES_PER_S * payloads.size() / wire);
+    }
+}
+
+static bool runCOBSBench() {
+    PayloadSet text = textPayloads();
+    PayloadSet binary = binaryPayloads();
+
+    // Üst sınır: tamamı kaçış gerektiren byte'lardan oluşan 512 byte veri
+    PayloadSet worstCase(1, std::vector<uint8_t>(MAX_FRAME_SIZE));
+    for (size_t i = 0; i < MAX_FRAME_SIZE; i++) {
+        worstCase[0][i] = (i % 3 == 0) ? FRAME_START_CHAR : (i % 3 == 1) ? FRAME_END_CHAR : FRAME_ESCAPE_CHAR;
+    }
+
+    printf("Frame ek yükü, CRC-8 + sıra no\n");
+    reportOverhead("Metin kayıt", text);
+    if (!binary.empty()) {
+        reportOverhead("İkili kayıt", binary);
+    }
+    reportOverhead("0x02/0x03/0x1B dolu 512 byte", worstCase);
+
+    printf("\nFrameDecoder, metin kayıtlar\n");
+    if (!benchDecoder("STX-ETX", FRAMING_STX_ETX, text) || !benchDecoder("COBS", FRAMING_COBS, text)) {
+        return false;
+    }
+    if (!binary.empty()) {
+        printf("\nFrameDecoder, ikili kayıtlar\n");
+        return benchDecoder("STX-ETX", FRAMING_STX_ETX, binary) && benchDecoder("COBS", FRAMING_COBS, binary);
+    }
+    return true;
+}
+
+// tools/dspic_sim.py lzss_compress() ile aynı açgözlü kodlayıcı (uart_lzss.h bit akışı)
+static std::vector<uint8_t> lzssCompress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    uint32_t accumulator = 0;
+    int bits = 0;
+    auto put = [&](uint16_t value, int count) {
+        for (int i = count - 1; i >= 0; i--) {
+            accumulator = (accumulator << 1) | ((value >> i) & 1);
+            if (++bits == 8) {
+                out.push_back((uint8_t)accumulator);
+                accumulator = 0;
+                bits = 0;
+            }
+        }
+    };
+
+    const size_t maxLength = 1 << LZSS_LOOKAHEAD_BITS;
+    size_t i = 0;
+    while (i < data.size()) {
+        size_t bestLength = 0, bestOffset = 0;
+        for (size_t offset = 1; offset <= std::min<size_t>(LZSS_WINDOW_SIZE, i); offset++) {
+            size_t length = 0;
+            while (length < maxLength && i + length < data.size() && data[i + length] == data[i - offset + length]) {
+                length++;
+            }
+            if (length > bestLength) {
+                bestLength = length;
+                bestOffset = offset;
+                if (length == maxLength) break;
+            }
+        }
+        if (bestLength >= 2) {
+            put(0, 1);
+            put(bestOffset - 1, LZSS_WINDOW_BITS);
+            put(bestLength - 1, LZSS_LOOKAHEAD_BITS);
+            i += bestLength;
+        } else {
+            put(1, 1);
+            put(data[i], 8);
+            i++;
+        }
+    }
+    if (bits) {
+        out.push_back((uint8_t)(accumulator << (8 - bits)));
+    }
+    return out;
+}
+
+struct ReplySize {
+    size_t inner;                   // Açılmış akış: N x [cmd, lenH, lenL, veri]
+    size_t packed;                  // LZSS çıktısı
+    size_t plainWire;               // N x CMD_FAULT_RECORD frame'i
+    size_t compressedWire;          // CMD_LZSS_BLOCK frame'leri
+};
+
+static unsigned long innerRecords;
+static size_t innerBytes;
+
+static bool countInnerRecord(const UARTFrame& frame, void* /* context */) {
+    innerRecords++;
+    innerBytes += frame.dataLength;
+    return true;
+}
+
+// Bir toplu yanıtı iki şekilde kodlar ve sıkıştırılmış akışı çözücüden geri geçirir.
+// CMD_FAULT_RANGE_END her iki yolda da aynı olduğundan sayılmaz.
+static bool measureReply(const PayloadSet& payloads, size_t start, size_t count, ReplySize& size) {
+    uint8_t encoded[MAX_ENCODED_FRAME_SIZE];
+    std::vector<uint8_t> inner;
+    size_t dataBytes = 0;
+    size.plainWire = 0;
+    for (size_t i = start; i < start + count; i++) {
+        const std::vector<uint8_t>& payload = payloads[i];
+        inner.push_back(CMD_FAULT_RECORD);
+        inner.push_back((uint8_t)(payload.size() >> 8));
+        inner.push_back((uint8_t)(payload.size() & 0xFF));
+        inner.insert(inner.end(), payload.begin(), payload.end());
+        dataBytes += payload.size();
+        size.plainWire += encodeRecordFrame(FRAMING_STX_ETX, payload, 0, encoded, sizeof(encoded));
+    }
+
+    std::vector<uint8_t> packed = lzssCompress(inner);
+    size.inner = inner.size();
+    size.packed = packed.size();
+    size.compressedWire = 0;
+
+    innerRecords = 0;
+    innerBytes = 0;
+    CompressedFrameReader reader(countInnerRecord, NULL);
+    uint8_t block[MAX_FRAME_SIZE];
+    const size_t chunk = MAX_FRAME_SIZE - 1;
+    for (size_t offset = 0; offset < packed.size(); offset += chunk) {
+        size_t take = std::min(chunk, packed.size() - offset);
+        block[0] = (offset + take >= packed.size()) ? LZSS_BLOCK_LAST : 0;
+        memcpy(block + 1, &packed[offset], take);
+        size.compressedWire += encodeFrame(CMD_LZSS_BLOCK, block, take + 1, encoded, sizeof(encoded),
+                                           CHECKSUM_CRC8, 0);
+        reader.pushBlock(block, take + 1);
+    }
+    return !reader.failed() && innerRecords == count && innerBytes == dataBytes;
+}
+
+static bool runLZSSBench() {
+    PayloadSet payloads = textPayloads();
+    // Tek kayıt (GET_FIRST/NEXT_FAULT), arıza işi (FAULT_RANGE_JOB_RECORDS) ve kayıt deposu senkronu
+    static const size_t groupSizes[] = { 1, 16, 50, 100 };
+
+    printf("LZSS (pencere %d bit, ileri bakış %d bit), STX-ETX + CRC-8 frame'leri\n",
+           LZSS_WINDOW_BITS, LZSS_LOOKAHEAD_BITS);
+    printf("  Yanıt     oran    hat byte/kayıt     büyüyen    %zu kayıt, 9600 baud   115200 baud\n",
+           payloads.size());
+    printf("            LZSS    düz     sıkışık    yanıt      düz     sıkışık      düz    sıkışık\n");
+
+    for (size_t g = 0; g < sizeof(groupSizes) / sizeof(groupSizes[0]); g++) {
+        size_t group = groupSizes[g];
+        size_t inner = 0, packed = 0, plainWire = 0, compressedWire = 0, grown = 0, replies = 0;
+        for (size_t start = 0; start < payloads.size(); start += group) {
+            ReplySize size;
+            size_t count = std::min(group, payloads.size() - start);
+            if (!measureReply(payloads, start, count, size)) {
+                printf("LZSS tur testi başarısız: kayıt %zu-%zu\n", start, start + count - 1);
+                return false;
+            }
+            inner += size.inner;
+            packed += size.packed;
+            plainWire += size.plainWire;
+            compressedWire += size.compressedWire;
+            grown += (size.compressedWire >= size.plainWire) ? 1 : 0;
+            replies++;
+        }
+        printf("  %3zu kayıt  %%%3.0f  %6.1f  %8.1f   %4zu/%-4zu  %5.1f s  %6.1f s   %5.2f s  %5.2f s\n",
+               group, 100.0 * packed / inner, (double)plainWire / payloads.size(),
+               (double)compressedWire / payloads.size(), grown, replies,
+               plainWire * 10.0 / 9600, compressedWire * 10.0 / 9600,
+               plainWire * 10.0 / 115200, compressedWire * 10.0 / 115200);
+    }
+
+    // ESP32 tarafı: çözücü hızı (hattın kaç katı)
+    std::vector<uint8_t> inner;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        inner.push_back(CMD_FAULT_RECORD);
+        inner.push_back((uint8_t)(payloads[i].size() >> 8));
+        inner.push_back((uint8_t)(payloads[i].size() & 0xFF));
+        inner.insert(inner.end(), payloads[i].begin(), payloads[i].end());
+    }
+    std::vector<uint8_t> packed = lzssCompress(inner);
+    double ns = measureNs([&]() {
+        LZSSDecoder decoder;
+        decoder.push(packed.data(), packed.size(), [](const uint8_t* data, size_t length, void*) {
+            benchSink = benchSink + data[length - 1];
+        }, NULL);
+    });
+    printf("\nLZSSDecoder: %.1f MB/s sıkışık girdi, %.1f MB/s çıktı (host)\n",
+           packed.size() * 1e3 / ns, inner.size() * 1e3 / ns);
+    return true;
+}
+
+static bool isOfflineMode(const std::string& mode) {
+    return mode == "decode" || mode == "encode" || mode == "crc" || mode == "cobs" || mode == "lzss";
+}
+
+static int runOffline(const Options& options) {
+    if (options.input != NULL) {
+        if (!loadCorpus(options.input)) {
+            fprintf(stderr, "%s: kayıt yok\n", options.input);
+            return 1;
+        }
+    } else {
+        generateCorpus(options.count);
+    }
+
+    size_t textBytes = 0;
+    for (size_t i = 0; i < corpus.size(); i++) textBytes += corpus[i].size();
+    printf("Kayıt kümesi : %zu kayıt, ort %.1f byte (%s)\n\n", corpus.size(),
+           (double)textBytes / corpus.size(), options.input ? options.input : "üretildi");
+
+    bool ok = false;
+    if (options.mode == "decode") ok = runDecodeBench();
+    else if (options.mode == "encode") ok = runEncodeBench();
+    else if (options.mode == "crc") ok = runChecksumBench();
+    else if (options.mode == "cobs") ok = runCOBSBench();
+    else if (options.mode == "lzss") ok = runLZSSBench();
+    return ok ? 0 : 1;
+}
+
+// ==================== RAPOR ====================
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+static void report(const Options& options, double totalMs) {
+    printf("\n=== %s: %lu tamamlandı, %lu başarısız, %.0f ms ===\n",
+           options.mode.c_str(), results.completed, results.failed, totalMs);
+    printf("İşlem/s      : %.1f\n", totalMs > 0 ? results.completed * 1000.0 / totalMs : 0);
+    printf("Gecikme (ms) : p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n",
+           percentile(results.latencies, 50), percentile(results.latencies, 95),
+           percentile(results.latencies, 99), percentile(results.latencies, 100));
+    printf("Hatalar      : %lu timeout, %lu NACK, %lu yeniden gönderim, %lu eski yanıt, "
+           "%u checksum, %u çerçeve\n",
+           results.timeouts, results.nacks, results.retransmits, results.stale,
+           decoder.checksumErrors(), decoder.framingErrors());
+
+    if (!results.recoveries.empty()) {
+        double total = 0;
+        for (size_t i = 0; i < results.recoveries.size(); i++) total += results.recoveries[i];
+        printf("Toparlanma   : %zu olay, ort %.1f ms, p95 %.1f ms, max %.1f ms\n",
+               results.recoveries.size(), total / results.recoveries.size(),
+               percentile(results.recoveries, 95), percentile(results.recoveries, 100));
+    }
+    if (options.mode == "range") {
+        printf("Kayıt        : %lu (%.0f kayıt/s)\n", results.records,
+               totalMs > 0 ? results.records * 1000.0 / totalMs : 0);
+    }
+    if (lzssReader.bytesIn() > 0) {
+        printf("LZSS         : %u -> %u byte (%%%.0f)\n", lzssReader.bytesIn(), lzssReader.bytesOut(),
+               100.0 * lzssReader.bytesIn() / lzssReader.bytesOut());
+    }
+    printf("Hat          : %u byte alındı (%.1f kB/s)\n", wireBytes,
+           totalMs > 0 ? wireBytes / totalMs : 0);
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Kullanım: %s <port> [--mode ping|fault|range|text] [--count N] [--window W]\n"
+            "          [--timeout ms] [--range N] [--caps 0xNN]\n"
+            "          %s --mode decode|encode|crc|cobs|lzss [--input dosya] [--count N]\n", name, name);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    Options options = { NULL, "ping", 1000, 4, 250, 100, 0x7F, NULL };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--mode" && hasValue) options.mode = argv[++i];
+        else if (arg == "--count" && hasValue) options.count = atoi(argv[++i]);
+        else if (arg == "--window" && hasValue) options.window = atoi(argv[++i]);
+        else if (arg == "--timeout" && hasValue) options.timeoutMs = atoi(argv[++i]);
+        else if (arg == "--range" && hasValue) options.rangeCount = atoi(argv[++i]);
+        else if (arg == "--caps" && hasValue) options.caps = (int)strtol(argv[++i], NULL, 0);
+        else if (arg == "--input" && hasValue) options.input = argv[++i];
+        else if (arg[0] != '-' && options.port == NULL) options.port = argv[i];
+        else usage(argv[0]);
+    }
+    if (options.count <= 0) usage(argv[0]);
+    if (isOfflineMode(options.mode)) {
+        return runOffline(options);
+    }
+    if (options.port == NULL) usage(argv[0]);
+    options.window = std::max(1, std::min(options.window, BENCH_MAX_WINDOW));
+
+    if (!openPort(options.port)) {
+        return 1;
+    }
+    decoder.setHandler(collectFrame, NULL);
+
+    Clock::time_point start = Clock::now();
+    if (options.mode == "text") {
+        runText(options);
+    } else {
+        negotiate(options);
+        start = Clock::now();
+        wireBytes = 0;
+        if (options.mode == "ping") runPipelined(options, CMD_PING);
+        else if (options.mode == "fault") runPipelined(options, CMD_GET_FIRST_FAULT);
+        else if (options.mode == "range") runRange(options);
+        else usage(argv[0]);
+    }
+
+    report(options, elapsedMs(start, Clock::now()));
+    close(portFd);
+    return results.failed > 0 ? 1 : 0;
+}